@@ -1,136 +1,307 @@
-#define _POSIX_C_SOURCE 199309L
-#include <stdio.h>
-#include <stdlib.h>
-#include <omp.h>
-#include <time.h>
-
-// Estructura para representar una matriz
-typedef struct {
-    size_t tamano;         // Tamao de la matriz (NxN)
-    int* datos;            // Datos de la matriz en un arreglo unidimensional
-} Matriz;
-
-// Funcin para crear una matriz NxN
-Matriz* crear_matriz(size_t tamano, int aleatoria) {
-    Matriz* matriz = (Matriz*) malloc(sizeof(Matriz));
-    matriz->datos = (int*) malloc(sizeof(int) * tamano * tamano);
-    matriz->tamano = tamano;
-
-    // Llenar con valores aleatorios si se indica
-    if (aleatoria) {
-        for (size_t i = 0; i < tamano * tamano; i++) {
-            matriz->datos[i] = rand() % 100;
-        }
-    }
-    return matriz;
-}
-
-// Funcin para imprimir una matriz
-void imprimir_matriz(Matriz* matriz) {
-    for (size_t i = 0; i < matriz->tamano; i++) {
-        for (size_t j = 0; j < matriz->tamano; j++) {
-            printf("%d ", matriz->datos[i * matriz->tamano + j]);
-        }
-        printf("\n");
-    }
-}
-
-// Funcin para transponer una matriz
-Matriz* transponer_matriz(Matriz* matriz) {
-    size_t tamano = matriz->tamano;
-    Matriz* transpuesta = crear_matriz(tamano, 0);
-    
-    for (size_t i = 0; i < tamano; i++) {
-        for (size_t j = 0; j < tamano; j++) {
-            transpuesta->datos[j * tamano + i] = matriz->datos[i * tamano + j];
-        }
-    }
-    return transpuesta;
-}
-
-// Funcin para multiplicar matrices utilizando OpenMP y la transpuesta de B
-Matriz* multiplicar_matrices(Matriz* matrizA, Matriz* matrizB_T, int numHilos) {
-    size_t tamano = matrizA->tamano;
-    Matriz* resultado = crear_matriz(tamano, 0);
-
-    // Paralelizacin con OpenMP
-    #pragma omp parallel for num_threads(numHilos)
-    for (size_t i = 0; i < tamano; i++) {
-        for (size_t j = 0; j < tamano; j++) {
-            int suma = 0;
-            for (size_t k = 0; k < tamano; k++) {
-                suma += matrizA->datos[i * tamano + k] * matrizB_T->datos[j * tamano + k];
-            }
-            resultado->datos[i * tamano + j] = suma;
-        }
-    }
-
-    return resultado;
-}
-
-// Funcin para liberar la memoria de una matriz
-void eliminar_matriz(Matriz** matriz) {
-    if (matriz == NULL || *matriz == NULL) return;
-    free((*matriz)->datos);
-    free(*matriz);
-    *matriz = NULL;
-}
-
-int main(int argc, char* argv[]) {
-    // Comprobacin de argumentos
-    if (argc != 4) {
-        printf("Uso: %s <tamano_matriz> <num_hilos> <mostrar_matrices (0 o 1)>\n", argv[0]);
-        return 1;
-    }
-
-    int tamanoMatriz = atoi(argv[1]);
-    int numHilos = atoi(argv[2]);
-    int mostrarMatrices = atoi(argv[3]);
-
-    if (tamanoMatriz <= 0 || numHilos <= 0) {
-        printf("El tamao de la matriz y el nmero de hilos deben ser positivos.\n");
-        return 1;
-    }
-
-    srand(time(NULL));  // Inicializar semilla para nmeros aleatorios
-
-    // Crear matrices A y B con valores aleatorios
-    Matriz* matrizA = crear_matriz(tamanoMatriz, 1);
-    Matriz* matrizB = crear_matriz(tamanoMatriz, 1);
-
-    if (mostrarMatrices) {
-        printf("Matriz A:\n");
-        imprimir_matriz(matrizA);
-        printf("\nMatriz B:\n");
-        imprimir_matriz(matrizB);
-    }
-
-    // Transponer la matriz B para optimizar el acceso en la multiplicacin
-    Matriz* matrizB_T = transponer_matriz(matrizB);
-
-    // Medir el tiempo de ejecucin
-    struct timespec inicio, fin;
-    clock_gettime(CLOCK_MONOTONIC, &inicio);
-
-    Matriz* matrizResultado = multiplicar_matrices(matrizA, matrizB_T, numHilos);
-
-    clock_gettime(CLOCK_MONOTONIC, &fin);
-
-    if (mostrarMatrices) {
-        printf("\nMatriz C (Resultado):\n");
-        imprimir_matriz(matrizResultado);
-    }
-
-    double tiempoEjecucion = (fin.tv_sec - inicio.tv_sec) + 
-                             (fin.tv_nsec - inicio.tv_nsec) / 1e9;
-    printf("\nTiempo de ejecucin: %f segundos\n", tiempoEjecucion);
-
-    // Liberar memoria
-    eliminar_matriz(&matrizA);
-    eliminar_matriz(&matrizB);
-    eliminar_matriz(&matrizB_T);
-    eliminar_matriz(&matrizResultado);
-
-    return 0;
-}
-
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+#include <time.h>
+
+// Estructura para representar una matriz
+typedef struct {
+    size_t tamano;         // Tamaño de la matriz (NxN)
+    int* datos;            // Datos de la matriz en un arreglo unidimensional
+} Matriz;
+
+// Función para crear una matriz NxN
+Matriz* crear_matriz(size_t tamano, int aleatoria) {
+    Matriz* matriz = (Matriz*) malloc(sizeof(Matriz));
+    matriz->datos = (int*) malloc(sizeof(int) * tamano * tamano);
+    matriz->tamano = tamano;
+
+    // Llenar con valores aleatorios si se indica
+    if (aleatoria) {
+        for (size_t i = 0; i < tamano * tamano; i++) {
+            matriz->datos[i] = rand() % 100;
+        }
+    }
+    return matriz;
+}
+
+// Función para imprimir una matriz
+void imprimir_matriz(Matriz* matriz) {
+    for (size_t i = 0; i < matriz->tamano; i++) {
+        for (size_t j = 0; j < matriz->tamano; j++) {
+            printf("%d ", matriz->datos[i * matriz->tamano + j]);
+        }
+        printf("\n");
+    }
+}
+
+// Función para transponer una matriz
+Matriz* transponer_matriz(Matriz* matriz) {
+    size_t tamano = matriz->tamano;
+    Matriz* transpuesta = crear_matriz(tamano, 0);
+    
+    for (size_t i = 0; i < tamano; i++) {
+        for (size_t j = 0; j < tamano; j++) {
+            transpuesta->datos[j * tamano + i] = matriz->datos[i * tamano + j];
+        }
+    }
+    return transpuesta;
+}
+
+// Función para multiplicar matrices utilizando OpenMP y la transpuesta de B
+Matriz* multiplicar_matrices(Matriz* matrizA, Matriz* matrizB_T, int numHilos) {
+    size_t tamano = matrizA->tamano;
+    Matriz* resultado = crear_matriz(tamano, 0);
+
+    // Paralelización con OpenMP
+    #pragma omp parallel for num_threads(numHilos)
+    for (size_t i = 0; i < tamano; i++) {
+        for (size_t j = 0; j < tamano; j++) {
+            int suma = 0;
+            for (size_t k = 0; k < tamano; k++) {
+                suma += matrizA->datos[i * tamano + k] * matrizB_T->datos[j * tamano + k];
+            }
+            resultado->datos[i * tamano + j] = suma;
+        }
+    }
+
+    return resultado;
+}
+
+// Las funciones siguientes se llaman dentro de una región paralela y reparten el trabajo entre
+// los hilos del equipo que ya existe; la barrera implícita de cada omp for separa un paso del
+// siguiente. Las sumas se acumulan en unsigned: las potencias crecen muy rápido y así el
+// desbordamiento es aritmética módulo 2^32 bien definida.
+
+// C = A B con B ya transpuesta
+static void producto_en_equipo(const int* a, const int* bt, int* c, size_t tamano) {
+    #pragma omp for schedule(static)
+    for (size_t i = 0; i < tamano; i++) {
+        for (size_t j = 0; j < tamano; j++) {
+            unsigned suma = 0;
+            for (size_t k = 0; k < tamano; k++) {
+                suma += (unsigned)a[i * tamano + k] * (unsigned)bt[j * tamano + k];
+            }
+            c[i * tamano + j] = (int)suma;
+        }
+    }
+}
+
+// mt = transpuesta de m, por bloques para no recorrer columnas enteras
+static void transponer_en_equipo(const int* m, int* mt, size_t tamano) {
+    const size_t bloque = 32;
+    #pragma omp for schedule(static)
+    for (size_t ib = 0; ib < tamano; ib += bloque) {
+        for (size_t jb = 0; jb < tamano; jb += bloque) {
+            for (size_t i = ib; i < ib + bloque && i < tamano; i++) {
+                for (size_t j = jb; j < jb + bloque && j < tamano; j++) {
+                    mt[j * tamano + i] = m[i * tamano + j];
+                }
+            }
+        }
+    }
+}
+
+static void copiar_en_equipo(const int* origen, int* destino, size_t tamano) {
+    #pragma omp for schedule(static)
+    for (size_t i = 0; i < tamano; i++) {
+        memcpy(destino + i * tamano, origen + i * tamano, tamano * sizeof(int));
+    }
+}
+
+// Función para calcular A^k (k >= 0) por cuadrados sucesivos. Se reservan una sola vez cuatro
+// arreglos de N^2: el resultado parcial R, la base P (A, A^2, A^4, ...), su transpuesta PT y un
+// temporal T, que se intercambian por punteros; la memoria no depende de k y no hay reservas
+// dentro del ciclo. En cada bit de k la base se transpone una vez y PT sirve para los dos
+// productos del paso (R = R P y P = P P). Todo ocurre dentro de una sola región paralela, así
+// que el equipo de hilos se crea una vez para todos los productos.
+Matriz* potencia_matriz(Matriz* matrizA, long k, int numHilos) {
+    size_t tamano = matrizA->tamano;
+    size_t bytes = sizeof(int) * tamano * tamano;
+    Matriz* resultado = crear_matriz(tamano, 0);
+    int* r = resultado->datos;
+    int* p = (int*) malloc(bytes);
+    int* pt = (int*) malloc(bytes);
+    int* t = (int*) malloc(bytes);
+
+    if (k == 0) {
+        // A^0 es la identidad
+        memset(r, 0, bytes);
+        for (size_t i = 0; i < tamano; i++)
+            r[i * tamano + i] = 1;
+    }
+
+    #pragma omp parallel num_threads(numHilos)
+    {
+        int hay_resultado = 0;  // Cada hilo lleva su copia; todos recorren los mismos bits
+
+        if (k > 0)
+            copiar_en_equipo(matrizA->datos, p, tamano);
+        for (long e = k; e > 0; e >>= 1) {
+            transponer_en_equipo(p, pt, tamano);
+            if (e & 1) {
+                if (!hay_resultado) {
+                    copiar_en_equipo(p, r, tamano);  // El primer factor se copia sin multiplicar
+                    hay_resultado = 1;
+                } else {
+                    producto_en_equipo(r, pt, t, tamano);
+                    #pragma omp single
+                    {
+                        int* aux = r;
+                        r = t;
+                        t = aux;
+                    }
+                }
+            }
+            if (e > 1) {
+                producto_en_equipo(p, pt, t, tamano);
+                #pragma omp single
+                {
+                    int* aux = p;
+                    p = t;
+                    t = aux;
+                }
+            }
+        }
+    }
+
+    // El resultado pudo quedar en cualquiera de los cuatro arreglos
+    resultado->datos = r;
+    free(p);
+    free(pt);
+    free(t);
+    return resultado;
+}
+
+// Función para liberar la memoria de una matriz
+void eliminar_matriz(Matriz** matriz) {
+    if (matriz == NULL || *matriz == NULL) return;
+    free((*matriz)->datos);
+    free(*matriz);
+    *matriz = NULL;
+}
+
+// Potencia A^k con el motor de potencias y, si se pide, comparación con k - 1 productos
+// encadenados de multiplicar_matrices (una matriz nueva y una transpuesta por producto)
+static int modo_potencia(Matriz* matrizA, long k, int numHilos, int mostrarMatrices, int verificar) {
+    struct timespec inicio, fin;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    Matriz* potencia = potencia_matriz(matrizA, k, numHilos);
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+
+    if (mostrarMatrices) {
+        printf("\nMatriz A^%ld:\n", k);
+        imprimir_matriz(potencia);
+    }
+    printf("\nTiempo de ejecución (A^%ld por cuadrados): %f segundos\n", k,
+           (fin.tv_sec - inicio.tv_sec) + (fin.tv_nsec - inicio.tv_nsec) / 1e9);
+
+    int correcta = 1;
+    if (verificar && k >= 1) {
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+        Matriz* matrizA_T = transponer_matriz(matrizA);
+        Matriz* acumulada = crear_matriz(matrizA->tamano, 0);
+        memcpy(acumulada->datos, matrizA->datos, sizeof(int) * matrizA->tamano * matrizA->tamano);
+        for (long i = 1; i < k; i++) {
+            Matriz* siguiente = multiplicar_matrices(acumulada, matrizA_T, numHilos);
+            eliminar_matriz(&acumulada);
+            acumulada = siguiente;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &fin);
+        correcta = memcmp(acumulada->datos, potencia->datos, sizeof(int) * matrizA->tamano * matrizA->tamano) == 0;
+        printf("Tiempo de ejecución (%ld productos encadenados): %f segundos\n", k - 1,
+               (fin.tv_sec - inicio.tv_sec) + (fin.tv_nsec - inicio.tv_nsec) / 1e9);
+        printf("Verificación: %s\n", correcta ? "correcta" : "INCORRECTA");
+        eliminar_matriz(&matrizA_T);
+        eliminar_matriz(&acumulada);
+    }
+    eliminar_matriz(&potencia);
+    return correcta ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    long potencia = -1;    // Exponente de --potencia (-1 = producto A B de siempre)
+    int verificar = 0;     // Comparar la potencia con productos encadenados
+    char* args[3] = {NULL, NULL, NULL};
+    int nargs = 0;
+
+    // Separación de las opciones (--potencia <k>, --verificar) y los argumentos posicionales
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--potencia") == 0 && i + 1 < argc)
+            potencia = atol(argv[++i]);
+        else if (strcmp(argv[i], "--verificar") == 0)
+            verificar = 1;
+        else if (nargs < 3)
+            args[nargs++] = argv[i];
+    }
+
+    // Comprobación de argumentos
+    if (nargs != 3) {
+        printf("Uso: %s <tamano_matriz> <num_hilos> <mostrar_matrices (0 o 1)> [--potencia k [--verificar]]\n",
+               argv[0]);
+        return 1;
+    }
+
+    int tamanoMatriz = atoi(args[0]);
+    int numHilos = atoi(args[1]);
+    int mostrarMatrices = atoi(args[2]);
+
+    if (tamanoMatriz <= 0 || numHilos <= 0) {
+        printf("El tamaño de la matriz y el número de hilos deben ser positivos.\n");
+        return 1;
+    }
+
+    srand(time(NULL));  // Inicializar semilla para números aleatorios
+
+    if (potencia >= 0) {
+        Matriz* matrizA = crear_matriz(tamanoMatriz, 1);
+        if (mostrarMatrices) {
+            printf("Matriz A:\n");
+            imprimir_matriz(matrizA);
+        }
+        int resultado = modo_potencia(matrizA, potencia, numHilos, mostrarMatrices, verificar);
+        eliminar_matriz(&matrizA);
+        return resultado;
+    }
+
+    // Crear matrices A y B con valores aleatorios
+    Matriz* matrizA = crear_matriz(tamanoMatriz, 1);
+    Matriz* matrizB = crear_matriz(tamanoMatriz, 1);
+
+    if (mostrarMatrices) {
+        printf("Matriz A:\n");
+        imprimir_matriz(matrizA);
+        printf("\nMatriz B:\n");
+        imprimir_matriz(matrizB);
+    }
+
+    // Transponer la matriz B para optimizar el acceso en la multiplicación
+    Matriz* matrizB_T = transponer_matriz(matrizB);
+
+    // Medir el tiempo de ejecución
+    struct timespec inicio, fin;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+
+    Matriz* matrizResultado = multiplicar_matrices(matrizA, matrizB_T, numHilos);
+
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+
+    if (mostrarMatrices) {
+        printf("\nMatriz C (Resultado):\n");
+        imprimir_matriz(matrizResultado);
+    }
+
+    double tiempoEjecucion = (fin.tv_sec - inicio.tv_sec) + 
+                             (fin.tv_nsec - inicio.tv_nsec) / 1e9;
+    printf("\nTiempo de ejecución: %f segundos\n", tiempoEjecucion);
+
+    // Liberar memoria
+    eliminar_matriz(&matrizA);
+    eliminar_matriz(&matrizB);
+    eliminar_matriz(&matrizB_T);
+    eliminar_matriz(&matrizResultado);
+
+    return 0;
+}
+
@@ -0,0 +1,609 @@
+#define _POSIX_C_SOURCE 200112L
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <omp.h>
+#ifdef HPC_MPI
+#include <mpi.h>
+#endif
+#include "hpc.h"
+
+// Backends de la biblioteca. Cada uno es la versión de uno de los programas del repositorio
+// adaptada a la Matriz y la Malla comunes; todos dejan el mismo resultado. Cada trabajador
+// publica su progreso con un Cronometro (telemetria.c), que no hace nada si la telemetría
+// está apagada.
+
+// ---------------------------------------------------------------------------------------------
+// Núcleos comunes
+
+// Filas [desde, hasta) de C = A B, con B ya transpuesta para recorrer ambas por filas
+static void gemm_filas(const Matriz* a, const Matriz* bt, int* c, size_t desde, size_t hasta) {
+    size_t tamano = a->tamano;
+    for (size_t i = desde; i < hasta; i++) {
+        for (size_t j = 0; j < tamano; j++) {
+            int suma = 0;
+            for (size_t k = 0; k < tamano; k++) {
+                suma += a->datos[i * tamano + k] * bt->datos[j * tamano + k];
+            }
+            c[i * tamano + j] = suma;
+        }
+    }
+}
+
+// Primera fila del trabajador p cuando se reparten 'filas' filas entre 'trabajadores'
+// (los primeros reciben una fila más si la división no es exacta)
+static size_t primera_fila(size_t filas, int trabajadores, int p) {
+    size_t base = filas / trabajadores, resto = filas % trabajadores;
+    return p * base + ((size_t)p < resto ? (size_t)p : resto);
+}
+
+// Barrido de Jacobi sobre los puntos [desde, hasta)
+static void barrido(const double* u, double* sal, const double* f, double h2, int desde, int hasta) {
+    for (int i = desde; i < hasta; ++i)
+        sal[i] = (u[i - 1] + u[i + 1] + h2 * f[i]) / 2;
+}
+
+// Filas [desde, hasta) de C publicando cada fila terminada
+static void gemm_filas_publicadas(Cronometro* c, const Matriz* a, const Matriz* bt, int* cm, size_t desde,
+                                  size_t hasta) {
+    if (c->ranura == NULL) {
+        gemm_filas(a, bt, cm, desde, hasta);
+        return;
+    }
+    for (size_t i = desde; i < hasta; i++) {
+        gemm_filas(a, bt, cm, i, i + 1);
+        hpc_cronometro_ocupado(c);
+        hpc_cronometro_bloques(c, i + 1 - desde);
+    }
+}
+
+// Barrido número 'paso' de un trabajador, publicado. Cada HPC_TELEMETRIA_CADA barridos se
+// acumula además el cuadrado del cambio en el tramo; hpc-top suma esas sumas parciales y
+// calcula el residuo, así que no hace falta ninguna reducción entre trabajadores.
+static void barrido_publicado(Cronometro* c, const double* u, double* sal, const double* f, double h2, int desde,
+                              int hasta, int paso) {
+    if (c->ranura && (paso + 1) % HPC_TELEMETRIA_CADA == 0) {
+        double suma = 0.0;
+        for (int i = desde; i < hasta; ++i) {
+            sal[i] = (u[i - 1] + u[i + 1] + h2 * f[i]) / 2;
+            double d = sal[i] - u[i];
+            suma += d * d;
+        }
+        hpc_cronometro_ocupado(c);
+        hpc_cronometro_paso(c, paso + 1, 1, suma);
+    } else {
+        barrido(u, sal, f, h2, desde, hasta);
+        hpc_cronometro_ocupado(c);
+        hpc_cronometro_paso(c, paso + 1, 0, 0.0);
+    }
+}
+
+static int siempre_uno(void) {
+    return 1;
+}
+
+static int todos_los_nucleos(void) {
+    return hpc_nucleos();
+}
+
+// ---------------------------------------------------------------------------------------------
+// Secuencial (matrizSequiencial.c, JacobiSequencial.c)
+
+static void gemm_secuencial(const Matriz* a, const Matriz* b, Matriz* c, int trabajadores) {
+    size_t tamano = a->tamano;
+    Cronometro crono;
+    (void)trabajadores;
+
+    hpc_cronometro_iniciar(&crono, 0);
+    // Algoritmo estándar de multiplicación de matrices
+    for (size_t i = 0; i < tamano; i++) {
+        for (size_t j = 0; j < tamano; j++) {
+            int suma = 0;
+            for (size_t k = 0; k < tamano; k++) {
+                suma += a->datos[i * tamano + k] * b->datos[k * tamano + j];
+            }
+            c->datos[i * tamano + j] = suma;
+        }
+        hpc_cronometro_ocupado(&crono);
+        hpc_cronometro_bloques(&crono, i + 1);
+    }
+    hpc_cronometro_terminar(&crono);
+}
+
+static void jacobi_secuencial(Malla* malla, int pasos, int trabajadores) {
+    int n = malla->n;
+    double h2 = 1.0 / ((double)n * n);
+    double* tmp = (double*)malloc((n + 1) * sizeof(double));
+    double* ent = malla->u;
+    double* sal = tmp;
+    Cronometro crono;
+    (void)trabajadores;
+
+    hpc_cronometro_iniciar(&crono, 0);
+    tmp[0] = malla->u[0];  // Condiciones de frontera
+    tmp[n] = malla->u[n];
+    for (int paso = 0; paso < pasos; ++paso) {
+        barrido_publicado(&crono, ent, sal, malla->f, h2, 1, n, paso);
+        double* aux = ent;
+        ent = sal;
+        sal = aux;
+    }
+    hpc_cronometro_terminar(&crono);
+    if (ent != malla->u)
+        memcpy(malla->u + 1, ent + 1, (n - 1) * sizeof(double));
+    free(tmp);
+}
+
+// ---------------------------------------------------------------------------------------------
+// Transpuesta (transposedMatrixMultiplication.cpp)
+
+static void gemm_transpuesta(const Matriz* a, const Matriz* b, Matriz* c, int trabajadores) {
+    Matriz* bt = transponer_matriz(b);
+    Cronometro crono;
+    (void)trabajadores;
+    hpc_cronometro_iniciar(&crono, 0);
+    gemm_filas_publicadas(&crono, a, bt, c->datos, 0, a->tamano);
+    hpc_cronometro_terminar(&crono);
+    eliminar_matriz(&bt);
+}
+
+// ---------------------------------------------------------------------------------------------
+// Hilos POSIX (matrizHilos.c, JacobiHilos.c)
+
+typedef struct {
+    const Matriz* a;
+    const Matriz* bt;
+    int* c;
+    int id, trabajadores;
+    size_t desde, hasta;  // Filas del hilo
+} TrabajoGemm;
+
+static void* hilo_gemm(void* arg) {
+    TrabajoGemm* t = (TrabajoGemm*)arg;
+    Cronometro crono;
+    hpc_fijar(t->id, t->trabajadores);
+    hpc_cronometro_iniciar(&crono, t->id);
+    gemm_filas_publicadas(&crono, t->a, t->bt, t->c, t->desde, t->hasta);
+    hpc_cronometro_terminar(&crono);
+    return NULL;
+}
+
+static void gemm_hilos(const Matriz* a, const Matriz* b, Matriz* c, int trabajadores) {
+    Matriz* bt = transponer_matriz(b);
+    pthread_t hilos[trabajadores];
+    TrabajoGemm trabajo[trabajadores];
+
+    hpc_topologia();
+    for (int p = 0; p < trabajadores; p++) {
+        trabajo[p].a = a;
+        trabajo[p].bt = bt;
+        trabajo[p].c = c->datos;
+        trabajo[p].id = p;
+        trabajo[p].trabajadores = trabajadores;
+        trabajo[p].desde = primera_fila(a->tamano, trabajadores, p);
+        trabajo[p].hasta = primera_fila(a->tamano, trabajadores, p + 1);
+        pthread_create(&hilos[p], NULL, hilo_gemm, &trabajo[p]);
+    }
+    for (int p = 0; p < trabajadores; p++)
+        pthread_join(hilos[p], NULL);
+    eliminar_matriz(&bt);
+}
+
+// Los backends de Jacobi con varios trabajadores usan arreglos de trabajo propios (u, el
+// temporal y f) que cada trabajador llena en su tramo después de fijarse a su CPU: por la
+// política de primer toque las páginas de cada tramo quedan en el nodo NUMA de su dueño.
+// Quien tiene el primer punto copia también la frontera izquierda y quien tiene el último, la
+// derecha. Al terminar, cada uno devuelve su tramo a la malla.
+static void primer_toque(const Malla* malla, double* u, double* tmp, double* f, int desde, int hasta) {
+    int i0 = (desde == 1) ? 0 : desde;
+    int i1 = (hasta == malla->n) ? hasta + 1 : hasta;
+    for (int i = i0; i < i1; ++i) {
+        u[i] = malla->u[i];
+        tmp[i] = malla->u[i];
+        f[i] = malla->f[i];
+    }
+}
+
+// Estado compartido por los hilos de Jacobi, que se crean una sola vez
+typedef struct {
+    Malla* malla;
+    double* u;
+    double* tmp;
+    double* f;
+    int pasos, trabajadores;
+    pthread_barrier_t barrera;
+} JacobiCompartido;
+
+typedef struct {
+    JacobiCompartido* s;
+    int id;
+    int desde, hasta;     // Puntos del hilo
+} TrabajoJacobi;
+
+static void* hilo_jacobi(void* arg) {
+    TrabajoJacobi* t = (TrabajoJacobi*)arg;
+    JacobiCompartido* s = t->s;
+    int n = s->malla->n;
+    double h2 = 1.0 / ((double)n * n);
+    double* ent = s->u;
+    double* sal = s->tmp;
+    Cronometro crono;
+
+    hpc_fijar(t->id, s->trabajadores);
+    hpc_cronometro_iniciar(&crono, t->id);
+    primer_toque(s->malla, s->u, s->tmp, s->f, t->desde, t->hasta);
+    pthread_barrier_wait(&s->barrera);
+    hpc_cronometro_espera(&crono);
+
+    for (int paso = 0; paso < s->pasos; ++paso) {
+        barrido_publicado(&crono, ent, sal, s->f, h2, t->desde, t->hasta, paso);
+        double* aux = ent;
+        ent = sal;
+        sal = aux;
+        pthread_barrier_wait(&s->barrera);
+        hpc_cronometro_espera(&crono);
+    }
+    hpc_cronometro_terminar(&crono);
+    memcpy(s->malla->u + t->desde, ent + t->desde, (t->hasta - t->desde) * sizeof(double));
+    return NULL;
+}
+
+static void jacobi_hilos(Malla* malla, int pasos, int trabajadores) {
+    int n = malla->n;
+    JacobiCompartido s;
+    pthread_t hilos[trabajadores];
+    TrabajoJacobi trabajo[trabajadores];
+
+    hpc_topologia();
+    s.malla = malla;
+    s.u = (double*)malloc((n + 1) * sizeof(double));
+    s.tmp = (double*)malloc((n + 1) * sizeof(double));
+    s.f = (double*)malloc((n + 1) * sizeof(double));
+    s.pasos = pasos;
+    s.trabajadores = trabajadores;
+    pthread_barrier_init(&s.barrera, NULL, trabajadores);
+
+    for (int p = 0; p < trabajadores; p++) {
+        trabajo[p].s = &s;
+        trabajo[p].id = p;
+        trabajo[p].desde = 1 + (int)primera_fila(n - 1, trabajadores, p);
+        trabajo[p].hasta = 1 + (int)primera_fila(n - 1, trabajadores, p + 1);
+        pthread_create(&hilos[p], NULL, hilo_jacobi, &trabajo[p]);
+    }
+    for (int p = 0; p < trabajadores; p++)
+        pthread_join(hilos[p], NULL);
+    pthread_barrier_destroy(&s.barrera);
+
+    free(s.u);
+    free(s.tmp);
+    free(s.f);
+}
+
+// ---------------------------------------------------------------------------------------------
+// Procesos con memoria compartida (matrizProceso.c, JacobiProcesos.c). Los hijos heredan las
+// entradas con fork; sólo los arreglos que escriben van en una región MAP_SHARED.
+
+static void gemm_procesos(const Matriz* a, const Matriz* b, Matriz* c, int trabajadores) {
+    size_t tamano = a->tamano;
+    size_t bytes = tamano * tamano * sizeof(int);
+    Matriz* bt = transponer_matriz(b);
+    int* resultado = (int*)mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (resultado == MAP_FAILED) {
+        perror("mmap");
+        exit(1);
+    }
+
+    hpc_topologia();
+    for (int p = 0; p < trabajadores; p++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            Cronometro crono;
+            hpc_fijar(p, trabajadores);
+            hpc_cronometro_iniciar(&crono, p);
+            gemm_filas_publicadas(&crono, a, bt, resultado, primera_fila(tamano, trabajadores, p),
+                                  primera_fila(tamano, trabajadores, p + 1));
+            hpc_cronometro_terminar(&crono);
+            _exit(0);
+        }
+        if (pid < 0) {
+            perror("fork");
+            exit(1);
+        }
+    }
+    for (int p = 0; p < trabajadores; p++)
+        wait(NULL);
+
+    memcpy(c->datos, resultado, bytes);
+    munmap(resultado, bytes);
+    eliminar_matriz(&bt);
+}
+
+// Región compartida de Jacobi: barrera entre procesos seguida de u, el temporal y f
+typedef struct {
+    pthread_barrier_t barrera;
+} CabeceraProcesos;
+
+static void trabajador_jacobi(CabeceraProcesos* cab, Malla* malla, double* u, double* tmp, double* f,
+                              int pasos, int id, int trabajadores) {
+    int n = malla->n;
+    double h2 = 1.0 / ((double)n * n);
+    int desde = 1 + (int)primera_fila(n - 1, trabajadores, id);
+    int hasta = 1 + (int)primera_fila(n - 1, trabajadores, id + 1);
+    double* ent = u;
+    double* sal = tmp;
+    Cronometro crono;
+
+    hpc_fijar(id, trabajadores);
+    hpc_cronometro_iniciar(&crono, id);
+    primer_toque(malla, u, tmp, f, desde, hasta);
+    pthread_barrier_wait(&cab->barrera);
+    hpc_cronometro_espera(&crono);
+
+    for (int paso = 0; paso < pasos; ++paso) {
+        barrido_publicado(&crono, ent, sal, f, h2, desde, hasta, paso);
+        double* aux = ent;
+        ent = sal;
+        sal = aux;
+        pthread_barrier_wait(&cab->barrera);
+        hpc_cronometro_espera(&crono);
+    }
+    hpc_cronometro_terminar(&crono);
+    // El resultado se deja en u para que el proceso principal lo copie a la malla
+    if (ent != u)
+        memcpy(u + desde, ent + desde, (hasta - desde) * sizeof(double));
+}
+
+static void jacobi_procesos(Malla* malla, int pasos, int trabajadores) {
+    int n = malla->n;
+    size_t cabecera = (sizeof(CabeceraProcesos) + 63) / 64 * 64;
+    size_t bytes = cabecera + 3 * (size_t)(n + 1) * sizeof(double);
+    char* region = (char*)mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED) {
+        perror("mmap");
+        exit(1);
+    }
+    CabeceraProcesos* cab = (CabeceraProcesos*)region;
+    double* u = (double*)(region + cabecera);
+    double* tmp = u + (n + 1);
+    double* f = tmp + (n + 1);
+    pid_t pids[trabajadores];
+    pthread_barrierattr_t atributos;
+
+    hpc_topologia();
+    pthread_barrierattr_init(&atributos);
+    pthread_barrierattr_setpshared(&atributos, PTHREAD_PROCESS_SHARED);
+    pthread_barrier_init(&cab->barrera, &atributos, trabajadores);
+    pthread_barrierattr_destroy(&atributos);
+
+    // El proceso principal trabaja como trabajador 0
+    for (int p = 1; p < trabajadores; p++) {
+        pids[p] = fork();
+        if (pids[p] == 0) {
+            trabajador_jacobi(cab, malla, u, tmp, f, pasos, p, trabajadores);
+            _exit(0);
+        }
+        if (pids[p] < 0) {
+            perror("fork");
+            exit(1);
+        }
+    }
+    trabajador_jacobi(cab, malla, u, tmp, f, pasos, 0, trabajadores);
+    for (int p = 1; p < trabajadores; p++)
+        waitpid(pids[p], NULL, 0);
+    pthread_barrier_destroy(&cab->barrera);
+    hpc_soltar();
+
+    memcpy(malla->u + 1, u + 1, (n - 1) * sizeof(double));
+    munmap(region, bytes);
+}
+
+// ---------------------------------------------------------------------------------------------
+// OpenMP (MatrixOpenMP.cpp, jacobiOpenMp.cpp). Los hilos del equipo se fijan al entrar en la
+// región paralela y se sueltan antes de salir de ella: los hilos del grupo de OpenMP
+// sobreviven a la región y no deben quedar fijados para las llamadas siguientes.
+
+static void gemm_openmp(const Matriz* a, const Matriz* b, Matriz* c, int trabajadores) {
+    Matriz* bt = transponer_matriz(b);
+    long tamano = (long)a->tamano;
+
+    hpc_topologia();
+    #pragma omp parallel num_threads(trabajadores)
+    {
+        Cronometro crono;
+        uint64_t filas = 0;
+        hpc_fijar(omp_get_thread_num(), omp_get_num_threads());
+        hpc_cronometro_iniciar(&crono, omp_get_thread_num());
+        #pragma omp for
+        for (long i = 0; i < tamano; i++) {
+            gemm_filas(a, bt, c->datos, i, i + 1);
+            hpc_cronometro_ocupado(&crono);
+            hpc_cronometro_bloques(&crono, ++filas);
+        }
+        hpc_cronometro_espera(&crono);  // Barrera implícita del for
+        hpc_cronometro_terminar(&crono);
+        hpc_soltar();
+    }
+    eliminar_matriz(&bt);
+}
+
+static void jacobi_openmp(Malla* malla, int pasos, int trabajadores) {
+    int n = malla->n;
+    double h2 = 1.0 / ((double)n * n);
+    double* u = (double*)malloc((n + 1) * sizeof(double));
+    double* tmp = (double*)malloc((n + 1) * sizeof(double));
+    double* f = (double*)malloc((n + 1) * sizeof(double));
+
+    hpc_topologia();
+    #pragma omp parallel num_threads(trabajadores)
+    {
+        int id = omp_get_thread_num(), equipo = omp_get_num_threads();
+        int desde = 1 + (int)primera_fila(n - 1, equipo, id);
+        int hasta = 1 + (int)primera_fila(n - 1, equipo, id + 1);
+        double* ent = u;
+        double* sal = tmp;
+        Cronometro crono;
+
+        hpc_fijar(id, equipo);
+        hpc_cronometro_iniciar(&crono, id);
+        primer_toque(malla, u, tmp, f, desde, hasta);
+        #pragma omp barrier
+        hpc_cronometro_espera(&crono);
+        for (int paso = 0; paso < pasos; ++paso) {
+            barrido_publicado(&crono, ent, sal, f, h2, desde, hasta, paso);
+            double* aux = ent;
+            ent = sal;
+            sal = aux;
+            #pragma omp barrier
+            hpc_cronometro_espera(&crono);
+        }
+        hpc_cronometro_terminar(&crono);
+        memcpy(malla->u + desde, ent + desde, (hasta - desde) * sizeof(double));
+        hpc_soltar();
+    }
+    free(u);
+    free(tmp);
+    free(f);
+}
+
+// ---------------------------------------------------------------------------------------------
+// MPI (JacobiMPI.c). Todos los procesos tienen la matriz o la malla completa: cada uno calcula
+// su bloque de filas o de puntos y al final se reúne el resultado en todos con MPI_Allgatherv.
+
+#ifdef HPC_MPI
+// Fija cada proceso según su rango dentro del nodo (una sola vez)
+static void fijar_proceso_mpi(void) {
+    static int fijado = 0;
+    MPI_Comm nodo;
+    int rango_local, procesos_locales;
+
+    if (fijado)
+        return;
+    fijado = 1;
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &nodo);
+    MPI_Comm_rank(nodo, &rango_local);
+    MPI_Comm_size(nodo, &procesos_locales);
+    MPI_Comm_free(&nodo);
+    hpc_fijar_proceso(rango_local, procesos_locales);
+}
+
+static int procesos_mpi(void) {
+    int iniciado = 0, num_procesos = 1;
+    MPI_Initialized(&iniciado);
+    if (iniciado)
+        MPI_Comm_size(MPI_COMM_WORLD, &num_procesos);
+    return (iniciado && num_procesos > 1) ? num_procesos : 0;
+}
+
+static void gemm_mpi(const Matriz* a, const Matriz* b, Matriz* c, int trabajadores) {
+    fijar_proceso_mpi();
+    int rango, num_procesos;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rango);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procesos);
+    int cuentas[num_procesos], desplazamientos[num_procesos];
+    size_t tamano = a->tamano;
+    Matriz* bt = transponer_matriz(b);
+    Cronometro crono;
+    (void)trabajadores;
+
+    // Cada proceso tiene su propio segmento de telemetría y publica en su primera ranura
+    hpc_cronometro_iniciar(&crono, 0);
+    for (int p = 0; p < num_procesos; p++) {
+        desplazamientos[p] = (int)(primera_fila(tamano, num_procesos, p) * tamano);
+        cuentas[p] = (int)(primera_fila(tamano, num_procesos, p + 1) * tamano) - desplazamientos[p];
+    }
+    gemm_filas_publicadas(&crono, a, bt, c->datos, primera_fila(tamano, num_procesos, rango),
+                          primera_fila(tamano, num_procesos, rango + 1));
+    MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, c->datos, cuentas, desplazamientos, MPI_INT,
+                   MPI_COMM_WORLD);
+    hpc_cronometro_espera(&crono);
+    hpc_cronometro_terminar(&crono);
+    eliminar_matriz(&bt);
+}
+
+static void jacobi_mpi(Malla* malla, int pasos, int trabajadores) {
+    fijar_proceso_mpi();
+    int rango, num_procesos;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rango);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procesos);
+    int n = malla->n;
+    double h2 = 1.0 / ((double)n * n);
+    int desde = 1 + (int)primera_fila(n - 1, num_procesos, rango);
+    int hasta = 1 + (int)primera_fila(n - 1, num_procesos, rango + 1);
+    int izquierda = (rango > 0) ? rango - 1 : MPI_PROC_NULL;
+    int derecha = (rango < num_procesos - 1) ? rango + 1 : MPI_PROC_NULL;
+    int cuentas[num_procesos], desplazamientos[num_procesos];
+    double* tmp = (double*)malloc((n + 1) * sizeof(double));
+    double* ent = malla->u;
+    double* sal = tmp;
+    Cronometro crono;
+    (void)trabajadores;
+
+    hpc_cronometro_iniciar(&crono, 0);
+    memcpy(tmp, malla->u, (n + 1) * sizeof(double));
+    for (int paso = 0; paso < pasos; ++paso) {
+        // Intercambio de los bordes con los vecinos
+        MPI_Sendrecv(&ent[hasta - 1], 1, MPI_DOUBLE, derecha, 0, &ent[desde - 1], 1, MPI_DOUBLE, izquierda, 0,
+                     MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        MPI_Sendrecv(&ent[desde], 1, MPI_DOUBLE, izquierda, 1, &ent[hasta], 1, MPI_DOUBLE, derecha, 1,
+                     MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        hpc_cronometro_espera(&crono);
+        barrido_publicado(&crono, ent, sal, malla->f, h2, desde, hasta, paso);
+        double* aux = ent;
+        ent = sal;
+        sal = aux;
+    }
+    hpc_cronometro_terminar(&crono);
+
+    for (int p = 0; p < num_procesos; p++) {
+        desplazamientos[p] = 1 + (int)primera_fila(n - 1, num_procesos, p);
+        cuentas[p] = 1 + (int)primera_fila(n - 1, num_procesos, p + 1) - desplazamientos[p];
+    }
+    if (ent != malla->u)
+        memcpy(malla->u + desde, ent + desde, (hasta - desde) * sizeof(double));
+    MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, malla->u, cuentas, desplazamientos, MPI_DOUBLE,
+                   MPI_COMM_WORLD);
+    free(tmp);
+}
+#endif
+
+// ---------------------------------------------------------------------------------------------
+// Registro. Los costos son valores aproximados que hpc_calibrar sustituye por medidas de la
+// máquina; el orden de los campos es {arranque, operacion, sincronizacion}.
+
+static Backend registro[] = {
+    {"secuencial", 0, 1, siempre_uno, gemm_secuencial, jacobi_secuencial,
+     {{0, 2e-9, 0}, {0, 1e-9, 0}}},
+    {"transpuesta", 0, 1, siempre_uno, gemm_transpuesta, NULL,
+     {{0, 1e-9, 0}, {0, 0, 0}}},
+    {"hilos", 0, 0, todos_los_nucleos, gemm_hilos, jacobi_hilos,
+     {{3e-5, 1e-9, 0}, {3e-5, 1e-9, 2e-6}}},
+    {"procesos", 0, 0, todos_los_nucleos, gemm_procesos, jacobi_procesos,
+     {{3e-4, 1e-9, 0}, {3e-4, 1e-9, 3e-6}}},
+    {"openmp", 0, 0, todos_los_nucleos, gemm_openmp, jacobi_openmp,
+     {{5e-6, 1e-9, 0}, {5e-6, 1e-9, 1e-6}}},
+#ifdef HPC_MPI
+    {"mpi", 1, 0, procesos_mpi, gemm_mpi, jacobi_mpi,
+     {{1e-5, 1e-9, 0}, {1e-5, 1e-9, 5e-6}}},
+#endif
+};
+
+int hpc_num_backends(void) {
+    return (int)(sizeof(registro) / sizeof(registro[0]));
+}
+
+Backend* hpc_backend(int i) {
+    return (i >= 0 && i < hpc_num_backends()) ? &registro[i] : NULL;
+}
+
+Backend* hpc_buscar_backend(const char* nombre) {
+    for (int i = 0; i < hpc_num_backends(); i++)
+        if (strcmp(registro[i].nombre, nombre) == 0)
+            return &registro[i];
+    return NULL;
+}
@@ -0,0 +1,292 @@
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef HPC_MPI
+#include <mpi.h>
+#endif
+#include "hpc.h"
+
+// Despachador: elige el backend y el número de trabajadores con menor tiempo predicho por el
+// modelo de costo de hpc.h, y calibra ese modelo midiendo cada backend en esta máquina.
+
+#define CALIBRACION_REPETICIONES 3   // Se toma el mínimo de varias medidas
+#define CALIBRACION_GEMM_CHICA 8      // Tamaños de matriz de la calibración
+#define CALIBRACION_GEMM_GRANDE 192
+#define CALIBRACION_MALLA_CHICA 64    // Intervalos de la malla de la calibración
+#define CALIBRACION_MALLA_GRANDE 65536
+#define CALIBRACION_PASOS 200         // Barridos de Jacobi de la calibración
+
+static const char* nombres_operacion[HPC_NUM_OPERACIONES] = {"gemm", "jacobi"};
+
+static int rango_mpi(void) {
+    int rango = 0;
+#ifdef HPC_MPI
+    int iniciado = 0;
+    MPI_Initialized(&iniciado);
+    if (iniciado)
+        MPI_Comm_rank(MPI_COMM_WORLD, &rango);
+#endif
+    return rango;
+}
+
+// Trabajadores que aprovechan núcleos distintos
+static double efectivos(const Backend* b, int trabajadores) {
+    int nucleos = hpc_nucleos();
+    if (b->distribuido || trabajadores < nucleos)
+        return trabajadores;
+    return nucleos;
+}
+
+static double trabajo(Operacion op, long tamano, long pasos) {
+    if (op == HPC_GEMM)
+        return (double)tamano * tamano * tamano;
+    return (double)(tamano - 1) * pasos;
+}
+
+double hpc_prediccion(const Backend* b, Operacion op, long tamano, long pasos, int trabajadores) {
+    const Coste* c = &b->coste[op];
+    double t = c->arranque * trabajadores + c->operacion * trabajo(op, tamano, pasos) / efectivos(b, trabajadores);
+    if (op == HPC_JACOBI && trabajadores > 1)
+        t += c->sincronizacion * trabajadores * pasos;
+    return t;
+}
+
+// Mejor número de trabajadores para un backend: 1, potencias de dos y el máximo
+static int mejores_trabajadores(const Backend* b, Operacion op, long tamano, long pasos, double* prediccion) {
+    int maximo = b->disponible();
+    int mejor = maximo;
+
+    if (b->distribuido) {
+        *prediccion = hpc_prediccion(b, op, tamano, pasos, maximo);
+        return maximo;
+    }
+    *prediccion = hpc_prediccion(b, op, tamano, pasos, maximo);
+    for (int p = 1; p < maximo; p *= 2) {
+        double t = hpc_prediccion(b, op, tamano, pasos, p);
+        if (t < *prediccion) {
+            *prediccion = t;
+            mejor = p;
+        }
+    }
+    return mejor;
+}
+
+static int implementa(const Backend* b, Operacion op) {
+    return (op == HPC_GEMM) ? b->gemm != NULL : b->jacobi != NULL;
+}
+
+Backend* hpc_elegir(Operacion op, long tamano, long pasos, int* trabajadores) {
+    Backend* elegido = NULL;
+    int pedido = *trabajadores;
+    double mejor = 0.0;
+
+    for (int i = 0; i < hpc_num_backends(); i++) {
+        Backend* b = hpc_backend(i);
+        if (!implementa(b, op) || b->disponible() == 0)
+            continue;
+
+        double t;
+        int p;
+        if (pedido > 0 && !b->distribuido) {
+            // Con un número de trabajadores fijo, los backends secuenciales usan uno
+            p = b->secuencial ? 1 : pedido;
+            t = hpc_prediccion(b, op, tamano, pasos, p);
+        } else {
+            p = mejores_trabajadores(b, op, tamano, pasos, &t);
+        }
+        if (elegido == NULL || t < mejor) {
+            elegido = b;
+            mejor = t;
+            *trabajadores = p;
+        }
+    }
+    return elegido;
+}
+
+// Resuelve el nombre del backend y el número de trabajadores de una llamada
+static Backend* resolver(Operacion op, long tamano, long pasos, const char* nombre, int* trabajadores) {
+    Backend* b;
+    int maximo;
+
+    if (nombre == NULL || strcmp(nombre, "auto") == 0)
+        return hpc_elegir(op, tamano, pasos, trabajadores);
+
+    b = hpc_buscar_backend(nombre);
+    if (b == NULL || !implementa(b, op) || (maximo = b->disponible()) == 0)
+        return NULL;
+    // Un número de trabajadores pedido se respeta aunque supere los núcleos de la máquina
+    if (b->distribuido || b->secuencial) {
+        *trabajadores = maximo;
+    } else if (*trabajadores <= 0) {
+        double t;
+        *trabajadores = mejores_trabajadores(b, op, tamano, pasos, &t);
+    }
+    return b;
+}
+
+const Backend* hpc_gemm(const Matriz* a, const Matriz* b, Matriz* c, const char* backend, int* trabajadores) {
+    Backend* elegido = resolver(HPC_GEMM, (long)a->tamano, 1, backend, trabajadores);
+    if (elegido) {
+        hpc_telemetria_ejecucion("gemm", elegido->nombre, (long)a->tamano, (long)a->tamano,
+                                 elegido->distribuido ? 1 : *trabajadores);
+        elegido->gemm(a, b, c, *trabajadores);
+    }
+    return elegido;
+}
+
+const Backend* hpc_jacobi(Malla* malla, int pasos, const char* backend, int* trabajadores) {
+    Backend* elegido = resolver(HPC_JACOBI, malla->n, pasos, backend, trabajadores);
+    if (elegido) {
+        hpc_telemetria_ejecucion("jacobi", elegido->nombre, malla->n, pasos,
+                                 elegido->distribuido ? 1 : *trabajadores);
+        elegido->jacobi(malla, pasos, *trabajadores);
+    }
+    return elegido;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Calibración
+
+static double medir_gemm(Backend* b, size_t tamano, int trabajadores) {
+    Matriz* a = crear_matriz(tamano, 1);
+    Matriz* bm = crear_matriz(tamano, 1);
+    Matriz* c = crear_matriz(tamano, 0);
+    double mejor = 0.0;
+
+    for (int r = 0; r < CALIBRACION_REPETICIONES; r++) {
+        double inicio = hpc_tiempo();
+        b->gemm(a, bm, c, trabajadores);
+        double t = hpc_tiempo() - inicio;
+        if (r == 0 || t < mejor)
+            mejor = t;
+    }
+    eliminar_matriz(&a);
+    eliminar_matriz(&bm);
+    eliminar_matriz(&c);
+    return mejor;
+}
+
+static double medir_jacobi(Backend* b, int n, int pasos, int trabajadores) {
+    Malla* malla = crear_malla(n);
+    double mejor = 0.0;
+
+    for (int r = 0; r < CALIBRACION_REPETICIONES; r++) {
+        double inicio = hpc_tiempo();
+        b->jacobi(malla, pasos, trabajadores);
+        double t = hpc_tiempo() - inicio;
+        if (r == 0 || t < mejor)
+            mejor = t;
+    }
+    eliminar_malla(&malla);
+    return mejor;
+}
+
+static double no_negativo(double x) {
+    return (x > 0) ? x : 0.0;
+}
+
+// Ajusta el modelo de un backend con dos tamaños (GEMM) o tres medidas (Jacobi), usando dos
+// trabajadores si el backend admite varios para que el arranque y la sincronización aparezcan
+static void calibrar_backend(Backend* b) {
+    int p = b->distribuido ? b->disponible() : (b->secuencial ? 1 : 2);
+    double ef = efectivos(b, p);
+
+    if (b->gemm) {
+        double chica = CALIBRACION_GEMM_CHICA, grande = CALIBRACION_GEMM_GRANDE;
+        double t_chica = medir_gemm(b, CALIBRACION_GEMM_CHICA, p);
+        double t_grande = medir_gemm(b, CALIBRACION_GEMM_GRANDE, p);
+        Coste* c = &b->coste[HPC_GEMM];
+        c->operacion = no_negativo((t_grande - t_chica) * ef / (grande * grande * grande - chica * chica * chica));
+        c->arranque = no_negativo((t_chica - c->operacion * chica * chica * chica / ef) / p);
+        c->sincronizacion = 0.0;
+    }
+    if (b->jacobi) {
+        double chica = CALIBRACION_MALLA_CHICA - 1, grande = CALIBRACION_MALLA_GRANDE - 1;
+        double pasos = CALIBRACION_PASOS;
+        double t_un_paso = medir_jacobi(b, CALIBRACION_MALLA_CHICA, 1, p);
+        double t_chica = medir_jacobi(b, CALIBRACION_MALLA_CHICA, CALIBRACION_PASOS, p);
+        double t_grande = medir_jacobi(b, CALIBRACION_MALLA_GRANDE, CALIBRACION_PASOS, p);
+        Coste* c = &b->coste[HPC_JACOBI];
+        c->operacion = no_negativo((t_grande - t_chica) * ef / ((grande - chica) * pasos));
+        c->sincronizacion = (p > 1) ? no_negativo((t_chica - t_un_paso - c->operacion * chica * (pasos - 1) / ef) /
+                                                  (p * (pasos - 1)))
+                                    : 0.0;
+        c->arranque = no_negativo((t_un_paso - c->operacion * chica / ef - c->sincronizacion * p) / p);
+    }
+}
+
+void hpc_calibrar(int detallado) {
+    for (int i = 0; i < hpc_num_backends(); i++) {
+        Backend* b = hpc_backend(i);
+        if (b->disponible() > 0)
+            calibrar_backend(b);
+    }
+
+#ifdef HPC_MPI
+    // Todos los procesos deben tomar las mismas decisiones: se usan los costos del proceso 0
+    int iniciado = 0;
+    MPI_Initialized(&iniciado);
+    if (iniciado) {
+        for (int i = 0; i < hpc_num_backends(); i++)
+            MPI_Bcast(hpc_backend(i)->coste, HPC_NUM_OPERACIONES * 3, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    }
+#endif
+
+    if (detallado && rango_mpi() == 0) {
+        printf("%-12s %-7s %14s %14s %14s\n", "backend", "op", "arranque", "operacion", "sincronizacion");
+        for (int i = 0; i < hpc_num_backends(); i++) {
+            Backend* b = hpc_backend(i);
+            if (b->disponible() == 0)
+                continue;
+            for (int op = 0; op < HPC_NUM_OPERACIONES; op++) {
+                if (!implementa(b, (Operacion)op))
+                    continue;
+                printf("%-12s %-7s %14e %14e %14e\n", b->nombre, nombres_operacion[op], b->coste[op].arranque,
+                       b->coste[op].operacion, b->coste[op].sincronizacion);
+            }
+        }
+    }
+}
+
+// Archivo de calibración: una línea "backend operacion arranque operacion sincronizacion" por
+// cada par medido. Sólo el proceso 0 escribe.
+int hpc_guardar_calibracion(const char* archivo) {
+    if (rango_mpi() != 0)
+        return 0;
+    FILE* fp = fopen(archivo, "w");
+    if (fp == NULL)
+        return -1;
+    for (int i = 0; i < hpc_num_backends(); i++) {
+        Backend* b = hpc_backend(i);
+        for (int op = 0; op < HPC_NUM_OPERACIONES; op++) {
+            if (implementa(b, (Operacion)op))
+                fprintf(fp, "%s %s %.6e %.6e %.6e\n", b->nombre, nombres_operacion[op], b->coste[op].arranque,
+                        b->coste[op].operacion, b->coste[op].sincronizacion);
+        }
+    }
+    fclose(fp);
+    return 0;
+}
+
+// Devuelve el número de entradas leídas o -1 si el archivo no existe
+int hpc_cargar_calibracion(const char* archivo) {
+    FILE* fp = fopen(archivo, "r");
+    char nombre[64], operacion[16];
+    Coste c;
+    int leidas = 0;
+
+    if (fp == NULL)
+        return -1;
+    while (fscanf(fp, "%63s %15s %lf %lf %lf", nombre, operacion, &c.arranque, &c.operacion, &c.sincronizacion) == 5) {
+        Backend* b = hpc_buscar_backend(nombre);
+        for (int op = 0; b && op < HPC_NUM_OPERACIONES; op++) {
+            if (strcmp(operacion, nombres_operacion[op]) == 0) {
+                b->coste[op] = c;
+                leidas++;
+            }
+        }
+    }
+    fclose(fp);
+    return leidas;
+}
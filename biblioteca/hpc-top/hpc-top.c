@@ -0,0 +1,224 @@
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "../hpc.h"
+
+// Lector de la telemetría de la biblioteca: muestrea los segmentos /dev/shm/hpc-telemetria-<pid>
+// que crea "hpc --telemetria" y muestra el progreso de cada trabajador. Sólo proyecta los
+// segmentos para lectura, así que no molesta a los trabajadores.
+//   hpc-top [pid] [--intervalo segundos] [--veces k]
+// Sin pid se muestran todos los segmentos (con MPI, uno por proceso). Con MPI cada segmento
+// tiene sólo la suma del residuo de su tramo; el residuo se forma sumando las de los segmentos
+// de la misma ejecución, y si no están todos a la vista se indica que es parcial. Termina cuando
+// ya no queda ningún proceso vivo o después de k muestras.
+// Compilación: gcc -O2 biblioteca/hpc-top/hpc-top.c -o hpc-top -lm
+
+#define MAX_SEGMENTOS 64
+
+typedef struct {
+    int pid;
+    const SegmentoTelemetria* s;
+    int ejecucion;                                 // Ejecución de la muestra anterior
+    uint64_t pasos[HPC_TELEMETRIA_RANURAS];        // Progreso en la muestra anterior
+} Vista;
+
+static const SegmentoTelemetria* abrir_segmento(int pid) {
+    char nombre[64];
+    snprintf(nombre, sizeof(nombre), "/hpc-telemetria-%d", pid);
+    int fd = shm_open(nombre, O_RDONLY, 0);
+    if (fd < 0)
+        return NULL;
+    void* p = mmap(NULL, sizeof(SegmentoTelemetria), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED)
+        return NULL;
+    const SegmentoTelemetria* s = (const SegmentoTelemetria*)p;
+    if (s->magia != HPC_TELEMETRIA_MAGIA) {
+        munmap(p, sizeof(SegmentoTelemetria));
+        return NULL;
+    }
+    return s;
+}
+
+// Busca los segmentos en /dev/shm; devuelve cuántos encontró
+static int buscar_segmentos(Vista* vistas) {
+    DIR* dir = opendir("/dev/shm");
+    struct dirent* e;
+    int cuantos = 0;
+    if (dir == NULL)
+        return 0;
+    while ((e = readdir(dir)) != NULL && cuantos < MAX_SEGMENTOS) {
+        int pid;
+        if (sscanf(e->d_name, "hpc-telemetria-%d", &pid) != 1)
+            continue;
+        const SegmentoTelemetria* s = abrir_segmento(pid);
+        if (s) {
+            memset(&vistas[cuantos], 0, sizeof(Vista));
+            vistas[cuantos].pid = pid;
+            vistas[cuantos].s = s;
+            cuantos++;
+        }
+    }
+    closedir(dir);
+    return cuantos;
+}
+
+static uint64_t leer(const atomic_uint_least64_t* campo) {
+    return atomic_load_explicit((atomic_uint_least64_t*)campo, memory_order_relaxed);
+}
+
+static double tiempo(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static int leer_ejecucion(const SegmentoTelemetria* s) {
+    return atomic_load_explicit((atomic_int*)&s->ejecucion, memory_order_acquire);
+}
+
+// Suma de los cuadrados del cambio que publicaron los trabajadores de un segmento
+static double suma_segmento(const SegmentoTelemetria* s) {
+    double total = 0.0;
+    for (int i = 0; i < HPC_TELEMETRIA_RANURAS; i++) {
+        uint64_t bits = leer(&s->ranuras[i].suma_residuo);
+        double suma;
+        memcpy(&suma, &bits, sizeof(suma));
+        total += suma;
+    }
+    return total;
+}
+
+// Imprime el segmento k; 'intervalo' es el tiempo desde la muestra anterior para los ritmos.
+// Las demás vistas hacen falta para sumar el residuo de los procesos de una ejecución MPI.
+static void mostrar(Vista* vistas, int cuantos, int k, double intervalo) {
+    Vista* v = &vistas[k];
+    const SegmentoTelemetria* s = v->s;
+    int ejecucion = leer_ejecucion(s);
+    int jacobi = strcmp(s->operacion, "jacobi") == 0;
+    int partes = 1;
+    uint64_t minimo = 0, filas = 0;
+    int activos = 0, vistos = 0;
+
+    if (ejecucion == 0) {
+        printf("pid %d: sin ejecuciones todavía\n\n", v->pid);
+        return;
+    }
+    if (ejecucion != v->ejecucion) {
+        memset(v->pasos, 0, sizeof(v->pasos));
+        v->ejecucion = ejecucion;
+    }
+
+    printf("pid %d  %s %ld  backend %s  %d trabajadores  %.1f s", v->pid, s->operacion, s->tamano, s->backend,
+           s->trabajadores, tiempo() - s->inicio);
+    if (s->procesos > 1)
+        printf("  proceso %d de %d", s->rango, s->procesos);
+    printf("\n");
+    printf("%11s %5s %12s %10s %9s %9s %12s\n", "trabajador", "cpu", jacobi ? "barridos" : "filas", "ritmo/s",
+           "ocupado", "espera", "");
+    for (int i = 0; i < HPC_TELEMETRIA_RANURAS; i++) {
+        const RanuraTelemetria* r = &s->ranuras[i];
+        int cpu = atomic_load_explicit((atomic_int*)&r->cpu, memory_order_relaxed);
+        if (cpu < 0 && i >= s->trabajadores)
+            continue;
+        uint64_t progreso = jacobi ? leer(&r->pasos) : leer(&r->bloques);
+        double ocupado = leer(&r->ocupado_ns) / 1e9, espera = leer(&r->espera_ns) / 1e9;
+        int activo = atomic_load_explicit((atomic_int*)&r->activo, memory_order_relaxed);
+
+        if (vistos == 0 || progreso < minimo)
+            minimo = progreso;
+        filas += progreso;
+        activos += activo;
+        vistos++;
+        printf("%11d %5d %12llu %10.0f %8.2fs %8.2fs %12s\n", i, cpu, (unsigned long long)progreso,
+               (intervalo > 0 && progreso >= v->pasos[i]) ? (progreso - v->pasos[i]) / intervalo : 0.0, ocupado,
+               espera, activo ? "" : "(terminado)");
+        v->pasos[i] = progreso;
+    }
+
+    // Avance: el barrido más atrasado en Jacobi, las filas terminadas en GEMM
+    double avance = (s->total > 0) ? 100.0 * (jacobi ? minimo : filas) / s->total : 100.0;
+    printf("avance %.1f %%, %d trabajadores activos", avance > 100 ? 100.0 : avance, activos);
+    double suma_residuo = jacobi ? suma_segmento(s) : 0.0;
+    if (jacobi && s->procesos > 1) {
+        for (int j = 0; j < cuantos; j++) {
+            const SegmentoTelemetria* otro = vistas[j].s;
+            if (j != k && otro->raiz == s->raiz && leer_ejecucion(otro) == ejecucion) {
+                suma_residuo += suma_segmento(otro);
+                partes++;
+            }
+        }
+    }
+    if (jacobi && suma_residuo > 0) {
+        double h = 1.0 / s->tamano;
+        double residuo = (2.0 / (h * h)) * sqrt(h * suma_residuo);
+        if (partes < s->procesos)
+            printf(", residuo parcial %e (%d de %d procesos, cada %d barridos)", residuo, partes, s->procesos,
+                   HPC_TELEMETRIA_CADA);
+        else
+            printf(", residuo %e (cada %d barridos)", residuo, HPC_TELEMETRIA_CADA);
+    }
+    printf("\n\n");
+}
+
+int main(int argc, char* argv[]) {
+    double intervalo = 1.0;
+    int veces = 0, pid = 0;
+    Vista vistas[MAX_SEGMENTOS];
+    int cuantos;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--intervalo") == 0 && i + 1 < argc)
+            intervalo = atof(argv[++i]);
+        else if (strcmp(argv[i], "--veces") == 0 && i + 1 < argc)
+            veces = atoi(argv[++i]);
+        else
+            pid = atoi(argv[i]);
+    }
+    if (intervalo <= 0)
+        intervalo = 1.0;
+
+    if (pid > 0) {
+        memset(&vistas[0], 0, sizeof(Vista));
+        vistas[0].pid = pid;
+        vistas[0].s = abrir_segmento(pid);
+        cuantos = vistas[0].s ? 1 : 0;
+    } else {
+        cuantos = buscar_segmentos(vistas);
+    }
+    if (cuantos == 0) {
+        printf("No hay segmentos de telemetría (¿se ejecutó hpc con --telemetria?)\n");
+        return 1;
+    }
+
+    int terminal = isatty(STDOUT_FILENO);
+    double anterior = tiempo();
+    for (int muestra = 0; veces == 0 || muestra < veces; muestra++) {
+        double ahora = tiempo();
+        int vivos = 0;
+        if (terminal)
+            printf("\033[H\033[J");  // Limpia la pantalla, como top
+        for (int i = 0; i < cuantos; i++) {
+            mostrar(vistas, cuantos, i, muestra > 0 ? ahora - anterior : 0.0);
+            vivos += kill(vistas[i].pid, 0) == 0;
+        }
+        fflush(stdout);
+        anterior = ahora;
+        if (vivos == 0)
+            break;
+        struct timespec espera = {(time_t)intervalo, (long)((intervalo - (time_t)intervalo) * 1e9)};
+        nanosleep(&espera, NULL);
+    }
+
+    for (int i = 0; i < cuantos; i++)
+        munmap((void*)vistas[i].s, sizeof(SegmentoTelemetria));
+    return 0;
+}
@@ -0,0 +1,274 @@
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef HPC_MPI
+#include <mpi.h>
+#endif
+#include "hpc.h"
+
+// Programa de prueba de la biblioteca:
+//   hpc gemm <tamano> [opciones]        multiplicación de dos matrices aleatorias
+//   hpc jacobi <n> <pasos> [opciones]    barridos de Jacobi sobre la malla de n intervalos
+//   hpc backends                         registro de backends y sus costos
+//   hpc roofline                         techos de ancho de banda y de cómputo de la máquina
+//   hpc topologia                        CPU, sockets y nodos NUMA que ve el proceso
+// Opciones: --backend <nombre|auto>, --trabajadores <t> (0 = los elige el despachador),
+// --calibrar, --calibracion <archivo> (se lee si existe; si no, se calibra y se guarda),
+// --mostrar (imprime las matrices), --verificar (compara con el backend secuencial),
+// --roofline (sitúa la ejecución en el roofline de la máquina),
+// --ubicacion <ninguna|compacta|dispersa|socket> (dónde se fijan los trabajadores; por omisión, ninguna),
+// --telemetria (publica el progreso en memoria compartida para hpc-top),
+// --incremental <k> (gemm: cambia k filas de A y k columnas de B y actualiza C sólo en ellas).
+
+int main(int argc, char* argv[]) {
+    const char* operacion = NULL;
+    const char* backend = "auto";
+    const char* archivo_calibracion = NULL;
+    const char* ubicacion = NULL;
+    int trabajadores = 0;
+    int incremental = 0;    // Filas de A y columnas de B que se cambian tras el producto (gemm)
+    int calibrar = 0, mostrar = 0, verificar = 0, roofline = 0, telemetria = 0;
+    Maquina maquina;
+    char* args[2] = {NULL, NULL};
+    int nargs = 0;
+    int rango = 0;
+    unsigned semilla = (unsigned)time(NULL);
+    int resultado = 0;
+
+#ifdef HPC_MPI
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rango);
+    MPI_Bcast(&semilla, 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);  // Mismas matrices en todos los procesos
+#endif
+
+    // Separación de las opciones y los argumentos posicionales
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--backend") == 0 && i + 1 < argc)
+            backend = argv[++i];
+        else if (strcmp(argv[i], "--trabajadores") == 0 && i + 1 < argc)
+            trabajadores = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--calibracion") == 0 && i + 1 < argc)
+            archivo_calibracion = argv[++i];
+        else if (strcmp(argv[i], "--calibrar") == 0)
+            calibrar = 1;
+        else if (strcmp(argv[i], "--mostrar") == 0)
+            mostrar = 1;
+        else if (strcmp(argv[i], "--verificar") == 0)
+            verificar = 1;
+        else if (strcmp(argv[i], "--roofline") == 0)
+            roofline = 1;
+        else if (strcmp(argv[i], "--telemetria") == 0)
+            telemetria = 1;
+        else if (strcmp(argv[i], "--incremental") == 0 && i + 1 < argc)
+            incremental = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--ubicacion") == 0 && i + 1 < argc)
+            ubicacion = argv[++i];
+        else if (operacion == NULL)
+            operacion = argv[i];
+        else if (nargs < 2)
+            args[nargs++] = argv[i];
+    }
+
+    if (operacion == NULL) {
+        if (rango == 0)
+            printf("Uso: %s <gemm tamano | jacobi n pasos | backends | roofline | topologia> [opciones]\n", argv[0]);
+        resultado = 1;
+        goto fin;
+    }
+    if (ubicacion) {
+        int u = hpc_buscar_ubicacion(ubicacion);
+        if (u < 0) {
+            if (rango == 0)
+                printf("Ubicación desconocida: %s\n", ubicacion);
+            resultado = 1;
+            goto fin;
+        }
+        hpc_fijar_ubicacion((Ubicacion)u);
+    }
+
+    if (telemetria && hpc_telemetria_iniciar() == 0 && rango == 0)
+        printf("Telemetría en /dev/shm/hpc-telemetria-%d\n", (int)getpid());
+
+    // Modelo de costo: archivo guardado, calibración o valores aproximados
+    if (archivo_calibracion && !calibrar && hpc_cargar_calibracion(archivo_calibracion) >= 0) {
+        if (rango == 0)
+            printf("Calibración leída de %s\n", archivo_calibracion);
+    } else if (calibrar || archivo_calibracion) {
+        hpc_calibrar(rango == 0);
+        if (archivo_calibracion)
+            hpc_guardar_calibracion(archivo_calibracion);
+    }
+
+    // Los techos se miden antes de la ejecución para no mezclar las medidas
+    if (roofline || strcmp(operacion, "roofline") == 0)
+        hpc_caracterizar(&maquina, rango == 0 && strcmp(operacion, "roofline") == 0);
+
+    if (strcmp(operacion, "roofline") == 0) {
+        // Sólo la caracterización
+    } else if (strcmp(operacion, "topologia") == 0) {
+        if (rango == 0)
+            hpc_imprimir_topologia();
+    } else if (strcmp(operacion, "backends") == 0) {
+        if (rango == 0) {
+            for (int i = 0; i < hpc_num_backends(); i++) {
+                Backend* b = hpc_backend(i);
+                printf("%-12s disponible: %-3s gemm: %-3s jacobi: %s\n", b->nombre, b->disponible() ? "sí" : "no",
+                       b->gemm ? "sí" : "no", b->jacobi ? "sí" : "no");
+            }
+        }
+    } else if (strcmp(operacion, "gemm") == 0) {
+        int tamano = (nargs > 0) ? atoi(args[0]) : 0;
+        if (tamano <= 0) {
+            if (rango == 0)
+                printf("El tamaño de la matriz debe ser un número positivo.\n");
+            resultado = 1;
+            goto fin;
+        }
+        srand(semilla);
+        Matriz* matrizA = crear_matriz(tamano, 1);
+        Matriz* matrizB = crear_matriz(tamano, 1);
+        Matriz* matrizC = crear_matriz(tamano, 0);
+
+        if (mostrar && rango == 0) {
+            printf("Matriz A:\n");
+            imprimir_matriz(matrizA);
+            printf("\nMatriz B:\n");
+            imprimir_matriz(matrizB);
+        }
+
+        double inicio = hpc_tiempo();
+        const Backend* usado = hpc_gemm(matrizA, matrizB, matrizC, backend, &trabajadores);
+        double tiempo = hpc_tiempo() - inicio;
+
+        if (usado == NULL) {
+            if (rango == 0)
+                printf("Backend no disponible: %s\n", backend);
+            resultado = 1;
+        } else if (rango == 0) {
+            if (mostrar) {
+                printf("\nMatriz C (Resultado):\n");
+                imprimir_matriz(matrizC);
+            }
+            printf("\nBackend: %s (%d trabajadores, tiempo predicho %f segundos)\n", usado->nombre, trabajadores,
+                   hpc_prediccion(usado, HPC_GEMM, tamano, 1, trabajadores));
+            printf("Tiempo de ejecución: %f segundos\n", tiempo);
+            if (roofline) {
+                CuentaKernel k = hpc_cuenta_gemm(tamano);
+                hpc_informe_roofline(&maquina, &k, tiempo, trabajadores);
+            }
+        }
+
+        if (usado && verificar) {
+            Matriz* referencia = crear_matriz(tamano, 0);
+            int uno = 1;
+            hpc_gemm(matrizA, matrizB, referencia, "secuencial", &uno);
+            int iguales = memcmp(referencia->datos, matrizC->datos, sizeof(int) * tamano * tamano) == 0;
+            if (rango == 0)
+                printf("Verificación: %s\n", iguales ? "correcta" : "INCORRECTA");
+            resultado = !iguales;
+            eliminar_matriz(&referencia);
+        }
+
+        if (usado && incremental > 0) {
+            // Cambia 'incremental' filas de A y columnas de B al azar y pone C al día sólo en ellas
+            Producto* producto = crear_producto(matrizA, matrizB, matrizC);
+            for (int q = 0; q < incremental; q++) {
+                size_t fila = rand() % tamano, columna = rand() % tamano;
+                for (int k = 0; k < tamano; k++) {
+                    producto_cambiar_a(producto, fila, k, rand() % 100);
+                    producto_cambiar_b(producto, k, columna, rand() % 100);
+                }
+            }
+            size_t filas = producto->num_filas, columnas = producto->num_columnas;
+            int equipo = usado->distribuido ? 0 : trabajadores;
+
+            inicio = hpc_tiempo();
+            long recalculados = producto_actualizar(producto, backend, &equipo);
+            double tiempo_incremental = hpc_tiempo() - inicio;
+
+            if (rango == 0) {
+                printf("\nActualización incremental: %zu filas y %zu columnas cambiadas, %ld de %ld elementos de C "
+                       "recalculados (%d trabajadores)\n", filas, columnas, recalculados, (long)tamano * tamano,
+                       equipo);
+                printf("Tiempo de la actualización: %f segundos (%.1f %% del producto completo)\n",
+                       tiempo_incremental, tiempo > 0 ? 100.0 * tiempo_incremental / tiempo : 0.0);
+            }
+            if (verificar) {
+                Matriz* referencia = crear_matriz(tamano, 0);
+                int uno = 1;
+                hpc_gemm(matrizA, matrizB, referencia, "secuencial", &uno);
+                int iguales = memcmp(referencia->datos, matrizC->datos, sizeof(int) * tamano * tamano) == 0;
+                if (rango == 0)
+                    printf("Verificación de la actualización: %s\n", iguales ? "correcta" : "INCORRECTA");
+                resultado |= !iguales;
+                eliminar_matriz(&referencia);
+            }
+            eliminar_producto(&producto);
+        }
+
+        eliminar_matriz(&matrizA);
+        eliminar_matriz(&matrizB);
+        eliminar_matriz(&matrizC);
+    } else if (strcmp(operacion, "jacobi") == 0) {
+        int n = (nargs > 0) ? atoi(args[0]) : 0;
+        int pasos = (nargs > 1) ? atoi(args[1]) : 0;
+        if (n < 2 || pasos < 0) {
+            if (rango == 0)
+                printf("La malla necesita al menos 2 intervalos y los pasos no pueden ser negativos.\n");
+            resultado = 1;
+            goto fin;
+        }
+        Malla* malla = crear_malla(n);
+
+        double inicio = hpc_tiempo();
+        const Backend* usado = hpc_jacobi(malla, pasos, backend, &trabajadores);
+        double tiempo = hpc_tiempo() - inicio;
+
+        if (usado == NULL) {
+            if (rango == 0)
+                printf("Backend no disponible: %s\n", backend);
+            resultado = 1;
+        } else if (rango == 0) {
+            printf("\nBackend: %s (%d trabajadores, tiempo predicho %f segundos)\n", usado->nombre, trabajadores,
+                   hpc_prediccion(usado, HPC_JACOBI, n, pasos, trabajadores));
+            printf("Tiempo de ejecución: %f segundos\n", tiempo);
+            if (roofline) {
+                CuentaKernel k = hpc_cuenta_jacobi(n, pasos);
+                hpc_informe_roofline(&maquina, &k, tiempo, trabajadores);
+            }
+        }
+
+        if (usado && verificar) {
+            Malla* referencia = crear_malla(n);
+            double diferencia = 0.0;
+            int uno = 1;
+            hpc_jacobi(referencia, pasos, "secuencial", &uno);
+            for (int i = 0; i <= n; ++i) {
+                double d = referencia->u[i] - malla->u[i];
+                if (d < 0)
+                    d = -d;
+                if (d > diferencia)
+                    diferencia = d;
+            }
+            if (rango == 0)
+                printf("Verificación: diferencia máxima %e\n", diferencia);
+            resultado = diferencia != 0.0;
+            eliminar_malla(&referencia);
+        }
+        eliminar_malla(&malla);
+    } else {
+        if (rango == 0)
+            printf("Operación desconocida: %s\n", operacion);
+        resultado = 1;
+    }
+
+fin:
+    hpc_telemetria_terminar();
+#ifdef HPC_MPI
+    MPI_Finalize();
+#endif
+    return resultado;
+}
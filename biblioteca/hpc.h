@@ -0,0 +1,233 @@
+#ifndef HPC_H
+#define HPC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+// Biblioteca común para la multiplicación de matrices y el método de Jacobi. Reúne en un
+// solo lugar la matriz, la malla, la medición del tiempo y los backends que antes estaban
+// repartidos en un programa por variante, junto con un despachador que elige el backend y el
+// número de trabajadores según el tamaño del problema y un modelo de costo calibrado.
+//
+// Compilación (el backend MPI sólo existe si se define HPC_MPI y se compila con mpicc):
+//   gcc -O2 -fopenmp -pthread biblioteca/*.c -o hpc -lm
+//   mpicc -O2 -fopenmp -pthread -DHPC_MPI biblioteca/*.c -o hpc -lm
+// El lector de la telemetría es un programa aparte:
+//   gcc -O2 biblioteca/hpc-top/hpc-top.c -o hpc-top -lm
+
+// Estructura para representar una matriz cuadrada
+typedef struct {
+    size_t tamano;   // Tamaño de la matriz (N x N)
+    int* datos;      // Datos de la matriz en formato fila mayor (row-major)
+} Matriz;
+
+// Malla del problema -u'' = f en [0, 1] con u(0) = u(1) = 0
+typedef struct {
+    int n;           // Número de intervalos
+    double* u;       // Solución (n + 1 valores, fronteras incluidas)
+    double* f;       // Fuente (n + 1 valores)
+} Malla;
+
+// Matrices (matriz.c)
+Matriz* crear_matriz(size_t tamano, int aleatoria);
+void imprimir_matriz(const Matriz* matriz);
+Matriz* transponer_matriz(const Matriz* matriz);
+void eliminar_matriz(Matriz** matriz);
+
+// Mallas (matriz.c). La fuente es f(x) = x y u empieza en cero, como en los programas de Jacobi.
+Malla* crear_malla(int n);
+void eliminar_malla(Malla** malla);
+
+// Utilidades (matriz.c)
+double hpc_tiempo(void);    // Reloj monótono en segundos
+int hpc_nucleos(void);      // Núcleos en línea
+
+// Operaciones que ofrecen los backends
+typedef enum {
+    HPC_GEMM,                // C = A B con matrices de enteros
+    HPC_JACOBI,              // Barridos de Jacobi sobre una Malla
+    HPC_NUM_OPERACIONES
+} Operacion;
+
+// Modelo de costo de un backend para una operación:
+//   t = arranque * p + operacion * trabajo / min(p, núcleos) + sincronizacion * p * pasos
+// donde trabajo es N^3 para GEMM y (n - 1) * pasos para Jacobi, y p el número de trabajadores
+// (para MPI, los núcleos no limitan porque cada proceso tiene los suyos).
+typedef struct {
+    double arranque;         // Segundos por trabajador creado
+    double operacion;        // Segundos por unidad de trabajo con un trabajador
+    double sincronizacion;   // Segundos por sincronización entre barridos y por trabajador
+} Coste;
+
+// Entrada del registro de backends
+typedef struct {
+    const char* nombre;
+    int distribuido;         // El número de trabajadores es el de procesos MPI
+    int secuencial;          // Usa siempre un solo trabajador, tenga la máquina los núcleos que tenga
+    int (*disponible)(void); // Máximo de trabajadores que conviene usar (0 = no disponible)
+    void (*gemm)(const Matriz* a, const Matriz* b, Matriz* c, int trabajadores);
+    void (*jacobi)(Malla* malla, int pasos, int trabajadores);
+    Coste coste[HPC_NUM_OPERACIONES];
+} Backend;
+
+// Registro (backends.c)
+int hpc_num_backends(void);
+Backend* hpc_backend(int i);
+Backend* hpc_buscar_backend(const char* nombre);
+
+// Despachador (despacho.c)
+double hpc_prediccion(const Backend* b, Operacion op, long tamano, long pasos, int trabajadores);
+Backend* hpc_elegir(Operacion op, long tamano, long pasos, int* trabajadores); // *trabajadores <= 0: también lo elige
+void hpc_calibrar(int detallado);
+int hpc_guardar_calibracion(const char* archivo);
+int hpc_cargar_calibracion(const char* archivo);
+
+// Punto de entrada común: con backend NULL o "auto" el despachador elige el backend y, si
+// *trabajadores <= 0, también el número de trabajadores. En *trabajadores queda el número
+// usado. Devuelven el backend usado o NULL si el nombre no existe o no está disponible.
+const Backend* hpc_gemm(const Matriz* a, const Matriz* b, Matriz* c, const char* backend, int* trabajadores);
+const Backend* hpc_jacobi(Malla* malla, int pasos, const char* backend, int* trabajadores);
+
+// Producto incremental (producto.c): C = A B que se conserva entre ejecuciones y sólo recalcula
+// las filas de C cuyas filas de A cambiaron y las columnas cuyas columnas de B cambiaron.
+typedef struct {
+    Matriz* a;
+    Matriz* b;
+    Matriz* c;
+    Matriz* bt;                   // B transpuesta, al día hasta la última actualización
+    int propia;                   // 1 si C la reservó el producto
+    int completo;                 // 1 si la próxima actualización debe calcular C entera
+    unsigned char* fila_sucia;    // Filas de A cambiadas desde la última actualización
+    unsigned char* columna_sucia; // Columnas de B cambiadas
+    size_t* filas;                // Índices de las filas marcadas, en orden de marcado
+    size_t* columnas;
+    size_t num_filas, num_columnas;
+} Producto;
+
+// Con c NULL el producto reserva C y la primera actualización la calcula entera; si no, c ya
+// debe contener A B
+Producto* crear_producto(Matriz* a, Matriz* b, Matriz* c);
+void eliminar_producto(Producto** p);
+void producto_marcar_fila(Producto* p, size_t i);       // La fila i de A cambió
+void producto_marcar_columna(Producto* p, size_t j);    // La columna j de B cambió
+void producto_cambiar_a(Producto* p, size_t i, size_t k, int valor);  // Escribe A[i][k] y marca
+void producto_cambiar_b(Producto* p, size_t k, size_t j, int valor);  // Escribe B[k][j] y marca
+// Pone C al día. El recálculo parcial usa un equipo OpenMP de *trabajadores hilos (<= 0: uno
+// por núcleo); si hay que calcular C entera, o si las marcas la cubren igual, se usa hpc_gemm
+// con backend. Devuelve los elementos de C recalculados o -1 si el backend no está disponible.
+long producto_actualizar(Producto* p, const char* backend, int* trabajadores);
+
+// Caracterización roofline (roofline.c)
+#define HPC_MAX_NIVELES 4   // Hasta tres niveles de caché más la memoria principal
+
+// Techos de la máquina; el índice [0] es con un núcleo y el [1] con todos
+typedef struct {
+    int niveles;
+    const char* nombre[HPC_MAX_NIVELES];
+    size_t capacidad[HPC_MAX_NIVELES];     // Bytes de cada nivel (0 para la memoria principal)
+    double ancho[HPC_MAX_NIVELES][2];      // Bytes/s de la tríada de STREAM en cada nivel
+    double flops[2];                       // Operaciones double por segundo
+    double iops[2];                        // Operaciones enteras por segundo
+} Maquina;
+
+// Trabajo de una ejecución de un kernel
+typedef struct {
+    const char* nombre;
+    double operaciones;      // Operaciones aritméticas
+    double bytes;            // Bytes que lee y escribe el bucle interno
+    size_t reutilizado;      // Bytes que el kernel vuelve a leer y conviene tener en caché
+    int entero;              // 1 si las operaciones son enteras
+} CuentaKernel;
+
+void hpc_caracterizar(Maquina* m, int detallado);
+CuentaKernel hpc_cuenta_gemm(size_t tamano);
+CuentaKernel hpc_cuenta_jacobi(int n, int pasos);
+void hpc_informe_roofline(const Maquina* m, const CuentaKernel* k, double segundos, int trabajadores);
+
+// Ubicación de hilos y procesos (ubicacion.c)
+#define HPC_MAX_CPUS 1024
+
+typedef struct {
+    int cpu;                 // Número de CPU del sistema operativo
+    int socket;              // physical_package_id
+    int nucleo;              // core_id dentro del socket
+    int nodo;                // Nodo NUMA
+} CpuInfo;
+
+typedef struct {
+    int num_cpus;            // CPU permitidas al proceso
+    int sockets, nodos;
+    CpuInfo cpus[HPC_MAX_CPUS];
+} Topologia;
+
+// Políticas de ubicación de los trabajadores de un equipo
+typedef enum {
+    HPC_UBICACION_NINGUNA,   // No se fija nada; decide el planificador (por omisión)
+    HPC_UBICACION_COMPACTA,  // Un socket tras otro, un trabajador por núcleo antes que los hermanos SMT
+    HPC_UBICACION_DISPERSA,  // Trabajadores consecutivos en sockets distintos
+    HPC_UBICACION_SOCKET     // Bloques contiguos de trabajadores por socket
+} Ubicacion;
+
+const Topologia* hpc_topologia(void);
+void hpc_imprimir_topologia(void);
+void hpc_fijar_ubicacion(Ubicacion u);
+Ubicacion hpc_ubicacion(void);
+int hpc_buscar_ubicacion(const char* nombre);      // -1 si el nombre no existe
+int hpc_cpu_de(int trabajador, int trabajadores);  // CPU que le toca (-1 sin política)
+int hpc_fijar(int trabajador, int trabajadores);   // Fija el hilo o proceso que llama; devuelve la CPU
+int hpc_fijar_proceso(int trabajador, int trabajadores);  // Igual, pero hpc_soltar no la deshace
+void hpc_soltar(void);                             // Devuelve al que llama las CPU que tenía antes de hpc_fijar
+
+// Telemetría en memoria compartida (telemetria.c). Cada ejecución publica su progreso en el
+// segmento /dev/shm/hpc-telemetria-<pid>, que lee el programa hpc-top (con MPI, uno por proceso). Cada trabajador escribe
+// sólo su ranura, de una línea de caché, con almacenamientos atómicos relajados.
+#define HPC_TELEMETRIA_MAGIA 0x48504354454c4531ULL
+#define HPC_TELEMETRIA_RANURAS 256
+#define HPC_TELEMETRIA_CADA 64   // Barridos de Jacobi entre publicaciones del residuo
+
+typedef struct {
+    atomic_uint_least64_t pasos;         // Barridos terminados
+    atomic_uint_least64_t bloques;       // Filas de C terminadas (GEMM)
+    atomic_uint_least64_t ocupado_ns;    // Tiempo calculando
+    atomic_uint_least64_t espera_ns;     // Tiempo en barreras y comunicación
+    atomic_uint_least64_t suma_residuo;  // Bits del double con la suma de los cuadrados del cambio
+                                         // en el tramo del trabajador, en la última medición
+    atomic_int cpu;                      // CPU donde corre
+    atomic_int activo;                   // 1 mientras el trabajador está en marcha
+    char relleno[64 - 5 * sizeof(atomic_uint_least64_t) - 2 * sizeof(atomic_int)];
+} RanuraTelemetria;
+
+typedef struct {
+    uint64_t magia;
+    int pid;
+    int rango, procesos;                 // Proceso MPI dueño del segmento (0 y 1 sin MPI)
+    int raiz;                            // pid del proceso 0: identifica los segmentos de una misma
+                                         // ejecución MPI, cuyas sumas del residuo son parciales
+    atomic_int ejecucion;                // Aumenta al empezar cada ejecución
+    char operacion[16];
+    char backend[16];
+    long tamano;                         // N de la matriz o intervalos de la malla
+    long total;                          // Barridos de cada trabajador (Jacobi) o filas de C (GEMM)
+    int trabajadores;                    // Trabajadores de este proceso (1 con MPI)
+    double inicio;                       // hpc_tiempo() al empezar la ejecución
+    _Alignas(64) RanuraTelemetria ranuras[HPC_TELEMETRIA_RANURAS];
+} SegmentoTelemetria;
+
+// Cuenta de tiempo de un trabajador; con la telemetría apagada todas las operaciones son vacías
+typedef struct {
+    RanuraTelemetria* ranura;
+    uint64_t marca, ocupado, espera;
+} Cronometro;
+
+int hpc_telemetria_iniciar(void);        // Crea el segmento; 0 si todo fue bien
+void hpc_telemetria_terminar(void);      // Lo elimina
+void hpc_telemetria_ejecucion(const char* operacion, const char* backend, long tamano, long total, int trabajadores);
+void hpc_cronometro_iniciar(Cronometro* c, int trabajador);
+void hpc_cronometro_ocupado(Cronometro* c);  // Lo transcurrido desde la última marca fue cálculo
+void hpc_cronometro_espera(Cronometro* c);   // Lo transcurrido desde la última marca fue espera
+void hpc_cronometro_paso(Cronometro* c, uint64_t pasos, int medido, double suma_residuo);
+void hpc_cronometro_bloques(Cronometro* c, uint64_t bloques);
+void hpc_cronometro_terminar(Cronometro* c);
+
+#endif
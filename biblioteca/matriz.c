@@ -0,0 +1,84 @@
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "hpc.h"
+
+// Función para crear una matriz y llenarla opcionalmente con valores aleatorios
+Matriz* crear_matriz(size_t tamano, int aleatoria) {
+    Matriz* matriz = (Matriz*) malloc(sizeof(Matriz));
+    matriz->datos = (int*) malloc(sizeof(int) * tamano * tamano);
+    matriz->tamano = tamano;
+
+    if (aleatoria) {
+        for (size_t i = 0; i < tamano * tamano; i++) {
+            matriz->datos[i] = rand() % 100;  // Valores entre 0 y 99
+        }
+    }
+    return matriz;
+}
+
+// Función para imprimir una matriz en la consola
+void imprimir_matriz(const Matriz* matriz) {
+    for (size_t i = 0; i < matriz->tamano; i++) {
+        for (size_t j = 0; j < matriz->tamano; j++) {
+            printf("%d ", matriz->datos[i * matriz->tamano + j]);
+        }
+        printf("\n");
+    }
+}
+
+// Función que devuelve la transpuesta de una matriz
+Matriz* transponer_matriz(const Matriz* matriz) {
+    size_t tamano = matriz->tamano;
+    Matriz* transpuesta = crear_matriz(tamano, 0);
+
+    for (size_t i = 0; i < tamano; i++) {
+        for (size_t j = 0; j < tamano; j++) {
+            transpuesta->datos[j * tamano + i] = matriz->datos[i * tamano + j];
+        }
+    }
+    return transpuesta;
+}
+
+// Función para liberar la memoria de una matriz
+void eliminar_matriz(Matriz** matriz) {
+    if (matriz == NULL || *matriz == NULL) return;
+    free((*matriz)->datos);
+    free(*matriz);
+    *matriz = NULL;
+}
+
+// Función para crear la malla del problema con n intervalos
+Malla* crear_malla(int n) {
+    Malla* malla = (Malla*) malloc(sizeof(Malla));
+    double h = 1.0 / n;
+    malla->n = n;
+    malla->u = (double*) calloc(n + 1, sizeof(double));  // u empieza en cero
+    malla->f = (double*) malloc((n + 1) * sizeof(double));
+    for (int i = 0; i <= n; ++i)
+        malla->f[i] = i * h;  // Función fuente lineal
+    return malla;
+}
+
+// Función para liberar la memoria de una malla
+void eliminar_malla(Malla** malla) {
+    if (malla == NULL || *malla == NULL) return;
+    free((*malla)->u);
+    free((*malla)->f);
+    free(*malla);
+    *malla = NULL;
+}
+
+double hpc_tiempo(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+int hpc_nucleos(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return (n > 0) ? (int)n : 1;
+}
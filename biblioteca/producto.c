@@ -0,0 +1,172 @@
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+#include "hpc.h"
+
+// Producto C = A B que se mantiene entre ejecuciones. Quien modifica A o B marca las filas de
+// A y las columnas de B que cambió (o usa producto_cambiar_a/_b, que escriben y marcan), y
+// producto_actualizar recalcula sólo lo que depende de ellas: la fila i de C depende de la
+// fila i de A y la columna j de C de la columna j de B. Con r filas y c columnas marcadas el
+// costo es N^2 (r + c) en lugar de N^3.
+
+// Fila i de C completa, con B transpuesta para recorrer ambas por filas
+static void fila_completa(const Matriz* a, const Matriz* bt, int* c, size_t i) {
+    size_t tamano = a->tamano;
+    for (size_t j = 0; j < tamano; j++) {
+        int suma = 0;
+        for (size_t k = 0; k < tamano; k++) {
+            suma += a->datos[i * tamano + k] * bt->datos[j * tamano + k];
+        }
+        c[i * tamano + j] = suma;
+    }
+}
+
+// Elementos de la fila i de C en las columnas marcadas
+static void fila_en_columnas(const Matriz* a, const Matriz* bt, int* c, size_t i, const size_t* columnas,
+                             size_t num_columnas) {
+    size_t tamano = a->tamano;
+    for (size_t q = 0; q < num_columnas; q++) {
+        size_t j = columnas[q];
+        int suma = 0;
+        for (size_t k = 0; k < tamano; k++) {
+            suma += a->datos[i * tamano + k] * bt->datos[j * tamano + k];
+        }
+        c[i * tamano + j] = suma;
+    }
+}
+
+Producto* crear_producto(Matriz* a, Matriz* b, Matriz* c) {
+    size_t tamano = a->tamano;
+    Producto* p = (Producto*) malloc(sizeof(Producto));
+    p->a = a;
+    p->b = b;
+    p->propia = (c == NULL);
+    p->c = p->propia ? crear_matriz(tamano, 0) : c;
+    p->bt = transponer_matriz(b);
+    p->fila_sucia = (unsigned char*) calloc(tamano, 1);
+    p->columna_sucia = (unsigned char*) calloc(tamano, 1);
+    p->filas = (size_t*) malloc(tamano * sizeof(size_t));
+    p->columnas = (size_t*) malloc(tamano * sizeof(size_t));
+    p->num_filas = 0;
+    p->num_columnas = 0;
+    p->completo = p->propia;
+    return p;
+}
+
+void eliminar_producto(Producto** p) {
+    if (p == NULL || *p == NULL) return;
+    if ((*p)->propia)
+        eliminar_matriz(&(*p)->c);
+    eliminar_matriz(&(*p)->bt);
+    free((*p)->fila_sucia);
+    free((*p)->columna_sucia);
+    free((*p)->filas);
+    free((*p)->columnas);
+    free(*p);
+    *p = NULL;
+}
+
+void producto_marcar_fila(Producto* p, size_t i) {
+    if (!p->fila_sucia[i]) {
+        p->fila_sucia[i] = 1;
+        p->filas[p->num_filas++] = i;
+    }
+}
+
+void producto_marcar_columna(Producto* p, size_t j) {
+    if (!p->columna_sucia[j]) {
+        p->columna_sucia[j] = 1;
+        p->columnas[p->num_columnas++] = j;
+    }
+}
+
+void producto_cambiar_a(Producto* p, size_t i, size_t k, int valor) {
+    int* elemento = &p->a->datos[i * p->a->tamano + k];
+    if (*elemento != valor) {
+        *elemento = valor;
+        producto_marcar_fila(p, i);
+    }
+}
+
+void producto_cambiar_b(Producto* p, size_t k, size_t j, int valor) {
+    int* elemento = &p->b->datos[k * p->b->tamano + j];
+    if (*elemento != valor) {
+        *elemento = valor;
+        producto_marcar_columna(p, j);
+    }
+}
+
+// Olvida las marcas: C vuelve a estar al día con A y B
+static void limpiar_marcas(Producto* p) {
+    for (size_t q = 0; q < p->num_filas; q++)
+        p->fila_sucia[p->filas[q]] = 0;
+    for (size_t q = 0; q < p->num_columnas; q++)
+        p->columna_sucia[p->columnas[q]] = 0;
+    p->num_filas = 0;
+    p->num_columnas = 0;
+    p->completo = 0;
+}
+
+long producto_actualizar(Producto* p, const char* backend, int* trabajadores) {
+    size_t tamano = p->a->tamano;
+    long recalculados;
+
+    // Con r + c >= N el recálculo parcial cuesta lo mismo que el producto completo, que además
+    // puede ir por el backend que elija el despachador
+    if (p->completo || p->num_filas + p->num_columnas >= tamano) {
+        if (hpc_gemm(p->a, p->b, p->c, backend, trabajadores) == NULL)
+            return -1;
+        eliminar_matriz(&p->bt);
+        p->bt = transponer_matriz(p->b);
+        limpiar_marcas(p);
+        return (long)(tamano * tamano);
+    }
+
+    // Las columnas marcadas de B pasan a la transpuesta que se guarda entre actualizaciones
+    for (size_t q = 0; q < p->num_columnas; q++) {
+        size_t j = p->columnas[q];
+        for (size_t k = 0; k < tamano; k++)
+            p->bt->datos[j * tamano + k] = p->b->datos[k * tamano + j];
+    }
+
+    // Las filas marcadas se recalculan enteras; en las demás sólo las columnas marcadas. Ambos
+    // bucles escriben elementos distintos de C, así que el primero no necesita barrera.
+    int equipo = (*trabajadores > 0) ? *trabajadores : hpc_nucleos();
+    long filas_sucias = (long)p->num_filas;
+    long filas_tocadas = filas_sucias + (p->num_columnas ? (long)(tamano - p->num_filas) : 0);
+    *trabajadores = equipo;
+    hpc_telemetria_ejecucion("gemm", "incremental", (long)tamano, filas_tocadas, equipo);
+    hpc_topologia();
+    #pragma omp parallel num_threads(equipo)
+    {
+        Cronometro crono;
+        uint64_t filas = 0;
+        hpc_fijar(omp_get_thread_num(), omp_get_num_threads());
+        hpc_cronometro_iniciar(&crono, omp_get_thread_num());
+        #pragma omp for schedule(dynamic) nowait
+        for (long q = 0; q < filas_sucias; q++) {
+            fila_completa(p->a, p->bt, p->c->datos, p->filas[q]);
+            hpc_cronometro_ocupado(&crono);
+            hpc_cronometro_bloques(&crono, ++filas);
+        }
+        if (p->num_columnas) {
+            #pragma omp for
+            for (long i = 0; i < (long)tamano; i++) {
+                if (p->fila_sucia[i])
+                    continue;
+                fila_en_columnas(p->a, p->bt, p->c->datos, i, p->columnas, p->num_columnas);
+                hpc_cronometro_ocupado(&crono);
+                hpc_cronometro_bloques(&crono, ++filas);
+            }
+            hpc_cronometro_espera(&crono);  // Barrera implícita del for
+        }
+        hpc_cronometro_terminar(&crono);
+        hpc_soltar();  // Cada hilo del equipo, no sólo el que llama
+    }
+
+    recalculados = filas_sucias * (long)tamano + (long)(tamano - p->num_filas) * (long)p->num_columnas;
+    limpiar_marcas(p);
+    return recalculados;
+}
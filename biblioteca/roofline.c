@@ -0,0 +1,289 @@
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+#include "hpc.h"
+
+// Caracterización roofline. Se mide el ancho de banda de cada nivel de la jerarquía de memoria
+// con la tríada de STREAM (a = b + s c) sobre un conjunto de trabajo que cabe en ese nivel, y
+// el pico de operaciones double y int con cadenas independientes de multiplicación-suma. Los
+// kernels se sitúan en un roofline "consciente de la caché": se cuentan los bytes que mueve
+// su bucle interno y se comparan con el ancho del nivel más pequeño donde caben los datos que
+// reutilizan, que es de donde salen esos bytes.
+
+#define ROOFLINE_SEGUNDOS 0.05                  // Duración mínima de cada medida
+#define ROOFLINE_MEMORIA_MINIMA (64UL << 20)    // Conjunto de trabajo mínimo para la memoria principal
+#define ROOFLINE_MEMORIA_MAXIMA (1UL << 30)
+#define ROOFLINE_CADENAS 12                     // Cadenas independientes de la prueba de pico
+
+// Vectores de 16 bytes para las cadenas de la prueba de pico: son variables locales, así que
+// el compilador las mantiene en registros y cada repetición es sólo multiplicación y suma
+typedef double VectorDouble __attribute__((vector_size(16)));
+typedef unsigned VectorEntero __attribute__((vector_size(16)));
+#define CARRILES_DOUBLE (ROOFLINE_CADENAS * (int)(sizeof(VectorDouble) / sizeof(double)))
+#define CARRILES_ENTERO (ROOFLINE_CADENAS * (int)(sizeof(VectorEntero) / sizeof(unsigned)))
+
+// Aplica OP a cada una de las ROOFLINE_CADENAS cadenas
+#define CADENAS(OP) OP(0) OP(1) OP(2) OP(3) OP(4) OP(5) OP(6) OP(7) OP(8) OP(9) OP(10) OP(11)
+
+static const char* nombres_nivel[HPC_MAX_NIVELES] = {"L1", "L2", "L3", "memoria"};
+
+// Tamaño de la caché de datos (o unificada) de un nivel según /sys, o 0 si no se conoce
+static size_t tamano_cache(int nivel) {
+    for (int indice = 0;; indice++) {
+        char ruta[128], tipo[32];
+        int nivel_leido = 0;
+        size_t kb = 0;
+        FILE* fp;
+
+        snprintf(ruta, sizeof(ruta), "/sys/devices/system/cpu/cpu0/cache/index%d/level", indice);
+        if ((fp = fopen(ruta, "r")) == NULL)
+            return 0;
+        if (fscanf(fp, "%d", &nivel_leido) != 1)
+            nivel_leido = 0;
+        fclose(fp);
+
+        snprintf(ruta, sizeof(ruta), "/sys/devices/system/cpu/cpu0/cache/index%d/type", indice);
+        if ((fp = fopen(ruta, "r")) == NULL || fscanf(fp, "%31s", tipo) != 1)
+            strcpy(tipo, "");
+        if (fp)
+            fclose(fp);
+        if (nivel_leido != nivel || strcmp(tipo, "Instruction") == 0)
+            continue;
+
+        snprintf(ruta, sizeof(ruta), "/sys/devices/system/cpu/cpu0/cache/index%d/size", indice);
+        if ((fp = fopen(ruta, "r")) == NULL)
+            return 0;
+        if (fscanf(fp, "%zuK", &kb) != 1)
+            kb = 0;
+        fclose(fp);
+        return kb * 1024;
+    }
+}
+
+// Tríada con 'hilos' hilos; cada uno trabaja sobre sus tres arreglos de 'bytes' / 3 bytes
+static double ancho_triada(size_t bytes, int hilos) {
+    size_t elementos = bytes / (3 * sizeof(double));
+    double total = 0.0, segundos = 0.0;
+
+    if (elementos < 64)
+        elementos = 64;
+    #pragma omp parallel num_threads(hilos) reduction(+:total) reduction(max:segundos)
+    {
+        double* a = (double*)malloc(elementos * sizeof(double));
+        double* b = (double*)malloc(elementos * sizeof(double));
+        double* c = (double*)malloc(elementos * sizeof(double));
+        for (size_t i = 0; i < elementos; i++) {
+            a[i] = 0.0;
+            b[i] = 1.0;
+            c[i] = 2.0;
+        }
+        // Una pasada para traer los datos al nivel medido y otra para decidir las repeticiones
+        #pragma omp barrier
+        double inicio = hpc_tiempo();
+        for (size_t i = 0; i < elementos; i++)
+            a[i] = b[i] + 0.5 * c[i];
+        double una = hpc_tiempo() - inicio;
+        int repeticiones = (una > 0) ? (int)(ROOFLINE_SEGUNDOS / una) + 1 : 1000;
+        #pragma omp barrier
+        inicio = hpc_tiempo();
+        for (int r = 0; r < repeticiones; r++) {
+            #pragma omp simd
+            for (size_t i = 0; i < elementos; i++)
+                a[i] = b[i] + 0.5 * c[i];
+            b[r % elementos] = a[(r + 1) % elementos];  // Evita que se descarten las repeticiones
+        }
+        #pragma omp barrier
+        segundos = hpc_tiempo() - inicio;
+        total = (double)repeticiones * elementos * 3 * sizeof(double);
+        free(a);
+        free(b);
+        free(c);
+    }
+    return total / segundos;
+}
+
+// Pico de multiplicaciones-suma double (2 operaciones cada una) con 'hilos' hilos
+static double pico_double(int hilos) {
+    long repeticiones = 1L << 22;
+    double suma = 0.0, segundos = 0.0;
+
+    #pragma omp parallel num_threads(hilos) reduction(+:suma) reduction(max:segundos)
+    {
+        const VectorDouble factor = {0.999999, 0.999999}, sumando = {1e-7, 1e-7};
+#define DECLARAR(l) VectorDouble c##l = {l, l + 0.5};
+#define PASO(l) c##l = c##l * factor + sumando;
+#define SUMAR(l) suma += c##l[0] + c##l[1];
+        CADENAS(DECLARAR)
+        #pragma omp barrier
+        double inicio = hpc_tiempo();
+        for (long r = 0; r < repeticiones; r++) {
+            CADENAS(PASO)
+        }
+        segundos = hpc_tiempo() - inicio;
+        CADENAS(SUMAR)
+#undef DECLARAR
+#undef PASO
+#undef SUMAR
+    }
+    if (suma == 42.0)
+        printf(" ");  // Usa el resultado para que la prueba no se elimine
+    return 2.0 * CARRILES_DOUBLE * repeticiones * hilos / segundos;
+}
+
+// Pico de multiplicaciones-suma enteras de 32 bits con 'hilos' hilos
+static double pico_entero(int hilos) {
+    long repeticiones = 1L << 22;
+    unsigned suma = 0;
+    double segundos = 0.0;
+
+    #pragma omp parallel num_threads(hilos) reduction(+:suma) reduction(max:segundos)
+    {
+        const VectorEntero factor = {3u, 3u, 3u, 3u}, sumando = {1u, 1u, 1u, 1u};
+#define DECLARAR(l) VectorEntero c##l = {4 * l, 4 * l + 1, 4 * l + 2, 4 * l + 3};
+#define PASO(l) c##l = c##l * factor + sumando;
+#define SUMAR(l) suma += c##l[0] + c##l[1] + c##l[2] + c##l[3];
+        CADENAS(DECLARAR)
+        #pragma omp barrier
+        double inicio = hpc_tiempo();
+        for (long r = 0; r < repeticiones; r++) {
+            CADENAS(PASO)
+        }
+        segundos = hpc_tiempo() - inicio;
+        CADENAS(SUMAR)
+#undef DECLARAR
+#undef PASO
+#undef SUMAR
+    }
+    if (suma == 42u)
+        printf(" ");
+    return 2.0 * CARRILES_ENTERO * repeticiones * hilos / segundos;
+}
+
+void hpc_caracterizar(Maquina* m, int detallado) {
+    int nucleos = hpc_nucleos();
+    size_t por_defecto[3] = {32UL << 10, 1UL << 20, 32UL << 20};
+    int hilos[2] = {1, nucleos};
+
+    // Niveles de caché y memoria principal
+    m->niveles = 0;
+    for (int nivel = 1; nivel <= 3; nivel++) {
+        size_t c = tamano_cache(nivel);
+        if (c == 0 && nivel == 1)
+            c = por_defecto[0];
+        if (c == 0)
+            continue;
+        m->nombre[m->niveles] = nombres_nivel[nivel - 1];
+        m->capacidad[m->niveles++] = c;
+    }
+    if (m->niveles == 1) {
+        m->nombre[1] = nombres_nivel[1];
+        m->capacidad[1] = por_defecto[1];
+        m->nombre[2] = nombres_nivel[2];
+        m->capacidad[2] = por_defecto[2];
+        m->niveles = 3;
+    }
+    m->nombre[m->niveles] = nombres_nivel[3];
+    m->capacidad[m->niveles++] = 0;
+
+    for (int t = 0; t < 2; t++) {
+        for (int nivel = 0; nivel < m->niveles; nivel++) {
+            size_t conjunto;
+            if (m->capacidad[nivel] == 0) {
+                size_t ultimo = m->capacidad[m->niveles - 2];
+                conjunto = 4 * ultimo;
+                if (conjunto < ROOFLINE_MEMORIA_MINIMA)
+                    conjunto = ROOFLINE_MEMORIA_MINIMA;
+                if (conjunto > ROOFLINE_MEMORIA_MAXIMA)
+                    conjunto = ROOFLINE_MEMORIA_MAXIMA;
+                conjunto /= hilos[t];
+            } else if (nivel == m->niveles - 2 && nivel >= 2) {
+                conjunto = m->capacidad[nivel] / 2 / hilos[t];  // La última caché es compartida
+            } else {
+                conjunto = m->capacidad[nivel] / 2;             // Las demás son de cada núcleo
+            }
+            m->ancho[nivel][t] = ancho_triada(conjunto, hilos[t]);
+        }
+        m->flops[t] = pico_double(hilos[t]);
+        m->iops[t] = pico_entero(hilos[t]);
+    }
+
+    if (detallado) {
+        printf("%-8s %12s %16s %16s\n", "nivel", "capacidad", "GB/s (1 núcleo)", "GB/s (todos)");
+        for (int nivel = 0; nivel < m->niveles; nivel++) {
+            char capacidad[32];
+            if (m->capacidad[nivel])
+                snprintf(capacidad, sizeof(capacidad), "%zu KB", m->capacidad[nivel] >> 10);
+            else
+                snprintf(capacidad, sizeof(capacidad), "-");
+            printf("%-8s %12s %16.2f %16.2f\n", m->nombre[nivel], capacidad, m->ancho[nivel][0] / 1e9,
+                   m->ancho[nivel][1] / 1e9);
+        }
+        printf("%-21s %16.2f %16.2f\n", "GFLOP/s (double)", m->flops[0] / 1e9, m->flops[1] / 1e9);
+        printf("%-21s %16.2f %16.2f\n", "GIOP/s (int)", m->iops[0] / 1e9, m->iops[1] / 1e9);
+        printf("Núcleos: %d\n", nucleos);
+    }
+}
+
+// C = A B con enteros: una multiplicación y una suma por término. El bucle interno lee un
+// elemento de A y uno de B (o de su transpuesta) por término y escribe C una vez por elemento;
+// lo que se reutiliza entre filas de C es B completa más una fila de A.
+CuentaKernel hpc_cuenta_gemm(size_t tamano) {
+    CuentaKernel k;
+    double n = (double)tamano;
+    k.nombre = "gemm";
+    k.operaciones = 2 * n * n * n;
+    k.bytes = 2 * sizeof(int) * n * n * n + sizeof(int) * n * n;
+    k.reutilizado = sizeof(int) * (tamano * tamano + tamano);
+    k.entero = 1;
+    return k;
+}
+
+// Barrido de Jacobi: dos sumas, una multiplicación y una división por punto. Por punto se leen
+// u[i + 1] y f[i] y se escribe el arreglo de salida (u[i - 1] y u[i] ya se leyeron); entre
+// barridos se reutilizan u, el temporal y f.
+CuentaKernel hpc_cuenta_jacobi(int n, int pasos) {
+    CuentaKernel k;
+    double puntos = (double)(n - 1) * pasos;
+    k.nombre = "jacobi";
+    k.operaciones = 4 * puntos;
+    k.bytes = 3 * sizeof(double) * puntos;
+    k.reutilizado = 3 * sizeof(double) * (size_t)(n + 1);
+    k.entero = 0;
+    return k;
+}
+
+// Techo con p trabajadores: lineal desde el valor de un núcleo hasta el medido con todos
+static double techo(const double valor[2], int trabajadores) {
+    double t = valor[0] * trabajadores;
+    return (t < valor[1]) ? t : valor[1];
+}
+
+void hpc_informe_roofline(const Maquina* m, const CuentaKernel* k, double segundos, int trabajadores) {
+    int nivel = 0;
+    while (nivel < m->niveles - 1 && k->reutilizado > m->capacidad[nivel])
+        nivel++;
+
+    double intensidad = k->operaciones / k->bytes;
+    double pico = techo(k->entero ? m->iops : m->flops, trabajadores);
+    double ancho = techo(m->ancho[nivel], trabajadores);
+    double limite_memoria = intensidad * ancho;
+    int por_memoria = limite_memoria < pico;
+    double maximo = por_memoria ? limite_memoria : pico;
+    double logrado = k->operaciones / segundos;
+
+    printf("\nRoofline de %s (%d trabajadores)\n", k->nombre, trabajadores);
+    printf("Operaciones %s: %e, bytes del bucle interno: %e\n", k->entero ? "enteras" : "double",
+           k->operaciones, k->bytes);
+    printf("Intensidad aritmética: %.3f op/byte, datos reutilizados: %zu KB (nivel %s)\n", intensidad,
+           k->reutilizado >> 10, m->nombre[nivel]);
+    printf("Techo: %.2f Gop/s de cómputo, %.2f Gop/s por ancho de banda de %s -> limitado por %s\n", pico / 1e9,
+           limite_memoria / 1e9, m->nombre[nivel], por_memoria ? "memoria" : "cómputo");
+    // Un kernel no puede superar su techo: si la medida lo hace, el techo medido es el que falla
+    if (logrado > maximo)
+        printf("Logrado: %.2f Gop/s, por encima del techo medido (%.1f%%): el techo subestima la máquina\n",
+               logrado / 1e9, 100.0 * logrado / maximo);
+    else
+        printf("Logrado: %.2f Gop/s, %.1f%% del techo\n", logrado / 1e9, 100.0 * logrado / maximo);
+}
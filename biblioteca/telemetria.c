@@ -0,0 +1,154 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#ifdef HPC_MPI
+#include <mpi.h>
+#endif
+#include "hpc.h"
+
+// Telemetría de las ejecuciones. El segmento se crea con shm_open y se proyecta MAP_SHARED, así
+// que los procesos hijos de los backends lo heredan con fork y escriben en él directamente; con
+// MPI cada proceso tiene el suyo. Los trabajadores sólo hacen almacenamientos relajados en su
+// propia ranura: nadie más escribe en esa línea de caché y el lector (hpc-top) se conforma con
+// valores que pueden ir un barrido por detrás. Con la telemetría apagada el cronómetro no tiene
+// ranura y sus operaciones no hacen nada, ni siquiera leer el reloj.
+
+static SegmentoTelemetria* segmento = NULL;
+static char nombre_segmento[64];
+
+static uint64_t reloj_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000ULL + (uint64_t)t.tv_nsec;
+}
+
+int hpc_telemetria_iniciar(void) {
+    int rango = 0, procesos = 1, raiz = (int)getpid();
+    if (segmento)
+        return 0;
+#ifdef HPC_MPI
+    // Antes de crear el segmento, para que todos los procesos lleguen al Bcast aunque alguno falle
+    int iniciado = 0;
+    MPI_Initialized(&iniciado);
+    if (iniciado) {
+        MPI_Comm_rank(MPI_COMM_WORLD, &rango);
+        MPI_Comm_size(MPI_COMM_WORLD, &procesos);
+        MPI_Bcast(&raiz, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    }
+#endif
+    snprintf(nombre_segmento, sizeof(nombre_segmento), "/hpc-telemetria-%d", (int)getpid());
+    int fd = shm_open(nombre_segmento, O_CREAT | O_RDWR | O_TRUNC, 0644);
+    if (fd < 0) {
+        perror("shm_open");
+        return -1;
+    }
+    if (ftruncate(fd, sizeof(SegmentoTelemetria)) != 0) {
+        perror("ftruncate");
+        close(fd);
+        shm_unlink(nombre_segmento);
+        return -1;
+    }
+    void* p = mmap(NULL, sizeof(SegmentoTelemetria), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        perror("mmap");
+        shm_unlink(nombre_segmento);
+        return -1;
+    }
+    segmento = (SegmentoTelemetria*)p;
+    segmento->pid = (int)getpid();
+    segmento->rango = rango;
+    segmento->procesos = procesos;
+    segmento->raiz = raiz;
+    atomic_store_explicit(&segmento->ejecucion, 0, memory_order_relaxed);
+    // La magia se escribe al final para que el lector no vea un segmento a medio preparar
+    atomic_thread_fence(memory_order_release);
+    segmento->magia = HPC_TELEMETRIA_MAGIA;
+    return 0;
+}
+
+void hpc_telemetria_terminar(void) {
+    if (segmento == NULL)
+        return;
+    munmap(segmento, sizeof(SegmentoTelemetria));
+    shm_unlink(nombre_segmento);
+    segmento = NULL;
+}
+
+void hpc_telemetria_ejecucion(const char* operacion, const char* backend, long tamano, long total, int trabajadores) {
+    if (segmento == NULL)
+        return;
+    for (int i = 0; i < HPC_TELEMETRIA_RANURAS; i++) {
+        RanuraTelemetria* r = &segmento->ranuras[i];
+        atomic_store_explicit(&r->pasos, 0, memory_order_relaxed);
+        atomic_store_explicit(&r->bloques, 0, memory_order_relaxed);
+        atomic_store_explicit(&r->ocupado_ns, 0, memory_order_relaxed);
+        atomic_store_explicit(&r->espera_ns, 0, memory_order_relaxed);
+        atomic_store_explicit(&r->suma_residuo, 0, memory_order_relaxed);
+        atomic_store_explicit(&r->cpu, -1, memory_order_relaxed);
+        atomic_store_explicit(&r->activo, 0, memory_order_relaxed);
+    }
+    snprintf(segmento->operacion, sizeof(segmento->operacion), "%s", operacion);
+    snprintf(segmento->backend, sizeof(segmento->backend), "%s", backend);
+    segmento->tamano = tamano;
+    segmento->total = total;
+    segmento->trabajadores = trabajadores;
+    segmento->inicio = hpc_tiempo();
+    atomic_fetch_add_explicit(&segmento->ejecucion, 1, memory_order_release);
+}
+
+void hpc_cronometro_iniciar(Cronometro* c, int trabajador) {
+    c->ranura = (segmento && trabajador >= 0 && trabajador < HPC_TELEMETRIA_RANURAS) ? &segmento->ranuras[trabajador]
+                                                                                     : NULL;
+    c->ocupado = 0;
+    c->espera = 0;
+    if (c->ranura == NULL)
+        return;
+    c->marca = reloj_ns();
+    atomic_store_explicit(&c->ranura->cpu, sched_getcpu(), memory_order_relaxed);
+    atomic_store_explicit(&c->ranura->activo, 1, memory_order_relaxed);
+}
+
+void hpc_cronometro_ocupado(Cronometro* c) {
+    if (c->ranura == NULL)
+        return;
+    uint64_t ahora = reloj_ns();
+    c->ocupado += ahora - c->marca;
+    c->marca = ahora;
+    atomic_store_explicit(&c->ranura->ocupado_ns, c->ocupado, memory_order_relaxed);
+}
+
+void hpc_cronometro_espera(Cronometro* c) {
+    if (c->ranura == NULL)
+        return;
+    uint64_t ahora = reloj_ns();
+    c->espera += ahora - c->marca;
+    c->marca = ahora;
+    atomic_store_explicit(&c->ranura->espera_ns, c->espera, memory_order_relaxed);
+}
+
+void hpc_cronometro_paso(Cronometro* c, uint64_t pasos, int medido, double suma_residuo) {
+    if (c->ranura == NULL)
+        return;
+    if (medido) {
+        uint64_t bits;
+        memcpy(&bits, &suma_residuo, sizeof(bits));
+        atomic_store_explicit(&c->ranura->suma_residuo, bits, memory_order_relaxed);
+    }
+    atomic_store_explicit(&c->ranura->pasos, pasos, memory_order_relaxed);
+}
+
+void hpc_cronometro_bloques(Cronometro* c, uint64_t bloques) {
+    if (c->ranura)
+        atomic_store_explicit(&c->ranura->bloques, bloques, memory_order_relaxed);
+}
+
+void hpc_cronometro_terminar(Cronometro* c) {
+    if (c->ranura)
+        atomic_store_explicit(&c->ranura->activo, 0, memory_order_relaxed);
+}
@@ -0,0 +1,227 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include "hpc.h"
+
+// Ubicación de hilos y procesos. La topología (CPU, socket, núcleo y nodo NUMA de cada CPU)
+// se lee una vez de /sys, limitada a las CPU que el proceso tenía permitidas al empezar. Cada
+// política define un orden de las CPU y el trabajador p de un equipo de t se fija en una CPU
+// de ese orden con sched_setaffinity, que en Linux se aplica al hilo que la llama; por eso
+// sirve igual para hilos POSIX, hilos de OpenMP y procesos hijos. Por omisión no se fija nada:
+// varios procesos a la vez (o varios procesos MPI en un nodo) fijarían todos su trabajador p en
+// la misma CPU.
+
+static Topologia topologia;
+static int topologia_leida = 0;
+static cpu_set_t mascara_inicial;                 // CPU permitidas al empezar
+static Ubicacion politica = HPC_UBICACION_NINGUNA;
+static _Thread_local cpu_set_t mascara_previa;    // CPU del hilo antes de su primer hpc_fijar
+static _Thread_local int previa_guardada = 0;
+static int orden[HPC_UBICACION_SOCKET + 1][HPC_MAX_CPUS];  // Orden de las CPU en cada política
+
+static const char* nombres_ubicacion[] = {"ninguna", "compacta", "dispersa", "socket"};
+
+// Lee un entero de un archivo de /sys; devuelve 'defecto' si no existe
+static int leer_entero(const char* ruta, int defecto) {
+    FILE* fp = fopen(ruta, "r");
+    int valor = defecto;
+    if (fp) {
+        if (fscanf(fp, "%d", &valor) != 1)
+            valor = defecto;
+        fclose(fp);
+    }
+    return valor;
+}
+
+// Nodo NUMA de una CPU: el directorio nodeN dentro del de la CPU
+static int nodo_de(int cpu) {
+    char ruta[128];
+    for (int nodo = 0; nodo < HPC_MAX_CPUS; nodo++) {
+        snprintf(ruta, sizeof(ruta), "/sys/devices/system/cpu/cpu%d/node%d", cpu, nodo);
+        FILE* fp = fopen(ruta, "r");
+        if (fp) {
+            fclose(fp);
+            return nodo;
+        }
+        // Si no hay más nodos en el sistema se deja de buscar
+        snprintf(ruta, sizeof(ruta), "/sys/devices/system/node/node%d/cpulist", nodo);
+        if ((fp = fopen(ruta, "r")) == NULL)
+            break;
+        fclose(fp);
+    }
+    return 0;
+}
+
+// Claves de ordenamiento; cada CPU lleva además su posición entre los núcleos de su socket
+// y entre los hilos SMT de su núcleo
+typedef struct {
+    int indice, socket, nucleo_en_socket, smt;
+} Clave;
+
+static int por_socket_smt_nucleo(const void* a, const void* b) {
+    const Clave* x = (const Clave*)a;
+    const Clave* y = (const Clave*)b;
+    if (x->socket != y->socket) return x->socket - y->socket;
+    if (x->smt != y->smt) return x->smt - y->smt;
+    return x->nucleo_en_socket - y->nucleo_en_socket;
+}
+
+static int por_smt_nucleo_socket(const void* a, const void* b) {
+    const Clave* x = (const Clave*)a;
+    const Clave* y = (const Clave*)b;
+    if (x->smt != y->smt) return x->smt - y->smt;
+    if (x->nucleo_en_socket != y->nucleo_en_socket) return x->nucleo_en_socket - y->nucleo_en_socket;
+    return x->socket - y->socket;
+}
+
+const Topologia* hpc_topologia(void) {
+    if (topologia_leida)
+        return &topologia;
+    topologia_leida = 1;
+
+    CPU_ZERO(&mascara_inicial);
+    if (sched_getaffinity(0, sizeof(mascara_inicial), &mascara_inicial) != 0)
+        CPU_SET(0, &mascara_inicial);
+
+    topologia.num_cpus = 0;
+    topologia.sockets = 0;
+    topologia.nodos = 0;
+    for (int cpu = 0; cpu < HPC_MAX_CPUS && cpu < CPU_SETSIZE; cpu++) {
+        char ruta[128];
+        if (!CPU_ISSET(cpu, &mascara_inicial))
+            continue;
+        CpuInfo* c = &topologia.cpus[topologia.num_cpus++];
+        c->cpu = cpu;
+        snprintf(ruta, sizeof(ruta), "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", cpu);
+        c->socket = leer_entero(ruta, 0);
+        snprintf(ruta, sizeof(ruta), "/sys/devices/system/cpu/cpu%d/topology/core_id", cpu);
+        c->nucleo = leer_entero(ruta, cpu);
+        c->nodo = nodo_de(cpu);
+        if (c->socket + 1 > topologia.sockets)
+            topologia.sockets = c->socket + 1;
+        if (c->nodo + 1 > topologia.nodos)
+            topologia.nodos = c->nodo + 1;
+    }
+
+    // Posición de cada CPU entre los hilos SMT de su núcleo y entre los núcleos de su socket
+    Clave claves[HPC_MAX_CPUS];
+    for (int i = 0; i < topologia.num_cpus; i++) {
+        CpuInfo* c = &topologia.cpus[i];
+        claves[i].indice = i;
+        claves[i].socket = c->socket;
+        claves[i].smt = 0;
+        for (int j = 0; j < i; j++)
+            if (topologia.cpus[j].socket == c->socket && topologia.cpus[j].nucleo == c->nucleo)
+                claves[i].smt++;
+    }
+    for (int i = 0; i < topologia.num_cpus; i++) {
+        claves[i].nucleo_en_socket = 0;
+        for (int j = 0; j < topologia.num_cpus; j++)
+            if (claves[j].smt == 0 && topologia.cpus[j].socket == topologia.cpus[i].socket &&
+                topologia.cpus[j].nucleo < topologia.cpus[i].nucleo)
+                claves[i].nucleo_en_socket++;
+    }
+
+    // Compacta y socket: un socket tras otro, un hilo por núcleo antes de usar los hermanos SMT.
+    // Dispersa: de socket en socket, igual un hilo por núcleo primero.
+    Clave copia[HPC_MAX_CPUS];
+    memcpy(copia, claves, topologia.num_cpus * sizeof(Clave));
+    qsort(copia, topologia.num_cpus, sizeof(Clave), por_socket_smt_nucleo);
+    for (int i = 0; i < topologia.num_cpus; i++) {
+        orden[HPC_UBICACION_COMPACTA][i] = copia[i].indice;
+        orden[HPC_UBICACION_SOCKET][i] = copia[i].indice;
+    }
+    memcpy(copia, claves, topologia.num_cpus * sizeof(Clave));
+    qsort(copia, topologia.num_cpus, sizeof(Clave), por_smt_nucleo_socket);
+    for (int i = 0; i < topologia.num_cpus; i++)
+        orden[HPC_UBICACION_DISPERSA][i] = copia[i].indice;
+    return &topologia;
+}
+
+void hpc_fijar_ubicacion(Ubicacion u) {
+    politica = u;
+}
+
+Ubicacion hpc_ubicacion(void) {
+    return politica;
+}
+
+int hpc_buscar_ubicacion(const char* nombre) {
+    for (int u = 0; u <= HPC_UBICACION_SOCKET; u++)
+        if (strcmp(nombre, nombres_ubicacion[u]) == 0)
+            return u;
+    return -1;
+}
+
+// Índice en el orden de la política de las CPU de un socket
+static int cpu_en_socket(int socket, int posicion) {
+    int cuenta = 0;
+    for (int i = 0; i < topologia.num_cpus; i++)
+        if (topologia.cpus[orden[HPC_UBICACION_SOCKET][i]].socket == socket)
+            cuenta++;
+    if (cuenta == 0)
+        return orden[HPC_UBICACION_SOCKET][posicion % topologia.num_cpus];
+    posicion %= cuenta;
+    for (int i = 0; i < topologia.num_cpus; i++) {
+        int indice = orden[HPC_UBICACION_SOCKET][i];
+        if (topologia.cpus[indice].socket == socket && posicion-- == 0)
+            return indice;
+    }
+    return orden[HPC_UBICACION_SOCKET][0];
+}
+
+int hpc_cpu_de(int trabajador, int trabajadores) {
+    const Topologia* t = hpc_topologia();
+    if (politica == HPC_UBICACION_NINGUNA || t->num_cpus == 0 || trabajadores < 1)
+        return -1;
+
+    if (politica == HPC_UBICACION_SOCKET && t->sockets > 1) {
+        // Bloques contiguos de trabajadores por socket, como las particiones de los datos
+        int socket = (int)((long)trabajador * t->sockets / trabajadores);
+        int primero = (int)(((long)socket * trabajadores + t->sockets - 1) / t->sockets);
+        return t->cpus[cpu_en_socket(socket, trabajador - primero)].cpu;
+    }
+    // Con más trabajadores que CPU se vuelve a empezar
+    return t->cpus[orden[politica][trabajador % t->num_cpus]].cpu;
+}
+
+static int fijar_en(int cpu) {
+    cpu_set_t mascara;
+    CPU_ZERO(&mascara);
+    CPU_SET(cpu, &mascara);
+    return (sched_setaffinity(0, sizeof(mascara), &mascara) == 0) ? cpu : -1;
+}
+
+int hpc_fijar(int trabajador, int trabajadores) {
+    int cpu = hpc_cpu_de(trabajador, trabajadores);
+    if (cpu < 0)
+        return -1;
+    // Se guardan las CPU que tenía el que llama, no las del inicio del proceso, para que
+    // hpc_soltar respete una fijación anterior (la del proceso MPI, por ejemplo)
+    if (!previa_guardada && sched_getaffinity(0, sizeof(mascara_previa), &mascara_previa) == 0)
+        previa_guardada = 1;
+    return fijar_en(cpu);
+}
+
+int hpc_fijar_proceso(int trabajador, int trabajadores) {
+    int cpu = hpc_cpu_de(trabajador, trabajadores);
+    return (cpu < 0) ? -1 : fijar_en(cpu);
+}
+
+void hpc_soltar(void) {
+    if (previa_guardada) {
+        sched_setaffinity(0, sizeof(mascara_previa), &mascara_previa);
+        previa_guardada = 0;
+    }
+}
+
+void hpc_imprimir_topologia(void) {
+    const Topologia* t = hpc_topologia();
+    printf("CPU permitidas: %d, sockets: %d, nodos NUMA: %d\n", t->num_cpus, t->sockets, t->nodos);
+    printf("%6s %8s %8s %6s\n", "cpu", "socket", "núcleo", "nodo");
+    for (int i = 0; i < t->num_cpus; i++)
+        printf("%6d %8d %8d %6d\n", t->cpus[i].cpu, t->cpus[i].socket, t->cpus[i].nucleo, t->cpus[i].nodo);
+    printf("Ubicación: %s\n", nombres_ubicacion[politica]);
+}
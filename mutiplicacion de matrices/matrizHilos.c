@@ -6,7 +6,7 @@
 
 // Estructura para representar una matriz
 typedef struct {
-    size_t matrixSize; // Dimensin de la matriz (n x n)
+    size_t matrixSize; // Dimensión de la matriz (n x n)
     int* matrixData;   // Puntero a los datos de la matriz almacenados en un arreglo 1D
 } Matrix;
 
@@ -19,7 +19,7 @@ typedef struct {
     size_t endRow;    // Fila final para este hilo
 } ThreadData;
 
-// Funcin para crear una matriz
+// Función para crear una matriz
 Matrix* create_matrix(size_t matrixSize, int fillWithRandom) {
     Matrix* matrix = (Matrix*) malloc(sizeof(Matrix));
     matrix->matrixData = (int*) malloc(sizeof(int) * matrixSize * matrixSize);
@@ -28,13 +28,13 @@ Matrix* create_matrix(size_t matrixSize, int fillWithRandom) {
     // Si fillWithRandom es 1, se llena la matriz con valores aleatorios
     if (fillWithRandom) {
         for (size_t i = 0; i < matrixSize * matrixSize; i++) {
-            matrix->matrixData[i] = rand() % 100; // Nmeros entre 0 y 99
+            matrix->matrixData[i] = rand() % 100; // Números entre 0 y 99
         }
     }
     return matrix;
 }
 
-// Funcin para imprimir una matriz en la consola
+// Función para imprimir una matriz en la consola
 void print_matrix(Matrix* matrix) {
     for (size_t i = 0; i < matrix->matrixSize; i++) {
         for (size_t j = 0; j < matrix->matrixSize; j++) {
@@ -44,7 +44,7 @@ void print_matrix(Matrix* matrix) {
     }
 }
 
-// Funcin que ejecutan los hilos para multiplicar la matriz en filas asignadas
+// Función que ejecutan los hilos para multiplicar la matriz en filas asignadas
 void* multiply_matrices_thread(void* arg) {
     ThreadData* data = (ThreadData*) arg;
     size_t size = data->matrixA->matrixSize;
@@ -62,7 +62,7 @@ void* multiply_matrices_thread(void* arg) {
     return NULL;
 }
 
-// Funcin para multiplicar dos matrices utilizando hilos
+// Función para multiplicar dos matrices utilizando hilos
 Matrix* multiply_matrices(Matrix* matrixA, Matrix* matrixB, int numThreads) {
     size_t size = matrixA->matrixSize;
     Matrix* resultMatrix = create_matrix(size, 0); // Crear matriz resultado
@@ -80,7 +80,7 @@ Matrix* multiply_matrices(Matrix* matrixA, Matrix* matrixB, int numThreads) {
         threadData[i].startRow = i * rowsPerThread;
         threadData[i].endRow = (i + 1) * rowsPerThread;
         
-        // El ltimo hilo toma las filas restantes
+        // El último hilo toma las filas restantes
         if (i == numThreads - 1) threadData[i].endRow += remainingRows;
 
         pthread_create(&threads[i], NULL, multiply_matrices_thread, &threadData[i]);
@@ -94,7 +94,7 @@ Matrix* multiply_matrices(Matrix* matrixA, Matrix* matrixB, int numThreads) {
     return resultMatrix;
 }
 
-// Funcin para liberar la memoria de una matriz
+// Función para liberar la memoria de una matriz
 void delete_matrix(Matrix** matrix) {
     if (matrix == NULL || *matrix == NULL) return;
     free((*matrix)->matrixData);
@@ -105,27 +105,27 @@ void delete_matrix(Matrix** matrix) {
 int main(int argc, char* argv[]) {
     // Verificar que los argumentos sean correctos
     if (argc != 4) {
-        printf("Uso: %s <tamao_matriz> <num_hilos> <mostrar_matrices (0 o 1)>\n", argv[0]);
+        printf("Uso: %s <tamaño_matriz> <num_hilos> <mostrar_matrices (0 o 1)>\n", argv[0]);
         return 1;
     }
 
-    int matrixSize = atoi(argv[1]); // Tamao de la matriz
-    int numThreads = atoi(argv[2]); // Nmero de hilos a usar
+    int matrixSize = atoi(argv[1]); // Tamaño de la matriz
+    int numThreads = atoi(argv[2]); // Número de hilos a usar
     int showMatrices = atoi(argv[3]); // Bandera para mostrar o no las matrices
 
-    // Validacin de parmetros
+    // Validación de parámetros
     if (matrixSize <= 0 || numThreads <= 0) {
-        printf("El tamao de la matriz y el nmero de hilos deben ser positivos.\n");
+        printf("El tamaño de la matriz y el número de hilos deben ser positivos.\n");
         return 1;
     }
 
-    srand(time(NULL)); // Inicializar generador de nmeros aleatorios
+    srand(time(NULL)); // Inicializar generador de números aleatorios
     
     // Crear matrices A y B
     Matrix* matrixA = create_matrix(matrixSize, 1);
     Matrix* matrixB = create_matrix(matrixSize, 1);
 
-    // Si se activ la opcin, imprimir las matrices originales
+    // Si se activó la opción, imprimir las matrices originales
     if (showMatrices) {
         printf("Matriz A:\n");
         print_matrix(matrixA);
@@ -134,22 +134,22 @@ int main(int argc, char* argv[]) {
     }
 
     struct timespec start, end;
-    clock_gettime(CLOCK_MONOTONIC, &start); // Iniciar medicin de tiempo
+    clock_gettime(CLOCK_MONOTONIC, &start); // Iniciar medición de tiempo
 
     // Multiplicar matrices
     Matrix* resultMatrix = multiply_matrices(matrixA, matrixB, numThreads);
-    clock_gettime(CLOCK_MONOTONIC, &end);  // Finalizar medicin de tiempo
+    clock_gettime(CLOCK_MONOTONIC, &end);  // Finalizar medición de tiempo
 
-    // Si se activ la opcin, imprimir la matriz resultado
+    // Si se activó la opción, imprimir la matriz resultado
     if (showMatrices) {
         printf("\nMatriz C (Resultado):\n");
         print_matrix(resultMatrix);
     }
 
-    // Calcular y mostrar el tiempo de ejecucin
+    // Calcular y mostrar el tiempo de ejecución
     double executionTime = (end.tv_sec - start.tv_sec) + 
                          (end.tv_nsec - start.tv_nsec) / 1e9;
-    printf("\nTiempo de ejecucin: %f segundos\n", executionTime);
+    printf("\nTiempo de ejecución: %f segundos\n", executionTime);
 
     // Liberar memoria de las matrices
     delete_matrix(&matrixA);
@@ -9,11 +9,11 @@
 
 // Estructura para representar una matriz cuadrada
 typedef struct {
-    size_t matrixSize; // Tamao de la matriz (n x n)
+    size_t matrixSize; // Tamaño de la matriz (n x n)
     int* matrixData;   // Puntero a los datos de la matriz
 } Matrix;
 
-// Funcin para crear una matriz y llenarla con valores aleatorios si se solicita
+// Función para crear una matriz y llenarla con valores aleatorios si se solicita
 Matrix* create_matrix(size_t matrixSize, int fillWithRandom) {
     Matrix* matrix = (Matrix*) malloc(sizeof(Matrix)); // Reservar memoria para la estructura de la matriz
     matrix->matrixData = (int*) malloc(sizeof(int) * matrixSize * matrixSize); // Reservar memoria para los datos
@@ -28,7 +28,7 @@ Matrix* create_matrix(size_t matrixSize, int fillWithRandom) {
     return matrix;
 }
 
-// Funcin para imprimir una matriz en formato de tabla
+// Función para imprimir una matriz en formato de tabla
 void print_matrix(Matrix* matrix) {
     for (size_t i = 0; i < matrix->matrixSize; i++) {
         for (size_t j = 0; j < matrix->matrixSize; j++) {
@@ -38,21 +38,21 @@ void print_matrix(Matrix* matrix) {
     }
 }
 
-// Funcin para multiplicar matrices utilizando procesos
+// Función para multiplicar matrices utilizando procesos
 void multiply_matrices(Matrix* matrixA, Matrix* matrixB, int* resultMatrix, int numProcesses) {
     size_t size = matrixA->matrixSize;
-    size_t rowsPerProcess = size / numProcesses; // Filas que calcular cada proceso
+    size_t rowsPerProcess = size / numProcesses; // Filas que calculará cada proceso
     size_t remainingRows = size % numProcesses; // Filas restantes en caso de que no sea divisible
 
     for (int i = 0; i < numProcesses; i++) {
         pid_t pid = fork(); // Crear un proceso hijo
 
-        if (pid == 0) { // Cdigo ejecutado por los procesos hijos
+        if (pid == 0) { // Código ejecutado por los procesos hijos
             size_t startRow = i * rowsPerProcess;
             size_t endRow = (i + 1) * rowsPerProcess;
-            if (i == numProcesses - 1) endRow += remainingRows; // El ltimo proceso maneja las filas restantes
+            if (i == numProcesses - 1) endRow += remainingRows; // El último proceso maneja las filas restantes
 
-            // Multiplicacin de matrices para las filas asignadas a este proceso
+            // Multiplicación de matrices para las filas asignadas a este proceso
             for (size_t i = startRow; i < endRow; i++) {
                 for (size_t j = 0; j < size; j++) {
                     resultMatrix[i * size + j] = 0;
@@ -61,7 +61,7 @@ void multiply_matrices(Matrix* matrixA, Matrix* matrixB, int* resultMatrix, int
                     }
                 }
             }
-            exit(0); // Terminar el proceso hijo despus de completar su tarea
+            exit(0); // Terminar el proceso hijo después de completar su tarea
         }
     }
 
@@ -72,23 +72,23 @@ void multiply_matrices(Matrix* matrixA, Matrix* matrixB, int* resultMatrix, int
 }
 
 int main(int argc, char* argv[]) {
-    // Validacin de los argumentos ingresados
+    // Validación de los argumentos ingresados
     if (argc != 4) {
-        printf("Uso: %s <tamao_matriz> <num_procesos> <mostrar_matrices (0 o 1)>\n", argv[0]);
+        printf("Uso: %s <tamaño_matriz> <num_procesos> <mostrar_matrices (0 o 1)>\n", argv[0]);
         return 1;
     }
 
-    int matrixSize = atoi(argv[1]); // Tamao de la matriz
-    int numProcesses = atoi(argv[2]); // Nmero de procesos a utilizar
+    int matrixSize = atoi(argv[1]); // Tamaño de la matriz
+    int numProcesses = atoi(argv[2]); // Número de procesos a utilizar
     int showMatrices = atoi(argv[3]); // Bandera para mostrar matrices
 
     // Validar que los valores ingresados sean positivos
     if (matrixSize <= 0 || numProcesses <= 0) {
-        printf("El tamao de la matriz y el nmero de procesos deben ser positivos.\n");
+        printf("El tamaño de la matriz y el número de procesos deben ser positivos.\n");
         return 1;
     }
 
-    srand(time(NULL)); // Inicializar la semilla para nmeros aleatorios
+    srand(time(NULL)); // Inicializar la semilla para números aleatorios
 
     // Crear matrices A y B con valores aleatorios
     Matrix* matrixA = create_matrix(matrixSize, 1);
@@ -106,7 +106,7 @@ int main(int argc, char* argv[]) {
     int shm_id = shmget(IPC_PRIVATE, matrixSize * matrixSize * sizeof(int), IPC_CREAT | 0666);
     int* resultMatrix = (int*) shmat(shm_id, NULL, 0);
 
-    // Medir el tiempo de ejecucin de la multiplicacin de matrices
+    // Medir el tiempo de ejecución de la multiplicación de matrices
     struct timespec start, end;
     clock_gettime(CLOCK_MONOTONIC, &start);
 
@@ -114,9 +114,9 @@ int main(int argc, char* argv[]) {
 
     clock_gettime(CLOCK_MONOTONIC, &end);
     
-    // Calcular el tiempo de ejecucin en segundos
+    // Calcular el tiempo de ejecución en segundos
     double executionTime = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
-    printf("\nTiempo de ejecucin: %f segundos\n", executionTime);
+    printf("\nTiempo de ejecución: %f segundos\n", executionTime);
 
     // Imprimir la matriz resultante si el usuario lo solicita
     if (showMatrices) {
@@ -4,11 +4,11 @@
 
 // Estructura para representar una matriz cuadrada
 typedef struct {
-    size_t matrixSize; // Dimensin de la matriz (n x n)
+    size_t matrixSize; // Dimensión de la matriz (n x n)
     int* matrixData;   // Puntero a los datos de la matriz almacenados en un arreglo unidimensional
 } Matrix;
 
-// Funcin para crear una matriz
+// Función para crear una matriz
 Matrix* create_matrix(size_t matrixSize, int fillWithRandom) {
     Matrix* matrix = (Matrix*) malloc(sizeof(Matrix)); // Reservar memoria para la estructura
     matrix->matrixData = (int*) malloc(sizeof(int) * matrixSize * matrixSize); // Reservar memoria para los datos
@@ -23,7 +23,7 @@ Matrix* create_matrix(size_t matrixSize, int fillWithRandom) {
     return matrix;
 }
 
-// Funcin para imprimir una matriz en formato de tabla
+// Función para imprimir una matriz en formato de tabla
 void print_matrix(Matrix* matrix) {
     for (size_t i = 0; i < matrix->matrixSize; i++) {
         for (size_t j = 0; j < matrix->matrixSize; j++) {
@@ -33,12 +33,12 @@ void print_matrix(Matrix* matrix) {
     }
 }
 
-// Funcin para multiplicar dos matrices cuadradas
+// Función para multiplicar dos matrices cuadradas
 Matrix* multiply_matrices(Matrix* matrixA, Matrix* matrixB) {
     size_t size = matrixA->matrixSize;
-    Matrix* resultMatrix = create_matrix(size, 0); // Crear matriz vaca para el resultado
+    Matrix* resultMatrix = create_matrix(size, 0); // Crear matriz vacía para el resultado
 
-    // Algoritmo estndar de multiplicacin de matrices
+    // Algoritmo estándar de multiplicación de matrices
     for (size_t i = 0; i < size; i++) {
         for (size_t j = 0; j < size; j++) {
             resultMatrix->matrixData[i * size + j] = 0;
@@ -51,7 +51,7 @@ Matrix* multiply_matrices(Matrix* matrixA, Matrix* matrixB) {
     return resultMatrix;
 }
 
-// Funcin para liberar la memoria reservada para una matriz
+// Función para liberar la memoria reservada para una matriz
 void delete_matrix(Matrix** matrix) {
     if (matrix == NULL || *matrix == NULL) return;
     free((*matrix)->matrixData); // Liberar memoria de los datos de la matriz
@@ -62,19 +62,19 @@ void delete_matrix(Matrix** matrix) {
 int main(int argc, char* argv[]) {
     // Verificar los argumentos de entrada
     if (argc != 3) {
-        printf("Uso: %s <tamao_matriz> <mostrar_matrices (0 o 1)>\n", argv[0]);
+        printf("Uso: %s <tamaño_matriz> <mostrar_matrices (0 o 1)>\n", argv[0]);
         return 1;
     }
 
     int matrixSize = atoi(argv[1]); // Convertir argumento a entero
     if (matrixSize <= 0) {
-        printf("El tamao de la matriz debe ser un nmero positivo.\n");
+        printf("El tamaño de la matriz debe ser un número positivo.\n");
         return 1;
     }
 
     int showMatrices = atoi(argv[2]); // Indicar si se deben mostrar las matrices
 
-    srand(time(NULL)); // Inicializar la semilla para la generacin de nmeros aleatorios
+    srand(time(NULL)); // Inicializar la semilla para la generación de números aleatorios
 
     // Crear matrices A y B con valores aleatorios
     Matrix* matrixA = create_matrix(matrixSize, 1);
@@ -88,7 +88,7 @@ int main(int argc, char* argv[]) {
         print_matrix(matrixB);
     }
 
-    // Medir el tiempo de ejecucin de la multiplicacin de matrices
+    // Medir el tiempo de ejecución de la multiplicación de matrices
     clock_t start = clock();
     Matrix* resultMatrix = multiply_matrices(matrixA, matrixB);
     clock_t end = clock();
@@ -99,9 +99,9 @@ int main(int argc, char* argv[]) {
         print_matrix(resultMatrix);
     }
 
-    // Calcular y mostrar el tiempo de ejecucin
+    // Calcular y mostrar el tiempo de ejecución
     double executionTime = ((double)(end - start)) / CLOCKS_PER_SEC;
-    printf("\nTiempo de ejecucin: %f segundos\n", executionTime);
+    printf("\nTiempo de ejecución: %f segundos\n", executionTime);
 
     // Liberar la memoria reservada para las matrices
     delete_matrix(&matrixA);
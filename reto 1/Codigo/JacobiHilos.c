@@ -1,65 +1,100 @@
-#define _POSIX_C_SOURCE 199309L
+#define _POSIX_C_SOURCE 200112L
 #define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 #include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
 #include <time.h>
+#include "checkpoint.h"
+#include "spectrum.h"
 
-// Definimos valores por defecto para el tamao del problema, nmero de iteraciones y nmero de hilos
+// Definimos valores por defecto para el tamaño del problema, número de iteraciones y número de hilos
 #define DEFAULT_N 100000
 #define DEFAULT_NSTEPS 1000
 #define DEFAULT_THREADS 4
+#define SPIN_LIMIT 1000 // Consultas activas a un contador antes de ceder el procesador
 
 // Estructura que almacena los datos de cada hilo
 typedef struct {
-    int start, end; // Rango de ndices que procesar el hilo
+    int start, end; // Rango de índices que procesará el hilo
     int n;
     double h2;
     double* u;
     double* f;
     double* utmp;
+    int measure;    // Si es 1, el hilo acumula el cuadrado de la actualización en sum
+    double sum;     // Suma parcial para la norma del residuo
 } ThreadData;
 
 pthread_barrier_t barrier; // Barrera para sincronizar los hilos
 
-// Funcin que ejecuta cada hilo para actualizar una porcin del arreglo
+// Función que ejecuta cada hilo para actualizar una porción del arreglo
 void* jacobi_thread(void* arg) {
     ThreadData* data = (ThreadData*)arg;
-    for (int i = data->start; i < data->end; ++i) {
-        data->utmp[i] = (data->u[i-1] + data->u[i+1] + data->h2 * data->f[i]) / 2;
+    if (data->measure) {
+        // Barrido fusionado con la suma parcial del residuo del hilo
+        double sum = 0.0;
+        for (int i = data->start; i < data->end; ++i) {
+            double next = (data->u[i-1] + data->u[i+1] + data->h2 * data->f[i]) / 2;
+            double d = next - data->u[i];
+            sum += d * d;
+            data->utmp[i] = next;
+        }
+        data->sum = sum;
+    } else {
+        for (int i = data->start; i < data->end; ++i) {
+            data->utmp[i] = (data->u[i-1] + data->u[i+1] + data->h2 * data->f[i]) / 2;
+        }
     }
 
-    // Sincronizacin de los hilos antes de proceder con la siguiente iteracin
+    // Sincronización de los hilos antes de proceder con la siguiente iteración
     pthread_barrier_wait(&barrier);
     return NULL;
 }
 
-// Funcin que ejecuta el mtodo de Jacobi en paralelo
-void jacobi(int nsweeps, int n, int num_threads, double* u, double* f) {
+// Función que ejecuta el método de Jacobi en paralelo
+// Si tol > 0, cada 'cada' barridos los hilos acumulan su parte del residuo durante el
+// propio barrido; el hilo principal la reduce y se detiene cuando la norma es menor que tol.
+// Si ckpt no es NULL, tras cada barrido se le ofrece u para el checkpoint periódico.
+// Devuelve el número de barridos realizados y deja en *residual la última norma medida.
+int jacobi(int nsweeps, int n, int num_threads, double* u, double* f, double tol, int cada, Checkpoint* ckpt,
+           double* residual) {
     int i, sweep;
+    int since_check = 0; // Barridos desde la última medición del residuo
     double h = 1.0 / n;
     double h2 = h * h;
-    double* utmp = (double*)malloc((n + 1) * sizeof(double)); // Arreglo temporal
+    double* u_in = u; // Arreglo del llamador, donde debe quedar la solución
+    double* buffer = (double*)malloc((n + 1) * sizeof(double));
+    double* utmp = buffer; // Arreglo temporal
 
     utmp[0] = u[0]; // Condiciones de frontera
     utmp[n] = u[n];
 
     pthread_t threads[num_threads]; // Arreglo de hilos
     ThreadData thread_data[num_threads]; // Datos para cada hilo
-    pthread_barrier_init(&barrier, NULL, num_threads); // Inicializacin de la barrera
-    int chunk_size = n / num_threads; // Tamao de la porcin de datos para cada hilo
+    pthread_barrier_init(&barrier, NULL, num_threads); // Inicialización de la barrera
+    int chunk_size = n / num_threads; // Tamaño de la porción de datos para cada hilo
 
-    for (sweep = 0; sweep < nsweeps; sweep += 2) {
-        // Crear hilos para realizar el clculo en paralelo
+    for (sweep = 0; sweep < nsweeps; ++sweep) {
+        int measure = 0;
+        if (tol > 0 && ++since_check >= cada) {
+            measure = 1;
+            since_check = 0;
+        }
+
+        // Crear hilos para realizar el cálculo en paralelo
         for (i = 0; i < num_threads; i++) {
             thread_data[i].start = 1 + i * chunk_size;
-            thread_data[i].end = (i == num_threads - 1) ? n : (i + 1) * chunk_size;
+            thread_data[i].end = (i == num_threads - 1) ? n : 1 + (i + 1) * chunk_size;
             thread_data[i].n = n;
             thread_data[i].h2 = h2;
             thread_data[i].u = u;
             thread_data[i].f = f;
             thread_data[i].utmp = utmp;
+            thread_data[i].measure = measure;
             pthread_create(&threads[i], NULL, jacobi_thread, &thread_data[i]);
         }
 
@@ -68,44 +103,721 @@ void jacobi(int nsweeps, int n, int num_threads, double* u, double* f) {
             pthread_join(threads[i], NULL);
         }
 
-        // Intercambiar los punteros para la siguiente iteracin
+        // Intercambiar los punteros para la siguiente iteración
         double* tmp = u;
         u = utmp;
         utmp = tmp;
+
+        // Reducción de las sumas parciales de los hilos
+        if (measure) {
+            double sum = 0.0;
+            for (i = 0; i < num_threads; i++)
+                sum += thread_data[i].sum;
+            *residual = (2.0 / h2) * sqrt(h * sum);
+            if (*residual < tol) {
+                ++sweep;
+                break;
+            }
+        }
+        checkpoint_save(ckpt, sweep + 1, u);
     }
 
+    // Si el último barrido dejó la solución en el arreglo temporal, se copia al del llamador
+    if (u != u_in)
+        memcpy(u_in + 1, u + 1, (n - 1) * sizeof(double));
+
     pthread_barrier_destroy(&barrier); // Destruir la barrera al final del proceso
-    free(utmp); // Liberar memoria
+    free(buffer); // Liberar memoria
+    return sweep;
+}
+
+// Contador de barridos terminados por un hilo, solo en su línea de caché
+typedef struct {
+    atomic_int sweeps;
+    char pad[64 - sizeof(atomic_int)];
+} SweepCounter;
+
+// Estado compartido por los hilos de Jacobi con sincronización entre vecinos
+typedef struct {
+    int num_threads, nsweeps, cada;
+    double h, h2, tol;
+    double* u;
+    double* utmp;
+    double* f;
+    double* sums;         // Suma parcial del residuo de cada hilo
+    SweepCounter* done;   // Barridos terminados por cada hilo
+    int stop;             // Lo activa el hilo que reduce al alcanzar la tolerancia
+    int sweeps;           // Barridos realizados
+    double residual;      // Última norma medida
+} NeighborShared;
+
+// Datos de cada hilo de Jacobi con sincronización entre vecinos
+typedef struct {
+    int id;
+    int start, end;       // Rango de índices que procesará el hilo
+    NeighborShared* shared;
+} NeighborThreadData;
+
+// Espera a que el hilo dueño del contador haya terminado al menos 'sweep' barridos
+static void wait_neighbor(SweepCounter* c, int sweep) {
+    int spins = 0;
+    while (atomic_load_explicit(&c->sweeps, memory_order_acquire) < sweep) {
+        if (++spins >= SPIN_LIMIT) {
+            sched_yield();
+            spins = 0;
+        }
+    }
+}
+
+// Función que ejecuta cada hilo durante todos los barridos de Jacobi sin barrera global.
+// Antes del barrido 'sweep' el hilo sólo espera a que sus dos vecinos hayan terminado el
+// anterior: así sus bordes están al día en el arreglo de lectura y ya no leen el de
+// escritura, que es el que usaron en ese barrido. Los hilos no vecinos pueden ir varios
+// barridos separados. Sólo los barridos en que se mide el residuo usan la barrera.
+void* neighbor_thread(void* arg) {
+    NeighborThreadData* data = (NeighborThreadData*)arg;
+    NeighborShared* s = data->shared;
+    int id = data->id;
+    int since_check = 0;
+    double* src = s->u;
+    double* dst = s->utmp;
+
+    for (int sweep = 0; sweep < s->nsweeps; ++sweep) {
+        int measure = 0;
+        if (s->tol > 0 && ++since_check >= s->cada) {
+            measure = 1;
+            since_check = 0;
+        }
+
+        if (id > 0)
+            wait_neighbor(&s->done[id - 1], sweep);
+        if (id < s->num_threads - 1)
+            wait_neighbor(&s->done[id + 1], sweep);
+
+        if (measure) {
+            // Barrido fusionado con la suma parcial del residuo del hilo
+            double sum = 0.0;
+            for (int i = data->start; i < data->end; ++i) {
+                double next = (src[i-1] + src[i+1] + s->h2 * s->f[i]) / 2;
+                double d = next - src[i];
+                sum += d * d;
+                dst[i] = next;
+            }
+            s->sums[id] = sum;
+        } else {
+            for (int i = data->start; i < data->end; ++i)
+                dst[i] = (src[i-1] + src[i+1] + s->h2 * s->f[i]) / 2;
+        }
+
+        // Publica el barrido: los vecinos que lo esperan ven también los valores escritos
+        atomic_store_explicit(&s->done[id].sweeps, sweep + 1, memory_order_release);
+
+        double* tmp = src;
+        src = dst;
+        dst = tmp;
+
+        if (measure) {
+            // Un único hilo reduce las sumas parciales y decide si se detiene
+            if (pthread_barrier_wait(&barrier) == PTHREAD_BARRIER_SERIAL_THREAD) {
+                double total = 0.0;
+                for (int t = 0; t < s->num_threads; ++t)
+                    total += s->sums[t];
+                s->residual = (2.0 / s->h2) * sqrt(s->h * total);
+                if (s->residual < s->tol) {
+                    s->stop = 1;
+                    s->sweeps = sweep + 1;
+                }
+            }
+            pthread_barrier_wait(&barrier);
+            if (s->stop)
+                break;
+        }
+    }
+    return NULL;
+}
+
+// Método de Jacobi con hilos creados una sola vez y sincronización punto a punto entre
+// vecinos en lugar de una barrera por barrido. Mismo criterio de parada que jacobi.
+// Devuelve -1 si no hay memoria para sus arreglos.
+int jacobi_neighbors(int nsweeps, int n, int num_threads, double* u, double* f, double tol, int cada,
+                     double* residual) {
+    int i;
+    double h = 1.0 / n;
+    NeighborShared shared;
+    pthread_t threads[num_threads];
+    NeighborThreadData thread_data[num_threads];
+    int chunk_size = n / num_threads;
+
+    shared.num_threads = num_threads;
+    shared.nsweeps = nsweeps;
+    shared.cada = cada;
+    shared.h = h;
+    shared.h2 = h * h;
+    shared.tol = tol;
+    shared.u = u;
+    shared.utmp = (double*)malloc((n + 1) * sizeof(double));
+    shared.f = f;
+    shared.sums = (double*)calloc(num_threads, sizeof(double));
+    shared.done = (SweepCounter*)aligned_alloc(64, num_threads * sizeof(SweepCounter));
+    if (shared.utmp == NULL || shared.sums == NULL || shared.done == NULL) {
+        printf("Error: out of memory for neighbor synchronization\n");
+        free(shared.utmp);
+        free(shared.sums);
+        free(shared.done);
+        return -1;
+    }
+    shared.stop = 0;
+    shared.sweeps = nsweeps;
+    shared.residual = *residual;
+
+    shared.utmp[0] = u[0]; // Condiciones de frontera
+    shared.utmp[n] = u[n];
+    for (i = 0; i < num_threads; i++)
+        atomic_init(&shared.done[i].sweeps, 0);
+
+    pthread_barrier_init(&barrier, NULL, num_threads);
+    for (i = 0; i < num_threads; i++) {
+        thread_data[i].id = i;
+        thread_data[i].start = 1 + i * chunk_size;
+        thread_data[i].end = (i == num_threads - 1) ? n : 1 + (i + 1) * chunk_size;
+        thread_data[i].shared = &shared;
+        pthread_create(&threads[i], NULL, neighbor_thread, &thread_data[i]);
+    }
+    for (i = 0; i < num_threads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    pthread_barrier_destroy(&barrier);
+
+    // Tras un número impar de barridos la solución quedó en el arreglo temporal
+    if (shared.sweeps % 2 == 1)
+        memcpy(u + 1, shared.utmp + 1, (n - 1) * sizeof(double));
+
+    *residual = shared.residual;
+    free(shared.done);
+    free(shared.sums);
+    free(shared.utmp);
+    return shared.sweeps;
+}
+
+// Estado compartido por los hilos del método SOR rojo-negro
+typedef struct {
+    int num_threads, nsweeps, cada;
+    double h, h2, omega, tol;
+    double* u;
+    double* f;
+    double* sums;      // Suma parcial del residuo de cada hilo
+    int stop;          // Lo activa el hilo que reduce al alcanzar la tolerancia
+    int sweeps;        // Barridos realizados
+    double residual;   // Última norma medida
+} SorShared;
+
+// Datos de cada hilo del método SOR
+typedef struct {
+    int id;
+    int start, end;    // Rango de índices que procesará el hilo
+    SorShared* shared;
+} SorThreadData;
+
+// Actualiza en el propio u los puntos de [start, end) con la paridad del color (0: impares,
+// 1: pares). Se recorre con un índice comprimido para que el bucle sea vectorizable.
+static double sor_color(int color, int start, int end, double* u, const double* f, double h2, double omega, int measure) {
+    int first = start + (start - 1 + color) % 2;
+    int count = (end - first + 1) / 2;
+    double sum = 0.0;
+
+    if (measure) {
+        for (int j = 0; j < count; ++j) {
+            int i = first + 2 * j;
+            double d = omega * ((u[i-1] + u[i+1] + h2 * f[i]) / 2 - u[i]);
+            sum += d * d;
+            u[i] += d;
+        }
+    } else {
+        for (int j = 0; j < count; ++j) {
+            int i = first + 2 * j;
+            u[i] += omega * ((u[i-1] + u[i+1] + h2 * f[i]) / 2 - u[i]);
+        }
+    }
+    return sum;
+}
+
+// Función que ejecuta cada hilo durante todos los barridos de SOR. Los hilos se crean una
+// sola vez y se sincronizan con la barrera después de cada color.
+void* sor_thread(void* arg) {
+    SorThreadData* data = (SorThreadData*)arg;
+    SorShared* s = data->shared;
+    int since_check = 0;
+
+    for (int sweep = 0; sweep < s->nsweeps; ++sweep) {
+        int measure = 0;
+        if (s->tol > 0 && ++since_check >= s->cada) {
+            measure = 1;
+            since_check = 0;
+        }
+
+        double sum = sor_color(0, data->start, data->end, s->u, s->f, s->h2, s->omega, measure); // Rojos
+        pthread_barrier_wait(&barrier);
+        sum += sor_color(1, data->start, data->end, s->u, s->f, s->h2, s->omega, measure);       // Negros
+
+        if (measure) {
+            s->sums[data->id] = sum;
+            // Un único hilo reduce las sumas parciales y decide si se detiene
+            if (pthread_barrier_wait(&barrier) == PTHREAD_BARRIER_SERIAL_THREAD) {
+                double total = 0.0;
+                for (int t = 0; t < s->num_threads; ++t)
+                    total += s->sums[t];
+                s->residual = (2.0 / (s->omega * s->h2)) * sqrt(s->h * total);
+                if (s->residual < s->tol) {
+                    s->stop = 1;
+                    s->sweeps = sweep + 1;
+                }
+            }
+        }
+        pthread_barrier_wait(&barrier);
+        if (s->stop)
+            break;
+    }
+    return NULL;
+}
+
+// Método SOR con ordenamiento rojo-negro sobre el propio u (sin arreglo temporal) y con el
+// omega óptimo 2 / (1 + sin(pi h)) del Laplaciano 1D. Mismo criterio de parada que jacobi.
+int sor_red_black(int nsweeps, int n, int num_threads, double* u, double* f, double tol, int cada, double* residual) {
+    int i;
+    double h = 1.0 / n;
+    SorShared shared;
+    pthread_t threads[num_threads];
+    SorThreadData thread_data[num_threads];
+    int chunk_size = n / num_threads;
+
+    shared.num_threads = num_threads;
+    shared.nsweeps = nsweeps;
+    shared.cada = cada;
+    shared.h = h;
+    shared.h2 = h * h;
+    shared.omega = 2.0 / (1.0 + sin(acos(-1.0) * h));
+    shared.tol = tol;
+    shared.u = u;
+    shared.f = f;
+    shared.sums = (double*)calloc(num_threads, sizeof(double));
+    shared.stop = 0;
+    shared.sweeps = nsweeps;
+    shared.residual = *residual;
+
+    pthread_barrier_init(&barrier, NULL, num_threads);
+    for (i = 0; i < num_threads; i++) {
+        thread_data[i].id = i;
+        thread_data[i].start = 1 + i * chunk_size;
+        thread_data[i].end = (i == num_threads - 1) ? n : 1 + (i + 1) * chunk_size;
+        thread_data[i].shared = &shared;
+        pthread_create(&threads[i], NULL, sor_thread, &thread_data[i]);
+    }
+    for (i = 0; i < num_threads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    pthread_barrier_destroy(&barrier);
+
+    *residual = shared.residual;
+    free(shared.sums);
+    return shared.sweeps;
+}
+
+// Estado compartido por los hilos de Jacobi acelerado con Chebyshev
+typedef struct {
+    int num_threads, nsweeps, cada;
+    double h, h2, tol;
+    double gamma, sigma2;  // Parámetros de la recurrencia, derivados de [alpha, beta]
+    double* u;
+    double* utmp;
+    double* f;
+    double* sums;      // Suma parcial del residuo de cada hilo
+    int stop;          // Lo activa el hilo que reduce al alcanzar la tolerancia
+    int sweeps;        // Barridos realizados
+    double residual;   // Última norma medida
+} ChebyshevShared;
+
+// Datos de cada hilo de Chebyshev
+typedef struct {
+    int id;
+    int start, end;    // Rango de índices que procesará el hilo
+    ChebyshevShared* shared;
+} ChebyshevThreadData;
+
+// Función que ejecuta cada hilo durante todos los barridos de Chebyshev. Cada hilo lleva su
+// propia copia de omega y de los punteros a u_k y u_{k-1}: todos siguen la misma secuencia,
+// así que basta la barrera de cada barrido, igual que en jacobi.
+void* chebyshev_thread(void* arg) {
+    ChebyshevThreadData* data = (ChebyshevThreadData*)arg;
+    ChebyshevShared* s = data->shared;
+    int since_check = 0;
+    double omega = 1.0;
+    double* cur = s->u;
+    double* prev = s->utmp;
+
+    for (int sweep = 0; sweep < s->nsweeps; ++sweep) {
+        int measure = 0;
+        if (s->tol > 0 && ++since_check >= s->cada) {
+            measure = 1;
+            since_check = 0;
+        }
+
+        double sum = 0.0;
+        for (int i = data->start; i < data->end; ++i) {
+            double d = (cur[i-1] + cur[i+1] + s->h2 * s->f[i]) / 2 - cur[i];
+            if (measure)
+                sum += d * d;
+            prev[i] = omega * (cur[i] + s->gamma * d - prev[i]) + prev[i];
+        }
+
+        if (measure) {
+            s->sums[data->id] = sum;
+            // Un único hilo reduce las sumas parciales y decide si se detiene
+            if (pthread_barrier_wait(&barrier) == PTHREAD_BARRIER_SERIAL_THREAD) {
+                double total = 0.0;
+                for (int t = 0; t < s->num_threads; ++t)
+                    total += s->sums[t];
+                s->residual = (2.0 / s->h2) * sqrt(s->h * total);
+                if (s->residual < s->tol) {
+                    s->stop = 1;
+                    s->sweeps = sweep + 1;
+                }
+            }
+        }
+        pthread_barrier_wait(&barrier);
+
+        double* tmp = cur;
+        cur = prev;
+        prev = tmp;
+        omega = (sweep == 0) ? 1.0 / (1.0 - s->sigma2 / 2) : 1.0 / (1.0 - s->sigma2 * omega / 4);
+        if (s->stop)
+            break;
+    }
+    return NULL;
+}
+
+// Jacobi acelerado con Chebyshev sobre el intervalo [alpha, beta] (ver JacobiSequencial.c):
+//     u_{k+1} = omega_{k+1} (gamma J(u_k) + (1 - gamma) u_k - u_{k-1}) + u_{k-1}.
+// u_{k+1} se escribe encima de u_{k-1}, así que usa los mismos arreglos que jacobi y la
+// misma barrera por barrido, sin reducciones fuera de las mediciones del residuo. Mismo
+// criterio de parada que jacobi.
+int jacobi_chebyshev(int nsweeps, int n, int num_threads, double* u, double* f, double alpha, double beta,
+                     double tol, int cada, double* residual) {
+    int i;
+    double h = 1.0 / n;
+    ChebyshevShared shared;
+    pthread_t threads[num_threads];
+    ChebyshevThreadData thread_data[num_threads];
+    int chunk_size = n / num_threads;
+
+    shared.num_threads = num_threads;
+    shared.nsweeps = nsweeps;
+    shared.cada = cada;
+    shared.h = h;
+    shared.h2 = h * h;
+    shared.tol = tol;
+    shared.gamma = 2.0 / (2.0 - alpha - beta);
+    shared.sigma2 = (beta - alpha) * shared.gamma / 2;
+    shared.sigma2 *= shared.sigma2;
+    shared.u = u;
+    shared.utmp = (double*)malloc((n + 1) * sizeof(double));
+    shared.f = f;
+    shared.sums = (double*)calloc(num_threads, sizeof(double));
+    shared.stop = 0;
+    shared.sweeps = nsweeps;
+    shared.residual = *residual;
+    memcpy(shared.utmp, u, (n + 1) * sizeof(double)); // u_{-1} = u_0
+
+    pthread_barrier_init(&barrier, NULL, num_threads);
+    for (i = 0; i < num_threads; i++) {
+        thread_data[i].id = i;
+        thread_data[i].start = 1 + i * chunk_size;
+        thread_data[i].end = (i == num_threads - 1) ? n : 1 + (i + 1) * chunk_size;
+        thread_data[i].shared = &shared;
+        pthread_create(&threads[i], NULL, chebyshev_thread, &thread_data[i]);
+    }
+    for (i = 0; i < num_threads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    pthread_barrier_destroy(&barrier);
+
+    // Tras un número impar de barridos la solución quedó en el arreglo temporal
+    if (shared.sweeps % 2 == 1)
+        memcpy(u + 1, shared.utmp + 1, (n - 1) * sizeof(double));
+
+    *residual = shared.residual;
+    free(shared.sums);
+    free(shared.utmp);
+    return shared.sweeps;
+}
+
+// Datos compartidos por los hilos del resolvedor tridiagonal particionado. Los puntos 1..n-1
+// se reparten en bloques contiguos; el último punto de cada bloque salvo el final es un
+// separador y el resto forma el interior del bloque.
+typedef struct {
+    int n, nrhs, num_blocks;
+    double h2;
+    double* u;          // nrhs vectores de n + 1 elementos seguidos
+    double* f;
+    double* c;          // Factorización de Thomas de la matriz (-1, 2, -1)
+    int* first;         // Primer punto de cada bloque; first[num_blocks] = n + 1
+    double* sep_sub;    // Sistema tridiagonal de los separadores, ya factorizado
+    double* sep_c;
+    double* sep_den;
+} TridiagShared;
+
+typedef struct {
+    int id;
+    TridiagShared* shared;
+} TridiagThreadData;
+
+// Thomas sobre el interior [a, b] con valores de frontera left y right, usando la
+// factorización c de la matriz (-1, 2, -1), que no depende del tamaño del bloque
+static void thomas_block(int a, int b, double left, double right, const double* c, double h2, double* u, const double* f) {
+    double prev = left;
+    for (int i = a; i <= b; ++i) {
+        u[i] = (h2 * f[i] + prev) * -c[i - a + 1];
+        prev = u[i];
+    }
+    double next = right;
+    for (int i = b; i >= a; --i) {
+        u[i] -= c[i - a + 1] * next;
+        next = u[i];
+    }
+}
+
+// Último punto del interior del bloque p
+static int block_end(const TridiagShared* s, int p) {
+    return (p == s->num_blocks - 1) ? s->n - 1 : s->first[p + 1] - 2;
+}
+
+// Cada hilo resuelve su bloque con separadores nulos, luego los hilos resuelven el sistema
+// de separadores de un subconjunto de los lados derechos y por último cada hilo corrige su
+// bloque con las respuestas lineales a los separadores (soluciones exactas de la matriz
+// (-1, 2, -1) con una frontera unitaria)
+void* tridiag_thread(void* arg) {
+    TridiagThreadData* data = (TridiagThreadData*)arg;
+    TridiagShared* s = data->shared;
+    int p = data->id, P = s->num_blocks, n = s->n;
+    int a = s->first[p], b = block_end(s, p);
+    double m1 = b - a + 2; // Tamaño del interior más uno
+
+    for (int k = 0; k < s->nrhs; ++k) {
+        double* uk = s->u + (size_t)k * (n + 1);
+        double* fk = s->f + (size_t)k * (n + 1);
+        thomas_block(a, b, (p == 0) ? uk[0] : 0.0, (p == P - 1) ? uk[n] : 0.0, s->c, s->h2, uk, fk);
+    }
+    pthread_barrier_wait(&barrier);
+
+    for (int k = p; k < s->nrhs; k += P) {
+        double* uk = s->u + (size_t)k * (n + 1);
+        double* fk = s->f + (size_t)k * (n + 1);
+        double prev = 0.0;
+
+        // Lado derecho del separador q y sustitución hacia adelante
+        for (int q = 0; q < P - 1; ++q) {
+            int sep = s->first[q + 1] - 1;
+            double r = s->h2 * fk[sep] + uk[sep - 1] + uk[sep + 1];
+            uk[sep] = (r - s->sep_sub[q] * prev) / s->sep_den[q];
+            prev = uk[sep];
+        }
+        for (int q = P - 3; q >= 0; --q)
+            uk[s->first[q + 1] - 1] -= s->sep_c[q] * uk[s->first[q + 2] - 1];
+    }
+    pthread_barrier_wait(&barrier);
+
+    for (int k = 0; k < s->nrhs; ++k) {
+        double* uk = s->u + (size_t)k * (n + 1);
+        double left = (p == 0) ? 0.0 : uk[a - 1];
+        double right = (p == P - 1) ? 0.0 : uk[b + 1];
+        for (int i = a; i <= b; ++i) {
+            int j = i - a + 1;
+            uk[i] += (left * (m1 - j) + right * j) / m1;
+        }
+    }
+    return NULL;
+}
+
+// Resuelve de forma exacta el sistema tridiagonal de jacobi para nrhs lados derechos seguidos
+// con un método particionado: cada hilo resuelve su bloque por Thomas y los bloques se acoplan
+// con un sistema tridiagonal de num_threads - 1 separadores
+void thomas_partitioned(int n, int nrhs, int num_threads, double* u, double* f) {
+    int P = num_threads, i;
+    double h = 1.0 / n;
+    TridiagShared shared;
+
+    // Cada bloque necesita al menos un separador y un punto interior
+    if (P > (n - 1) / 2)
+        P = (n - 1) / 2;
+    if (P < 1)
+        P = 1;
+
+    pthread_t threads[P];
+    TridiagThreadData thread_data[P];
+
+    shared.n = n;
+    shared.nrhs = nrhs;
+    shared.num_blocks = P;
+    shared.h2 = h * h;
+    shared.u = u;
+    shared.f = f;
+    shared.c = (double*)malloc((n + 1) * sizeof(double));
+    shared.first = (int*)malloc((P + 1) * sizeof(int));
+    shared.sep_sub = (double*)malloc(P * sizeof(double));
+    shared.sep_c = (double*)malloc(P * sizeof(double));
+    shared.sep_den = (double*)malloc(P * sizeof(double));
+
+    shared.c[0] = 0.0;
+    for (i = 1; i < n; ++i)
+        shared.c[i] = -1.0 / (2.0 + shared.c[i - 1]);
+    for (i = 0; i <= P; ++i)
+        shared.first[i] = 1 + (int)((long)i * (n - 1) / P);
+
+    // Sistema de separadores: sub * s[q-1] + diag * s[q] + sup * s[q+1] = rhs, con
+    // mq el interior del bloque q; se factoriza una vez para todos los lados derechos
+    for (int q = 0; q < P - 1; ++q) {
+        double ml = block_end(&shared, q) - shared.first[q] + 2;
+        double mr = block_end(&shared, q + 1) - shared.first[q + 1] + 2;
+        double sub = (q == 0) ? 0.0 : -1.0 / ml;
+        double diag = 2.0 - (ml - 1) / ml - (mr - 1) / mr;
+        double sup = -1.0 / mr;
+        shared.sep_sub[q] = sub;
+        shared.sep_den[q] = diag - ((q == 0) ? 0.0 : sub * shared.sep_c[q - 1]);
+        shared.sep_c[q] = sup / shared.sep_den[q];
+    }
+
+    pthread_barrier_init(&barrier, NULL, P);
+    for (i = 0; i < P; i++) {
+        thread_data[i].id = i;
+        thread_data[i].shared = &shared;
+        pthread_create(&threads[i], NULL, tridiag_thread, &thread_data[i]);
+    }
+    for (i = 0; i < P; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    pthread_barrier_destroy(&barrier);
+
+    free(shared.c);
+    free(shared.first);
+    free(shared.sep_sub);
+    free(shared.sep_c);
+    free(shared.sep_den);
 }
 
 int main(int argc, char** argv) {
-    int i, n, nsteps, num_threads;
+    int i, n, nsteps, num_threads, sweeps = 0;
+    const char* method = "jacobi"; // Método de solución: jacobi, chebyshev, sor o thomas
+    const char* spectrum = "analitico"; // Cotas del espectro para chebyshev: analitico o lanczos
+    int nrhs = 1;           // Número de lados derechos (sólo thomas resuelve más de uno)
+    double tol = 0.0;       // Tolerancia del residuo (0 = sin criterio de parada)
+    int cada = 10;          // Barridos entre mediciones del residuo
+    double residual = -1.0;
+    const char* ckpt_name = NULL; // Archivo de checkpoint de jacobi (si se proporciona)
+    int ckpt_every = CHECKPOINT_EVERY;
+    int restart = 0;        // Reanudar desde el último checkpoint válido
+    const char* sync = "barrera"; // Sincronización de jacobi: barrera o vecinos
+    int base = 0;           // Barridos ya hechos según el checkpoint
+    Checkpoint* ckpt = NULL;
+    char* args[3] = {NULL, NULL, NULL};
+    int nargs = 0;
     double* u;
     double* f;
     double h;
     struct timespec start, end;
 
-    // Leer los parmetros de entrada o usar valores por defecto
-    n = (argc > 1) ? atoi(argv[1]) : DEFAULT_N;
-    nsteps = (argc > 2) ? atoi(argv[2]) : DEFAULT_NSTEPS;
-    num_threads = (argc > 3) ? atoi(argv[3]) : DEFAULT_THREADS;
+    // Separar las opciones (--metodo <jacobi|chebyshev|sor|thomas>, --espectro
+    // <analitico|lanczos>, --sincronizacion <barrera|vecinos>, --rhs <m>, --tol <valor>,
+    // --cada <k>, --checkpoint <archivo>, --checkpoint-cada <k>, --restart) de los argumentos
+    // posicionales
+    for (i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--metodo") == 0 && i + 1 < argc)
+            method = argv[++i];
+        else if (strcmp(argv[i], "--espectro") == 0 && i + 1 < argc)
+            spectrum = argv[++i];
+        else if (strcmp(argv[i], "--sincronizacion") == 0 && i + 1 < argc)
+            sync = argv[++i];
+        else if (strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc)
+            ckpt_name = argv[++i];
+        else if (strcmp(argv[i], "--checkpoint-cada") == 0 && i + 1 < argc)
+            ckpt_every = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--restart") == 0)
+            restart = 1;
+        else if (strcmp(argv[i], "--rhs") == 0 && i + 1 < argc)
+            nrhs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--tol") == 0 && i + 1 < argc)
+            tol = atof(argv[++i]);
+        else if (strcmp(argv[i], "--cada") == 0 && i + 1 < argc)
+            cada = atoi(argv[++i]);
+        else if (nargs < 3)
+            args[nargs++] = argv[i];
+    }
+
+    // Leer los parámetros de entrada o usar valores por defecto
+    n = (nargs > 0) ? atoi(args[0]) : DEFAULT_N;
+    nsteps = (nargs > 1) ? atoi(args[1]) : DEFAULT_NSTEPS;
+    num_threads = (nargs > 2) ? atoi(args[2]) : DEFAULT_THREADS;
     h = 1.0 / n;
 
-    // Reservar memoria para los arreglos
-    u = (double*)malloc((n + 1) * sizeof(double));
-    f = (double*)malloc((n + 1) * sizeof(double));
-    memset(u, 0, (n + 1) * sizeof(double)); // Inicializar el arreglo u con ceros
-    for (i = 0; i <= n; ++i)
-        f[i] = i * h; // Inicializacin del arreglo de trminos fuente
+    // Reservar memoria para los arreglos (nrhs pares seguidos)
+    u = (double*)malloc((size_t)nrhs * (n + 1) * sizeof(double));
+    f = (double*)malloc((size_t)nrhs * (n + 1) * sizeof(double));
+    memset(u, 0, (size_t)nrhs * (n + 1) * sizeof(double)); // Inicializar el arreglo u con ceros
+    for (int k = 0; k < nrhs; ++k)
+        for (i = 0; i <= n; ++i)
+            f[(size_t)k * (n + 1) + i] = (k + 1) * i * h; // Términos fuente, escalados por k + 1
+
+    // El checkpoint sólo se usa con jacobi sincronizado con barrera; al reanudar, u parte del
+    // estado guardado
+    int neighbors = strcmp(sync, "vecinos") == 0;
+    if (ckpt_name && strcmp(method, "jacobi") == 0 && !neighbors) {
+        ckpt = checkpoint_open(ckpt_name, n, nsteps, tol, ckpt_every, restart);
+        if (ckpt && restart) {
+            base = checkpoint_restore(ckpt, u);
+            if (base < 0) {
+                printf("No valid checkpoint in %s, starting from scratch\n", ckpt_name);
+                base = 0;
+            } else {
+                printf("Resuming from sweep %d\n", base);
+            }
+        }
+    }
 
-    // Medir el tiempo de ejecucin
+    // Medir el tiempo de ejecución
     clock_gettime(CLOCK_MONOTONIC, &start);
-    jacobi(nsteps, n, num_threads, u, f);
+    if (strcmp(method, "thomas") == 0)
+        thomas_partitioned(n, nrhs, num_threads, u, f);
+    else if (strcmp(method, "sor") == 0)
+        sweeps = sor_red_black(nsteps, n, num_threads, u, f, tol, cada, &residual);
+    else if (strcmp(method, "chebyshev") == 0) {
+        double alpha, beta;
+        spectral_bounds(n, strcmp(spectrum, "lanczos") == 0, &alpha, &beta);
+        printf("Spectral bounds of the Jacobi iteration: [%.12f, %.12f] (%s)\n", alpha, beta, spectrum);
+        sweeps = jacobi_chebyshev(nsteps, n, num_threads, u, f, alpha, beta, tol, cada, &residual);
+    }
+    else if (neighbors)
+        sweeps = jacobi_neighbors(nsteps, n, num_threads, u, f, tol, cada, &residual);
+    else
+        sweeps = base + jacobi(nsteps - base, n, num_threads, u, f, tol, cada, ckpt, &residual);
     clock_gettime(CLOCK_MONOTONIC, &end);
 
-    // Calcular y mostrar el tiempo de ejecucin
+    // Un método que no pudo reservar sus arreglos devuelve -1
+    if (sweeps < 0) {
+        if (ckpt)
+            checkpoint_close(ckpt);
+        free(f);
+        free(u);
+        return 1;
+    }
+
+    // Calcular y mostrar el tiempo de ejecución
     double executionTime = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
     printf("\nExecution time: %f seconds\n", executionTime);
+    if (strcmp(method, "thomas") == 0)
+        printf("Right-hand sides solved: %d\n", nrhs);
+    else if (tol > 0)
+        printf("Sweeps: %d, final residual: %e\n", sweeps, residual);
+
+    if (ckpt)
+        checkpoint_close(ckpt);
 
     // Liberar la memoria utilizada
     free(f);
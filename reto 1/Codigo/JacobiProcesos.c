@@ -1,160 +1,254 @@
-#define _POSIX_C_SOURCE 199309L
+#define _POSIX_C_SOURCE 200112L
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <math.h>
 #include <pthread.h>
 #include <time.h>
-
-// Estructura para representar una matriz
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include "spectrum.h"
+
+// Definimos valores por defecto para el tamaño del problema, número de iteraciones y número de procesos
+#define DEFAULT_N 100000
+#define DEFAULT_NSTEPS 1000
+#define DEFAULT_PROCESSES 4
+
+// Estado compartido por todos los procesos. Vive al principio de una única región
+// MAP_SHARED | MAP_ANONYMOUS creada antes de fork, seguida de los arreglos u, utmp, f y de
+// las sumas parciales del residuo, así que los hijos la heredan en la misma dirección.
 typedef struct {
-    size_t matrixSize; // Dimensin de la matriz (n x n)
-    int* matrixData;   // Puntero a los datos de la matriz almacenados en un array 1D
-} Matrix;
+    pthread_barrier_t barrier;  // Barrera con atributo PTHREAD_PROCESS_SHARED
+    int num_processes, nsweeps, cada;
+    double h, h2, tol;
+    int chebyshev;      // 1: Jacobi acelerado con Chebyshev
+    double gamma, sigma2; // Parámetros de la recurrencia de Chebyshev
+    double* u;
+    double* utmp;
+    double* f;
+    double* sums;       // Suma parcial del residuo de cada proceso
+    int stop;           // Lo activa el proceso que reduce al alcanzar la tolerancia
+    int sweeps;         // Barridos realizados
+    double residual;    // Última norma medida
+} SharedState;
+
+// Trabajo de cada proceso: actualiza los puntos [start, end) en cada barrido, alternando
+// entre u -> utmp y utmp -> u, con una barrera entre medios barridos. Si toca medir, el
+// proceso que sale de la barrera como PTHREAD_BARRIER_SERIAL_THREAD reduce el residuo.
+// Con Chebyshev la alternancia es la misma: u_{k+1} se escribe encima de u_{k-1}, que es el
+// arreglo de destino, y cada proceso lleva su propia copia de omega.
+void worker(SharedState* s, int id, int start, int end) {
+    int since_check = 0;
+    double omega = 1.0;
+    double* src = s->u;
+    double* dst = s->utmp;
+
+    for (int sweep = 0; sweep < s->nsweeps; ++sweep) {
+        int measure = 0;
+        if (s->tol > 0 && ++since_check >= s->cada) {
+            measure = 1;
+            since_check = 0;
+        }
 
-// Estructura para los argumentos de los hilos
-typedef struct {
-    Matrix* matrixA;
-    Matrix* matrixB;
-    Matrix* resultMatrix;
-    size_t startRow;  // Fila inicial asignada al hilo
-    size_t endRow;    // Fila final asignada al hilo
-} ThreadData;
-
-// Funcin para crear una matriz
-dMatrix* create_matrix(size_t matrixSize, int fillWithRandom) {
-    Matrix* matrix = (Matrix*) malloc(sizeof(Matrix));
-    matrix->matrixData = (int*) malloc(sizeof(int) * matrixSize * matrixSize);
-    matrix->matrixSize = matrixSize;
-
-    // Llenar la matriz con valores aleatorios si se indica
-    if (fillWithRandom) {
-        for (size_t i = 0; i < matrixSize * matrixSize; i++) {
-            matrix->matrixData[i] = rand() % 100; // Valores entre 0 y 99
+        if (s->chebyshev) {
+            double sum = 0.0;
+            for (int i = start; i < end; ++i) {
+                double d = (src[i - 1] + src[i + 1] + s->h2 * s->f[i]) / 2 - src[i];
+                if (measure)
+                    sum += d * d;
+                dst[i] = omega * (src[i] + s->gamma * d - dst[i]) + dst[i];
+            }
+            if (measure)
+                s->sums[id] = sum;
+            omega = (sweep == 0) ? 1.0 / (1.0 - s->sigma2 / 2) : 1.0 / (1.0 - s->sigma2 * omega / 4);
+        } else if (measure) {
+            // Barrido fusionado con la suma parcial del residuo del proceso
+            double sum = 0.0;
+            for (int i = start; i < end; ++i) {
+                double next = (src[i - 1] + src[i + 1] + s->h2 * s->f[i]) / 2;
+                double d = next - src[i];
+                sum += d * d;
+                dst[i] = next;
+            }
+            s->sums[id] = sum;
+        } else {
+            for (int i = start; i < end; ++i)
+                dst[i] = (src[i - 1] + src[i + 1] + s->h2 * s->f[i]) / 2;
         }
-    }
-    return matrix;
-}
 
-// Funcin para imprimir una matriz
-void print_matrix(Matrix* matrix) {
-    for (size_t i = 0; i < matrix->matrixSize; i++) {
-        for (size_t j = 0; j < matrix->matrixSize; j++) {
-            printf("%d ", matrix->matrixData[i * matrix->matrixSize + j]);
+        double* tmp = src;
+        src = dst;
+        dst = tmp;
+
+        // Fin del medio barrido: todos los puntos de src están al día
+        if (pthread_barrier_wait(&s->barrier) == PTHREAD_BARRIER_SERIAL_THREAD && measure) {
+            double total = 0.0;
+            for (int p = 0; p < s->num_processes; ++p)
+                total += s->sums[p];
+            s->residual = (2.0 / s->h2) * sqrt(s->h * total);
+            if (s->residual < s->tol) {
+                s->stop = 1;
+                s->sweeps = sweep + 1;
+            }
+        }
+        if (measure) {
+            // Todos deben ver la decisión antes de seguir
+            pthread_barrier_wait(&s->barrier);
+            if (s->stop)
+                break;
         }
-        printf("\n");
     }
 }
 
-// Funcin que ejecutar cada hilo para multiplicar una parte de la matriz
-void* multiply_matrices_thread(void* arg) {
-    ThreadData* data = (ThreadData*) arg;
-    size_t size = data->matrixA->matrixSize;
-
-    // Multiplicacin de matrices por filas asignadas a este hilo
-    for (size_t i = data->startRow; i < data->endRow; i++) {
-        for (size_t j = 0; j < size; j++) {
-            data->resultMatrix->matrixData[i * size + j] = 0; // Inicializa el valor
-            for (size_t k = 0; k < size; k++) {
-                data->resultMatrix->matrixData[i * size + j] += 
-                    data->matrixA->matrixData[i * size + k] * data->matrixB->matrixData[k * size + j];
+// Método de Jacobi con un grupo de procesos creados una sola vez. El proceso principal
+// trabaja como proceso 0 y los demás son hijos creados con fork que terminan al acabar los
+// barridos. Si tol > 0, cada 'cada' barridos se mide el residuo y se detiene cuando la
+// norma es menor que tol. u, utmp y f deben estar en la región compartida.
+// Si alpha < beta, acelera con Chebyshev sobre el intervalo [alpha, beta] que contiene el
+// espectro de la matriz de iteración (ver JacobiSequencial.c):
+//     u_{k+1} = omega_{k+1} (gamma J(u_k) + (1 - gamma) u_k - u_{k-1}) + u_{k-1},
+// con las mismas barreras y sin reducciones fuera de las mediciones del residuo.
+// Devuelve el número de barridos realizados y deja en *residual la última norma medida.
+int jacobi(SharedState* s, int n, int num_processes, int nsweeps, double alpha, double beta, double tol, int cada,
+           double* residual) {
+    int chunk_size = (n - 1) / num_processes; // Puntos 1..n-1 repartidos en bloques contiguos
+    pthread_barrierattr_t attr;
+    pid_t pids[num_processes];
+
+    s->num_processes = num_processes;
+    s->nsweeps = nsweeps;
+    s->cada = cada;
+    s->h = 1.0 / n;
+    s->h2 = s->h * s->h;
+    s->tol = tol;
+    s->stop = 0;
+    s->sweeps = nsweeps;
+    s->residual = *residual;
+
+    s->chebyshev = alpha < beta;
+    s->gamma = 2.0 / (2.0 - alpha - beta);
+    s->sigma2 = (beta - alpha) * s->gamma / 2;
+    s->sigma2 *= s->sigma2;
+
+    // Condiciones de frontera también en el arreglo temporal; Chebyshev parte de u_{-1} = u_0
+    if (s->chebyshev)
+        memcpy(s->utmp, s->u, (n + 1) * sizeof(double));
+    s->utmp[0] = s->u[0];
+    s->utmp[n] = s->u[n];
+
+    pthread_barrierattr_init(&attr);
+    pthread_barrierattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_barrier_init(&s->barrier, &attr, num_processes);
+    pthread_barrierattr_destroy(&attr);
+
+    for (int p = 1; p < num_processes; ++p) {
+        pids[p] = fork();
+        if (pids[p] == 0) {
+            int end = (p == num_processes - 1) ? n : 1 + (p + 1) * chunk_size;
+            worker(s, p, 1 + p * chunk_size, end);
+            _exit(0);
+        }
+        if (pids[p] < 0) {
+            // Los hijos ya creados esperan en la barrera a un proceso que nunca llegará
+            perror("fork");
+            for (int q = 1; q < p; ++q) {
+                kill(pids[q], SIGKILL);
+                waitpid(pids[q], NULL, 0);
             }
+            exit(1);
         }
     }
-    return NULL;
-}
+    worker(s, 0, 1, (num_processes == 1) ? n : 1 + chunk_size);
 
-// Funcin para multiplicar dos matrices utilizando mltiples hilos
-Matrix* multiply_matrices(Matrix* matrixA, Matrix* matrixB, int numThreads) {
-    size_t size = matrixA->matrixSize;
-    Matrix* resultMatrix = create_matrix(size, 0);
-    
-    pthread_t threads[numThreads];
-    ThreadData threadData[numThreads];
-    size_t rowsPerThread = size / numThreads;
-    size_t remainingRows = size % numThreads; // Para manejar casos donde el tamao no sea divisible
-
-    for (int i = 0; i < numThreads; i++) {
-        threadData[i].matrixA = matrixA;
-        threadData[i].matrixB = matrixB;
-        threadData[i].resultMatrix = resultMatrix;
-        threadData[i].startRow = i * rowsPerThread;
-        threadData[i].endRow = (i + 1) * rowsPerThread;
-        
-        // Asigna las filas restantes al ltimo hilo
-        if (i == numThreads - 1) threadData[i].endRow += remainingRows;
-
-        // Crear el hilo
-        pthread_create(&threads[i], NULL, multiply_matrices_thread, &threadData[i]);
-    }
+    for (int p = 1; p < num_processes; ++p)
+        waitpid(pids[p], NULL, 0);
+    pthread_barrier_destroy(&s->barrier);
 
-    // Esperar a que todos los hilos terminen
-    for (int i = 0; i < numThreads; i++) {
-        pthread_join(threads[i], NULL);
-    }
+    // Tras un número impar de barridos la solución quedó en utmp
+    if (s->sweeps % 2 == 1)
+        memcpy(s->u + 1, s->utmp + 1, (n - 1) * sizeof(double));
 
-    return resultMatrix;
+    *residual = s->residual;
+    return s->sweeps;
 }
 
-// Funcin para liberar la memoria asignada a una matriz
-void delete_matrix(Matrix** matrix) {
-    if (matrix == NULL || *matrix == NULL) return;
-    free((*matrix)->matrixData);
-    free(*matrix);
-    *matrix = NULL;
-}
+int main(int argc, char** argv) {
+    int i, n, nsteps, num_processes, sweeps;
+    double tol = 0.0;       // Tolerancia del residuo (0 = sin criterio de parada)
+    int cada = 10;          // Barridos entre mediciones del residuo
+    double residual = -1.0;
+    const char* method = "jacobi";      // Método de solución: jacobi o chebyshev
+    const char* spectrum = "analitico"; // Cotas del espectro para chebyshev: analitico o lanczos
+    double alpha = 0.0, beta = 0.0;     // Con alpha = beta no se acelera
+    char* args[3] = {NULL, NULL, NULL};
+    int nargs = 0;
+    double h;
+    struct timespec start, end;
 
-int main(int argc, char* argv[]) {
-    // Validar los argumentos del programa
-    if (argc != 4) {
-        printf("Uso: %s <matrix_size> <num_threads> <show_matrices (0 o 1)>\n", argv[0]);
-        return 1;
+    // Separar las opciones (--metodo <jacobi|chebyshev>, --espectro <analitico|lanczos>,
+    // --tol <valor>, --cada <k>) de los argumentos posicionales
+    for (i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--metodo") == 0 && i + 1 < argc)
+            method = argv[++i];
+        else if (strcmp(argv[i], "--espectro") == 0 && i + 1 < argc)
+            spectrum = argv[++i];
+        else if (strcmp(argv[i], "--tol") == 0 && i + 1 < argc)
+            tol = atof(argv[++i]);
+        else if (strcmp(argv[i], "--cada") == 0 && i + 1 < argc)
+            cada = atoi(argv[++i]);
+        else if (nargs < 3)
+            args[nargs++] = argv[i];
     }
 
-    int matrixSize = atoi(argv[1]);
-    int numThreads = atoi(argv[2]);
-    int showMatrices = atoi(argv[3]);
+    // Leer los parámetros de entrada o usar valores por defecto
+    n = (nargs > 0) ? atoi(args[0]) : DEFAULT_N;
+    nsteps = (nargs > 1) ? atoi(args[1]) : DEFAULT_NSTEPS;
+    num_processes = (nargs > 2) ? atoi(args[2]) : DEFAULT_PROCESSES;
+    h = 1.0 / n;
 
-    if (matrixSize <= 0 || numThreads <= 0) {
-        printf("El tamao de la matriz y el nmero de hilos deben ser positivos.\n");
+    if (num_processes < 1 || n - 1 < num_processes) {
+        printf("El número de procesos debe estar entre 1 y n - 1.\n");
         return 1;
     }
 
-    srand(time(NULL));
-    
-    // Crear las matrices A y B con valores aleatorios
-    Matrix* matrixA = create_matrix(matrixSize, 1);
-    Matrix* matrixB = create_matrix(matrixSize, 1);
-
-    // Mostrar las matrices originales si se solicita
-    if (showMatrices) {
-        printf("Matriz A:\n");
-        print_matrix(matrixA);
-        printf("\nMatriz B:\n");
-        print_matrix(matrixB);
+    // Una sola región compartida: estado, u, utmp, f y sumas parciales
+    size_t header = (sizeof(SharedState) + 63) / 64 * 64;
+    size_t bytes = header + (3 * (size_t)(n + 1) + num_processes) * sizeof(double);
+    char* region = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED) {
+        perror("mmap");
+        return 1;
     }
-
-    struct timespec start, end;
-    clock_gettime(CLOCK_MONOTONIC, &start);
-
-    // Multiplicar las matrices
-    Matrix* resultMatrix = multiply_matrices(matrixA, matrixB, numThreads);
-    clock_gettime(CLOCK_MONOTONIC, &end); 
-
-    // Mostrar la matriz resultante si se solicita
-    if (showMatrices) {
-        printf("\nMatriz C (Resultado):\n");
-        print_matrix(resultMatrix);
+    SharedState* s = (SharedState*)region;
+    s->u = (double*)(region + header);
+    s->utmp = s->u + (n + 1);
+    s->f = s->utmp + (n + 1);
+    s->sums = s->f + (n + 1);
+
+    // La región anónima ya está en cero, así que u empieza en cero
+    for (i = 0; i <= n; ++i)
+        s->f[i] = i * h; // Términos fuente
+
+    if (strcmp(method, "chebyshev") == 0) {
+        spectral_bounds(n, strcmp(spectrum, "lanczos") == 0, &alpha, &beta);
+        printf("Cotas del espectro de la iteración de Jacobi: [%.12f, %.12f] (%s)\n", alpha, beta, spectrum);
     }
 
-    // Calcular y mostrar el tiempo de ejecucin
-    double executionTime = (end.tv_sec - start.tv_sec) + 
-                         (end.tv_nsec - start.tv_nsec) / 1e9;
-    printf("\nTiempo de ejecucin: %f segundos\n", executionTime);
+    // Medir el tiempo de ejecución
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    sweeps = jacobi(s, n, num_processes, nsteps, alpha, beta, tol, cada, &residual);
+    clock_gettime(CLOCK_MONOTONIC, &end);
 
-    // Liberar la memoria asignada a las matrices
-    delete_matrix(&matrixA);
-    delete_matrix(&matrixB);
-    delete_matrix(&resultMatrix);
+    // Calcular y mostrar el tiempo de ejecución
+    double executionTime = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("\nTiempo de ejecución: %f segundos\n", executionTime);
+    if (tol > 0)
+        printf("Barridos: %d, residuo final: %e\n", sweeps, residual);
 
+    munmap(region, bytes);
     return 0;
 }
-
@@ -1,88 +1,450 @@
-#define _POSIX_C_SOURCE 199309L
+#define _POSIX_C_SOURCE 200112L
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 #include <time.h>
+#include "checkpoint.h"
+#include "spectrum.h"
 
-// Funcin que implementa el mtodo de Jacobi para resolver ecuaciones diferenciales parciales (1D Poisson)
-void jacobi(int nsweeps, int n, double* u, double* f) {
+// Función que implementa el método de Jacobi para resolver ecuaciones diferenciales parciales (1D Poisson)
+// Si tol > 0, cada 'cada' barridos se mide la norma del residuo dentro de la propia segunda
+// pasada (sin recorrer de nuevo la memoria) y se detiene en cuanto es menor que tol.
+// Si ckpt no es NULL, tras cada par de barridos se le ofrece u para el checkpoint periódico.
+// Devuelve el número de barridos realizados y deja en *residuo la última norma medida.
+int jacobi(int nsweeps, int n, double* u, double* f, double tol, int cada, Checkpoint* ckpt, double* residuo) {
     int i, sweep;
-    double h  = 1.0 / n;       // Tamao de paso en el espacio
-    double h2 = h * h;         // Cuadrado del tamao de paso
+    int desde_chequeo = 0;     // Barridos realizados desde la última medición del residuo
+    double h  = 1.0 / n;       // Tamaño de paso en el espacio
+    double h2 = h * h;         // Cuadrado del tamaño de paso
     double* utmp = (double*) malloc((n + 1) * sizeof(double)); // Memoria para una copia temporal de u
 
-    // Condiciones de frontera: la primera y ltima posicin se mantienen constantes
+    // Condiciones de frontera: la primera y última posición se mantienen constantes
     utmp[0] = u[0];
     utmp[n] = u[n];
 
-    // Realiza nsweeps iteraciones del mtodo de Jacobi
+    // Realiza nsweeps iteraciones del método de Jacobi
     for (sweep = 0; sweep < nsweeps; sweep += 2) {
         // Primera pasada: calcula los nuevos valores en utmp usando los valores actuales de u
         for (i = 1; i < n; ++i)
             utmp[i] = (u[i - 1] + u[i + 1] + h2 * f[i]) / 2;
 
-        // Segunda pasada: actualiza u con los valores de utmp
-        for (i = 1; i < n; ++i)
-            u[i] = (utmp[i - 1] + utmp[i + 1] + h2 * f[i]) / 2;
+        desde_chequeo += 2;
+        if (tol > 0 && desde_chequeo >= cada) {
+            // Segunda pasada fusionada con el residuo: el cambio de utmp a u en cada punto
+            // es h2 / 2 veces el residuo de utmp, así que basta acumular su cuadrado
+            double suma = 0.0;
+            for (i = 1; i < n; ++i) {
+                double nuevo = (utmp[i - 1] + utmp[i + 1] + h2 * f[i]) / 2;
+                double d = nuevo - utmp[i];
+                suma += d * d;
+                u[i] = nuevo;
+            }
+            desde_chequeo = 0;
+
+            // Norma L2 discreta del residuo
+            *residuo = (2.0 / h2) * sqrt(h * suma);
+            if (*residuo < tol) {
+                sweep += 2;
+                break;
+            }
+        } else {
+            // Segunda pasada: actualiza u con los valores de utmp
+            for (i = 1; i < n; ++i)
+                u[i] = (utmp[i - 1] + utmp[i + 1] + h2 * f[i]) / 2;
+        }
+        checkpoint_save(ckpt, sweep + 2, u);
     }
 
     free(utmp); // Liberar memoria de la matriz temporal
+    return sweep;
+}
+
+// Jacobi en precisión mixta con refinamiento iterativo. Cada 'cada' barridos se calcula en
+// double el residuo r = h2 f - A u (A = tridiag(-1, 2, -1)) y su norma; luego se hacen
+// 'cada' barridos de Jacobi en float sobre A e = r partiendo de e = 0 y se corrige u += e en
+// double. Como Jacobi es una iteración lineal, esos barridos equivalen a continuar Jacobi
+// sobre u, pero mueven la mitad de bytes; el redondeo de float sólo afecta a la corrección,
+// que se vuelve a calcular desde el residuo exacto, así que se llega a precisión double.
+// Mismo criterio de parada (norma L2 discreta del residuo) y valor de retorno que jacobi.
+int jacobi_mixed(int nsweeps, int n, double* u, double* f, double tol, int cada, double* residuo) {
+    int i, sweep = 0;
+    double h = 1.0 / n;
+    double h2 = h * h;
+    float* r = (float*) malloc((n + 1) * sizeof(float));     // Residuo en float
+    float* e = (float*) calloc(n + 1, sizeof(float));        // Corrección (frontera en cero)
+    float* etmp = (float*) calloc(n + 1, sizeof(float));
+
+    if (cada < 1)
+        cada = 1;
+    while (1) {
+        // Residuo en double, fusionado con la corrección anterior: u[i+1] se corrige antes
+        // de usarlo, así que el residuo del punto i ya ve los tres valores nuevos
+        double sum = 0.0;
+        if (sweep > 0)
+            u[1] += e[1];
+        for (i = 1; i < n; ++i) {
+            if (sweep > 0 && i + 1 < n)
+                u[i + 1] += e[i + 1];
+            double ri = h2 * f[i] + u[i - 1] + u[i + 1] - 2.0 * u[i];
+            sum += ri * ri;
+            r[i] = (float) ri;
+        }
+        *residuo = (1.0 / h2) * sqrt(h * sum);
+        if ((tol > 0 && *residuo < tol) || sweep >= nsweeps)
+            break;
+
+        // Barridos en float sobre A e = r desde e = 0
+        int inner = (nsweeps - sweep < cada) ? nsweeps - sweep : cada;
+        memset(e, 0, (n + 1) * sizeof(float));
+        for (int k = 0; k < inner; ++k) {
+            for (i = 1; i < n; ++i)
+                etmp[i] = (e[i - 1] + e[i + 1] + r[i]) * 0.5f;
+            float* t = e;
+            e = etmp;
+            etmp = t;
+        }
+        sweep += inner;
+    }
+
+    free(r);
+    free(e);
+    free(etmp);
+    return sweep;
 }
 
-// Funcin para escribir la solucin en un archivo de salida
+// Actualiza en el propio u los puntos primero, primero + 2, ... < n con SOR. Se recorre con
+// el índice comprimido j para que cada color sea un bucle vectorizable sin dependencias.
+// Devuelve la suma de los cuadrados de los cambios si medir es 1.
+static double sor_color(int primero, int n, double* u, const double* f, double h2, double omega, int medir) {
+    int j, cuantos = (n + 1 - primero) / 2;
+    double suma = 0.0;
+
+    if (medir) {
+        for (j = 0; j < cuantos; ++j) {
+            int i = primero + 2 * j;
+            double d = omega * ((u[i - 1] + u[i + 1] + h2 * f[i]) / 2 - u[i]);
+            suma += d * d;
+            u[i] += d;
+        }
+    } else {
+        for (j = 0; j < cuantos; ++j) {
+            int i = primero + 2 * j;
+            u[i] += omega * ((u[i - 1] + u[i + 1] + h2 * f[i]) / 2 - u[i]);
+        }
+    }
+    return suma;
+}
+
+// Método SOR con ordenamiento rojo-negro: primero se actualizan los puntos impares (rojos),
+// que sólo dependen de puntos pares, y después los pares (negros) con los rojos ya nuevos.
+// Trabaja sobre u sin arreglo temporal y usa el omega óptimo para el Laplaciano 1D,
+// 2 / (1 + sin(pi h)), obtenido del radio espectral de Jacobi cos(pi h).
+// Mismo criterio de parada y valor de retorno que jacobi.
+int sor_red_black(int nsweeps, int n, double* u, double* f, double tol, int cada, double* residuo) {
+    int sweep;
+    int desde_chequeo = 0;
+    double h = 1.0 / n;
+    double h2 = h * h;
+    double omega = 2.0 / (1.0 + sin(acos(-1.0) * h));
+
+    for (sweep = 0; sweep < nsweeps; ++sweep) {
+        int medir = 0;
+        if (tol > 0 && ++desde_chequeo >= cada) {
+            medir = 1;
+            desde_chequeo = 0;
+        }
+
+        double suma = sor_color(1, n, u, f, h2, omega, medir);  // Rojos
+        suma += sor_color(2, n, u, f, h2, omega, medir);        // Negros
+
+        if (medir) {
+            // El cambio de cada punto es omega * h2 / 2 veces su residuo local
+            *residuo = (2.0 / (omega * h2)) * sqrt(h * suma);
+            if (*residuo < tol) {
+                ++sweep;
+                break;
+            }
+        }
+    }
+    return sweep;
+}
+
+// Jacobi acelerado con Chebyshev (semi-iteración de Golub y Varga sobre el intervalo
+// [alpha, beta] que contiene el espectro de la matriz de iteración): con J(u) el barrido de
+// Jacobi, gamma = 2 / (2 - alpha - beta) y sigma = (beta - alpha) / (2 - alpha - beta),
+//     u_{k+1} = omega_{k+1} (gamma J(u_k) + (1 - gamma) u_k - u_{k-1}) + u_{k-1},
+//     omega_1 = 1, omega_2 = 1 / (1 - sigma^2 / 2), omega_{k+1} = 1 / (1 - sigma^2 omega_k / 4).
+// Con alpha = -beta queda gamma = 1 y la forma clásica con sigma = rho.
+// Como u_{k+1} en el punto i sólo necesita u_{k-1} en el mismo punto, el nuevo valor se
+// escribe encima de u_{k-1}: usa los mismos tres arreglos que jacobi (u, el temporal y f) y
+// los mismos vecinos, sin productos internos. Baja los barridos de O(n^2) a O(n).
+// Como todos los modos se amortiguan al mismo ritmo lento, el redondeo de unos n barridos se
+// acumula y el residuo alcanzable crece con n (del orden de 1e-7 en n = 10^4 y de 3e-5 en
+// n = 10^5), muy por debajo de lo que jacobi llega a alcanzar en un tiempo razonable.
+// Mismo criterio de parada (el cambio J(u_k) - u_k da el residuo de u_k) y valor de retorno
+// que jacobi.
+int jacobi_chebyshev(int nsweeps, int n, double* u, double* f, double alpha, double beta, double tol,
+                     int cada, double* residuo) {
+    int i, sweep;
+    int desde_chequeo = 0;
+    double h = 1.0 / n;
+    double h2 = h * h;
+    double gamma = 2.0 / (2.0 - alpha - beta);
+    double sigma2 = (beta - alpha) * gamma / 2;
+    double omega = 1.0;
+    double* utmp = (double*) malloc((n + 1) * sizeof(double));
+    double* cur = u;       // u_k
+    double* prev = utmp;   // u_{k-1}, y luego u_{k+1}
+
+    sigma2 *= sigma2;
+    memcpy(utmp, u, (n + 1) * sizeof(double));
+    for (sweep = 0; sweep < nsweeps; ++sweep) {
+        int medir = 0;
+        if (tol > 0 && ++desde_chequeo >= cada) {
+            medir = 1;
+            desde_chequeo = 0;
+        }
+
+        double suma = 0.0;
+        if (medir) {
+            for (i = 1; i < n; ++i) {
+                double jac = (cur[i - 1] + cur[i + 1] + h2 * f[i]) / 2;
+                double d = jac - cur[i];
+                suma += d * d;
+                prev[i] = omega * (cur[i] + gamma * d - prev[i]) + prev[i];
+            }
+        } else {
+            for (i = 1; i < n; ++i) {
+                double d = (cur[i - 1] + cur[i + 1] + h2 * f[i]) / 2 - cur[i];
+                prev[i] = omega * (cur[i] + gamma * d - prev[i]) + prev[i];
+            }
+        }
+        double* t = cur;
+        cur = prev;
+        prev = t;
+        omega = (sweep == 0) ? 1.0 / (1.0 - sigma2 / 2) : 1.0 / (1.0 - sigma2 * omega / 4);
+
+        if (medir) {
+            // Residuo de u_k, el estado anterior a este barrido
+            *residuo = (2.0 / h2) * sqrt(h * suma);
+            if (*residuo < tol) {
+                ++sweep;
+                break;
+            }
+        }
+    }
+
+    if (cur != u)
+        memcpy(u + 1, cur + 1, (n - 1) * sizeof(double));
+    free(utmp);
+    return sweep;
+}
+
+// Resuelve de forma exacta el sistema tridiagonal sobre el que itera jacobi,
+// 2 u[i] - u[i-1] - u[i+1] = h2 f[i] para i = 1..n-1 con u[0] y u[n] fijos, por el algoritmo
+// de Thomas en O(n). Resuelve nrhs lados derechos guardados uno tras otro (u + k * (n + 1) y
+// f + k * (n + 1)); la factorización de la matriz se calcula una sola vez para todos.
+void thomas(int n, int nrhs, double* u, double* f) {
+    int i, k;
+    double h = 1.0 / n;
+    double h2 = h * h;
+    double* c = (double*) malloc((n + 1) * sizeof(double)); // Superdiagonal modificada
+
+    // Factorización: c[i] = -1 / (2 + c[i-1]); -c[i] es el inverso del pivote de la fila i
+    c[0] = 0.0;
+    for (i = 1; i < n; ++i)
+        c[i] = -1.0 / (2.0 + c[i - 1]);
+
+    for (k = 0; k < nrhs; ++k) {
+        double* uk = u + (size_t)k * (n + 1);
+        double* fk = f + (size_t)k * (n + 1);
+
+        // Eliminación hacia adelante; uk[0] hace de término de frontera de la primera fila
+        for (i = 1; i < n; ++i)
+            uk[i] = (h2 * fk[i] + uk[i - 1]) * -c[i];
+
+        // Sustitución hacia atrás; uk[n] aporta la frontera de la última fila
+        for (i = n - 1; i >= 1; --i)
+            uk[i] -= c[i] * uk[i + 1];
+    }
+
+    free(c);
+}
+
+// Función para escribir la solución en un archivo de salida
 void write_solution(int n, double* u, const char* fname) {
     int i;
-    double h = 1.0 / n; // Tamao de paso en el espacio
+    double h = 1.0 / n; // Tamaño de paso en el espacio
     FILE* fp = fopen(fname, "w+"); // Abre el archivo para escritura
     if (!fp) {
         printf("Error al abrir el archivo %s\n", fname);
         return;
     }
 
-    // Escribe los valores de la solucin en el archivo
+    // Escribe los valores de la solución en el archivo
     for (i = 0; i <= n; ++i)
         fprintf(fp, "%g %g\n", i * h, u[i]);
 
     fclose(fp); // Cierra el archivo
 }
 
+// Norma L2 discreta de f - A u / h2 calculada en double
+double residual_norm(int n, const double* u, const double* f) {
+    double h = 1.0 / n;
+    double h2 = h * h;
+    double sum = 0.0;
+    for (int i = 1; i < n; ++i) {
+        double ri = h2 * f[i] + u[i - 1] + u[i + 1] - 2.0 * u[i];
+        sum += ri * ri;
+    }
+    return (1.0 / h2) * sqrt(h * sum);
+}
+
+// Comparación de tiempo hasta la tolerancia: jacobi en double y jacobi_mixed, ambos desde
+// u = 0, con el residuo final recalculado en double para los dos
+void compare_precision(int n, int nsweeps, double* f, double tol, int cada) {
+    const char* names[2] = {"double", "mixed"};
+    double* u = (double*) malloc((n + 1) * sizeof(double));
+    struct timespec start, end;
+
+    printf("\n%-8s %12s %10s %14s\n", "mode", "time (s)", "sweeps", "residual");
+    for (int mode = 0; mode < 2; ++mode) {
+        double residuo = -1.0;
+        int sweeps;
+        memset(u, 0, (n + 1) * sizeof(double));
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        if (mode == 0)
+            sweeps = jacobi(nsweeps, n, u, f, tol, cada, NULL, &residuo);
+        else
+            sweeps = jacobi_mixed(nsweeps, n, u, f, tol, cada, &residuo);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double t = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+        printf("%-8s %12.6f %10d %14e\n", names[mode], t, sweeps, residual_norm(n, u, f));
+    }
+    free(u);
+}
+
 int main(int argc, char** argv) {
     int i;
     int n, nsteps;
-    double* u; // Vector solucin
-    double* f; // Vector del lado derecho de la ecuacin
+    int sweeps = 0;
+    const char* metodo = "jacobi"; // Método de solución: jacobi, chebyshev, mixto, sor o thomas
+    const char* espectro = "analitico"; // Cotas del espectro para chebyshev: analitico o lanczos
+    int nrhs = 1;       // Número de lados derechos (sólo thomas resuelve más de uno)
+    double tol = 0.0;   // Tolerancia del residuo (0 = sin criterio de parada)
+    int cada = 10;      // Barridos entre mediciones del residuo
+    double residuo = -1.0;
+    const char* ckpt_name = NULL; // Archivo de checkpoint de jacobi (si se proporciona)
+    int ckpt_every = CHECKPOINT_EVERY;
+    int restart = 0;    // Reanudar desde el último checkpoint válido
+    int base = 0;       // Barridos ya hechos según el checkpoint
+    int compare = 0;    // Comparar jacobi en double con el de precisión mixta
+    Checkpoint* ckpt = NULL;
+    char* args[3] = {NULL, NULL, NULL};
+    int nargs = 0;
+    double* u; // Vector solución
+    double* f; // Vector del lado derecho de la ecuación
     double h;
     struct timespec start, end;
     double executionTime;
     char* fname;
 
-    // Obtiene los valores de n y nsteps desde los argumentos de la lnea de comandos
-    n = (argc > 1) ? atoi(argv[1]) : 100; // Nmero de puntos en la malla
-    nsteps = (argc > 2) ? atoi(argv[2]) : 100; // Nmero de iteraciones
-    fname = (argc > 3) ? argv[3] : NULL; // Nombre del archivo de salida (si se proporciona)
-    h = 1.0 / n; // Tamao de paso
+    // Separa las opciones (--metodo <jacobi|chebyshev|mixto|sor|thomas>, --espectro
+    // <analitico|lanczos>, --rhs <m>, --tol <valor>, --cada <k>, --checkpoint <archivo>,
+    // --checkpoint-cada <k>, --restart, --comparar) de los argumentos posicionales
+    for (i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--metodo") == 0 && i + 1 < argc)
+            metodo = argv[++i];
+        else if (strcmp(argv[i], "--espectro") == 0 && i + 1 < argc)
+            espectro = argv[++i];
+        else if (strcmp(argv[i], "--comparar") == 0)
+            compare = 1;
+        else if (strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc)
+            ckpt_name = argv[++i];
+        else if (strcmp(argv[i], "--checkpoint-cada") == 0 && i + 1 < argc)
+            ckpt_every = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--restart") == 0)
+            restart = 1;
+        else if (strcmp(argv[i], "--rhs") == 0 && i + 1 < argc)
+            nrhs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--tol") == 0 && i + 1 < argc)
+            tol = atof(argv[++i]);
+        else if (strcmp(argv[i], "--cada") == 0 && i + 1 < argc)
+            cada = atoi(argv[++i]);
+        else if (nargs < 3)
+            args[nargs++] = argv[i];
+    }
+
+    // Obtiene los valores de n y nsteps desde los argumentos de la línea de comandos
+    n = (nargs > 0) ? atoi(args[0]) : 100; // Número de puntos en la malla
+    nsteps = (nargs > 1) ? atoi(args[1]) : 100; // Número de iteraciones
+    fname = (nargs > 2) ? args[2] : NULL; // Nombre del archivo de salida (si se proporciona)
+    h = 1.0 / n; // Tamaño de paso
 
-    // Asigna memoria para los vectores u y f
-    u = (double*) malloc((n + 1) * sizeof(double));
-    f = (double*) malloc((n + 1) * sizeof(double));
+    // Asigna memoria para los vectores u y f (nrhs pares seguidos)
+    u = (double*) malloc((size_t)nrhs * (n + 1) * sizeof(double));
+    f = (double*) malloc((size_t)nrhs * (n + 1) * sizeof(double));
 
     // Inicializa u con ceros
-    memset(u, 0, (n + 1) * sizeof(double));
+    memset(u, 0, (size_t)nrhs * (n + 1) * sizeof(double));
 
-    // Inicializa f con valores lineales (f[i] = i * h)
-    for (i = 0; i <= n; ++i)
-        f[i] = i * h;
+    // Inicializa f con valores lineales (f[i] = i * h, escalado por k + 1 en el lado derecho k)
+    for (int k = 0; k < nrhs; ++k)
+        for (i = 0; i <= n; ++i)
+            f[(size_t)k * (n + 1) + i] = (k + 1) * i * h;
 
-    // Mide el tiempo de ejecucin del mtodo de Jacobi
+    if (compare) {
+        compare_precision(n, nsteps, f, tol, cada);
+        free(f);
+        free(u);
+        return 0;
+    }
+
+    // El checkpoint sólo se usa con jacobi; al reanudar, u parte del estado guardado
+    if (ckpt_name && strcmp(metodo, "jacobi") == 0) {
+        ckpt = checkpoint_open(ckpt_name, n, nsteps, tol, ckpt_every, restart);
+        if (ckpt && restart) {
+            base = checkpoint_restore(ckpt, u);
+            if (base < 0) {
+                printf("No valid checkpoint in %s, starting from scratch\n", ckpt_name);
+                base = 0;
+            } else {
+                printf("Resuming from sweep %d\n", base);
+            }
+        }
+    }
+
+    // Mide el tiempo de ejecución del método elegido
     clock_gettime(CLOCK_MONOTONIC, &start);
-    jacobi(nsteps, n, u, f);
+    if (strcmp(metodo, "thomas") == 0)
+        thomas(n, nrhs, u, f);
+    else if (strcmp(metodo, "sor") == 0)
+        sweeps = sor_red_black(nsteps, n, u, f, tol, cada, &residuo);
+    else if (strcmp(metodo, "chebyshev") == 0) {
+        double alpha, beta;
+        spectral_bounds(n, strcmp(espectro, "lanczos") == 0, &alpha, &beta);
+        printf("Spectral bounds of the Jacobi iteration: [%.12f, %.12f] (%s)\n", alpha, beta, espectro);
+        sweeps = jacobi_chebyshev(nsteps, n, u, f, alpha, beta, tol, cada, &residuo);
+    }
+    else if (strcmp(metodo, "mixto") == 0)
+        sweeps = jacobi_mixed(nsteps, n, u, f, tol, cada, &residuo);
+    else
+        sweeps = base + jacobi(nsteps - base, n, u, f, tol, cada, ckpt, &residuo);
     clock_gettime(CLOCK_MONOTONIC, &end);
 
-    // Calcula el tiempo de ejecucin en segundos
+    // Calcula el tiempo de ejecución en segundos
     executionTime = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
     printf("\nExecution time: %f seconds\n", executionTime);
+    if (strcmp(metodo, "thomas") == 0)
+        printf("Right-hand sides solved: %d\n", nrhs);
+    else if (tol > 0)
+        printf("Sweeps: %d, final residual: %e\n", sweeps, residuo);
+
+    if (ckpt)
+        checkpoint_close(ckpt);
 
-    // Si se proporciona un nombre de archivo, guarda la solucin
+    // Si se proporciona un nombre de archivo, guarda la solución
     if (fname)
         write_solution(n, u, fname);
 
@@ -0,0 +1,207 @@
+// Checkpoint en un archivo proyectado en memoria, común a JacobiSequencial.c, JacobiHilos.c y
+// reto 2/jacobiOpenMp.cpp (enlazar con -pthread). El archivo tiene dos ranuras que se
+// alternan; cada una es una cabecera seguida de los n + 1 valores de u y empieza en un límite
+// de página para poder sincronizarla sola con msync. Un hilo escritor hace el msync, así que
+// los barridos sólo pagan la copia a la proyección. La cabecera lleva una suma de verificación
+// de los datos: una ranura a medio escribir no se usa al reanudar. También lleva los barridos
+// pedidos, la tolerancia y un identificador de la ejecución: al reanudar sólo se aceptan
+// ranuras de la misma configuración, y una ejecución nueva vacía el archivo para que no quede
+// una ranura de una ejecución anterior.
+// Requiere _POSIX_C_SOURCE >= 200112L (ftruncate).
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+
+#define CHECKPOINT_MAGIC 0x4a41434f42493032ULL // Identifica los archivos de checkpoint (versión 2)
+#define CHECKPOINT_DATA 64                      // Desplazamiento de los datos en la ranura
+#define CHECKPOINT_EVERY 1000                   // Barridos entre checkpoints por defecto
+
+typedef struct {
+    uint64_t magic;
+    int64_t n;
+    int64_t nsteps;     // Barridos pedidos por la ejecución
+    double tol;         // Tolerancia de la ejecución
+    uint64_t run;       // Identificador de la ejecución; se conserva al reanudar
+    int64_t sweep;      // Barridos completados cuando se guardó u
+    uint64_t checksum;  // FNV-1a de los valores de u
+} CheckpointHeader;
+
+typedef struct {
+    int fd, n;
+    int nsteps;
+    double tol;
+    uint64_t run;
+    int every;          // Barridos entre checkpoints
+    int base;           // Barrido desde el que se reanudó (0 si se empezó de cero)
+    int last;           // Último barrido guardado
+    int next_slot;      // Ranura que se escribirá a continuación
+    size_t slot_size;   // Bytes por ranura, múltiplo de la página
+    char* map;
+    pthread_t writer;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int pending;        // Ranura que el escritor debe sincronizar (-1 si ninguna)
+    int busy;           // El escritor está en msync
+    int done;           // Pide al escritor que termine
+} Checkpoint;
+
+// FNV-1a sobre palabras de 64 bits
+static inline uint64_t checkpoint_checksum(const double* v, size_t count) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t w;
+        memcpy(&w, &v[i], sizeof(w));
+        hash = (hash ^ w) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+// Hilo escritor: sincroniza con el disco cada ranura que le entrega checkpoint_save
+static inline void* checkpoint_writer(void* arg) {
+    Checkpoint* c = (Checkpoint*)arg;
+    pthread_mutex_lock(&c->lock);
+    while (1) {
+        while (c->pending < 0 && !c->done)
+            pthread_cond_wait(&c->cond, &c->lock);
+        if (c->pending < 0)
+            break;
+        int slot = c->pending;
+        c->pending = -1;
+        c->busy = 1;
+        pthread_mutex_unlock(&c->lock);
+        msync(c->map + slot * c->slot_size, c->slot_size, MS_SYNC);
+        pthread_mutex_lock(&c->lock);
+        c->busy = 0;
+    }
+    pthread_mutex_unlock(&c->lock);
+    return NULL;
+}
+
+// Abre el archivo de checkpoint de una ejecución de nsteps barridos con tolerancia tol sobre
+// una malla de n intervalos. Si restart es 0 el archivo se vacía: ninguna ranura anterior
+// puede usarse después para reanudar.
+static inline Checkpoint* checkpoint_open(const char* fname, int n, int nsteps, double tol, int every, int restart) {
+    long page = sysconf(_SC_PAGESIZE);
+    size_t bytes = CHECKPOINT_DATA + (size_t)(n + 1) * sizeof(double);
+    Checkpoint* c = (Checkpoint*) malloc(sizeof(Checkpoint));
+
+    c->slot_size = (bytes + page - 1) / page * page;
+    c->fd = open(fname, O_RDWR | O_CREAT | (restart ? 0 : O_TRUNC), 0644);
+    if (c->fd < 0 || ftruncate(c->fd, 2 * c->slot_size) != 0) {
+        printf("Error al abrir el archivo de checkpoint %s\n", fname);
+        if (c->fd >= 0)
+            close(c->fd);
+        free(c);
+        return NULL;
+    }
+    c->map = (char*) mmap(NULL, 2 * c->slot_size, PROT_READ | PROT_WRITE, MAP_SHARED, c->fd, 0);
+    if (c->map == MAP_FAILED) {
+        printf("Error al proyectar el archivo de checkpoint %s\n", fname);
+        close(c->fd);
+        free(c);
+        return NULL;
+    }
+
+    c->n = n;
+    c->nsteps = nsteps;
+    c->tol = tol;
+    c->run = ((uint64_t)time(NULL) << 32) ^ (uint64_t)getpid();
+    c->every = every;
+    c->base = 0;
+    c->last = 0;
+    c->next_slot = 0;
+    c->pending = -1;
+    c->busy = 0;
+    c->done = 0;
+    pthread_mutex_init(&c->lock, NULL);
+    pthread_cond_init(&c->cond, NULL);
+    pthread_create(&c->writer, NULL, checkpoint_writer, c);
+    return c;
+}
+
+// Carga en u la ranura válida más reciente de una ejecución con la misma malla, barridos y
+// tolerancia. Devuelve su número de barridos (nunca más de nsteps) o -1 si no hay ninguna.
+static inline int checkpoint_restore(Checkpoint* c, double* u) {
+    int best = -1, best_sweep = -1;
+    for (int slot = 0; slot < 2; ++slot) {
+        CheckpointHeader* header = (CheckpointHeader*)(c->map + slot * c->slot_size);
+        double* data = (double*)(c->map + slot * c->slot_size + CHECKPOINT_DATA);
+        if (header->magic == CHECKPOINT_MAGIC && header->n == c->n && header->nsteps == c->nsteps &&
+            header->tol == c->tol && header->sweep > best_sweep &&
+            header->checksum == checkpoint_checksum(data, c->n + 1)) {
+            best = slot;
+            best_sweep = (int)header->sweep;
+        }
+    }
+    if (best < 0)
+        return -1;
+
+    memcpy(u, c->map + best * c->slot_size + CHECKPOINT_DATA, (c->n + 1) * sizeof(double));
+    if (best_sweep > c->nsteps)
+        best_sweep = c->nsteps;
+    c->run = ((CheckpointHeader*)(c->map + best * c->slot_size))->run;
+    c->base = c->last = best_sweep;
+    c->next_slot = 1 - best; // No se sobrescribe el checkpoint del que se reanudó
+    return best_sweep;
+}
+
+// Llamada por el resolvedor con los barridos hechos en esta ejecución y u al día. Si tocan,
+// copia u a la ranura libre y se la entrega al escritor. Si el escritor aún está
+// sincronizando la anterior, el checkpoint se omite en lugar de detener los barridos.
+static inline void checkpoint_save(Checkpoint* c, int done, const double* u) {
+    if (!c)
+        return;
+    int sweep = c->base + done;
+    if (sweep - c->last < c->every)
+        return;
+
+    pthread_mutex_lock(&c->lock);
+    int free_writer = c->pending < 0 && !c->busy;
+    pthread_mutex_unlock(&c->lock);
+    if (!free_writer)
+        return;
+
+    CheckpointHeader* header = (CheckpointHeader*)(c->map + c->next_slot * c->slot_size);
+    double* data = (double*)(c->map + c->next_slot * c->slot_size + CHECKPOINT_DATA);
+    header->magic = 0; // Ranura inválida mientras se escribe
+    memcpy(data, u, (c->n + 1) * sizeof(double));
+    header->n = c->n;
+    header->nsteps = c->nsteps;
+    header->tol = c->tol;
+    header->run = c->run;
+    header->sweep = sweep;
+    header->checksum = checkpoint_checksum(data, c->n + 1);
+    header->magic = CHECKPOINT_MAGIC;
+    c->last = sweep;
+
+    pthread_mutex_lock(&c->lock);
+    c->pending = c->next_slot;
+    pthread_cond_signal(&c->cond);
+    pthread_mutex_unlock(&c->lock);
+    c->next_slot = 1 - c->next_slot;
+}
+
+// Espera al último msync pendiente y cierra el archivo
+static inline void checkpoint_close(Checkpoint* c) {
+    pthread_mutex_lock(&c->lock);
+    c->done = 1;
+    pthread_cond_signal(&c->cond);
+    pthread_mutex_unlock(&c->lock);
+    pthread_join(c->writer, NULL);
+    munmap(c->map, 2 * c->slot_size);
+    close(c->fd);
+    pthread_mutex_destroy(&c->lock);
+    pthread_cond_destroy(&c->cond);
+    free(c);
+}
+
+#endif
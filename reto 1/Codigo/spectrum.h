@@ -0,0 +1,131 @@
+// Cotas [alpha, beta] del espectro de la matriz de iteración de Jacobi, G = I - D^-1 A, para la
+// aceleración de Chebyshev; común a JacobiSequencial.c, JacobiHilos.c, JacobiProcesos.c,
+// reto 2/jacobiOpenMp.cpp y reto 3/JacobiMPI.c. Para el Laplaciano 1D (A = tridiag(-1, 2, -1))
+// se conocen: los autovalores son cos(pi j h), así que beta = cos(pi h). Es la opción por
+// omisión y la única gratuita.
+// Para un operador cualquiera beta se estima con Lanczos desde un vector de unos. El método de
+// potencias no sirve aquí: el hueco entre los dos mayores autovalores es del orden de h^2 y
+// necesita unas n^2 / 10 aplicaciones de G para acercarse a rho; con 2000 se quedaba tan por
+// debajo que Chebyshev hacía tres veces más barridos (17290 frente a 5950 en n = 1000).
+// Lanczos llega en unos n / 2 pasos, cada uno un barrido de Jacobi con f = 0 y dos productos
+// escalares: menos que los unos 6n barridos de Chebyshev, pero no gratis. Los valores de Ritz
+// se acercan a rho por debajo, así que al estabilizarse 1 - beta se acorta SPECTRAL_INFLATION:
+// pasarse un poco de rho apenas cuesta barridos, quedarse corto cuesta muchos.
+// El extremo inferior se aleja SPECTRAL_MARGIN de -beta: con las dos puntas del intervalo en
+// +-rho los modos más oscilantes (autovalores cerca de -rho) quedan en el borde, donde la
+// recurrencia de Chebyshev amplifica unas n veces el error de redondeo antes de amortiguarlo,
+// y como pesan 1/h^2 en el residuo lo dejan estancado (en n = 10^4, en torno a 1e-4). Dentro
+// del intervalo se amortiguan sin ese transitorio, a costa de unos pocos barridos más.
+#ifndef SPECTRUM_H
+#define SPECTRUM_H
+
+#include <stdlib.h>
+#include <math.h>
+
+#define SPECTRAL_MARGIN 0.05      // Holgura del extremo inferior del espectro
+#define SPECTRAL_CHECK 20         // Pasos de Lanczos entre dos estimaciones de beta
+#define SPECTRAL_TOLERANCE 1e-3   // Cambio relativo de 1 - beta con el que la estimación es estable
+#define SPECTRAL_INFLATION 0.02   // Fracción en que se acorta 1 - beta estimado
+
+// Escribe w = G q en los puntos first..last; q[first - 1] y q[last + 1] son fronteras o celdas
+// fantasma que la función pone al día si hace falta
+typedef void (*SpectralApply)(void* ctx, double* q, double* w, int first, int last);
+// Suma count valores entre todos los procesos (NULL con un único proceso)
+typedef void (*SpectralReduce)(void* ctx, double* values, int count);
+
+// G del Laplaciano 1D con las fronteras en cero
+static inline void spectral_laplacian(void* ctx, double* q, double* w, int first, int last) {
+    (void)ctx;
+    for (int i = first; i <= last; ++i)
+        w[i] = (q[i - 1] + q[i + 1]) / 2.0;
+}
+
+// Mayor autovalor de la tridiagonal simétrica de orden m con diagonal diag y subdiagonal off,
+// por bisección con la sucesión de Sturm dentro del intervalo de Gershgorin
+static inline double spectral_ritz(const double* diag, const double* off, int m) {
+    double lo = diag[0], hi = diag[0];
+    for (int j = 0; j < m; ++j) {
+        double radius = (j > 0 ? fabs(off[j - 1]) : 0.0) + (j < m - 1 ? fabs(off[j]) : 0.0);
+        lo = fmin(lo, diag[j] - radius);
+        hi = fmax(hi, diag[j] + radius);
+    }
+    for (int it = 0; it < 100 && hi - lo > 1e-15 * fmax(fabs(lo), fabs(hi)); ++it) {
+        double x = (lo + hi) / 2.0, d = 1.0;
+        int below = 0;
+        for (int j = 0; j < m; ++j) {
+            d = diag[j] - x - (j > 0 ? off[j - 1] * off[j - 1] / d : 0.0);
+            if (d == 0.0)
+                d = 1e-300;
+            below += d < 0.0;
+        }
+        if (below < m)
+            lo = x;
+        else
+            hi = x;
+    }
+    return lo;
+}
+
+// Estima beta con a lo sumo max_steps pasos de Lanczos sobre los puntos first..last (vectores
+// de last + 2 valores). Se detiene cuando 1 - beta cambia menos de SPECTRAL_TOLERANCE entre dos
+// estimaciones; con MPI todos los procesos llegan a la misma decisión porque las sumas son
+// globales.
+static inline double spectral_lanczos(int first, int last, int max_steps, SpectralApply apply,
+                                      SpectralReduce reduce, void* ctx) {
+    double* q = (double*)calloc(last + 2, sizeof(double));
+    double* prev = (double*)calloc(last + 2, sizeof(double));
+    double* w = (double*)calloc(last + 2, sizeof(double));
+    double* diag = (double*)malloc(max_steps * sizeof(double));
+    double* off = (double*)malloc(max_steps * sizeof(double));
+    double norm = last - first + 1, theta = 0.0;
+
+    if (reduce)
+        reduce(ctx, &norm, 1);
+    for (int i = first; i <= last; ++i)
+        q[i] = 1.0 / sqrt(norm);
+    for (int m = 1; m <= max_steps; ++m) {
+        double a = 0.0, b = 0.0;
+        apply(ctx, q, w, first, last);
+        for (int i = first; i <= last; ++i)
+            a += w[i] * q[i];
+        if (reduce)
+            reduce(ctx, &a, 1);
+        for (int i = first; i <= last; ++i) {
+            w[i] -= a * q[i] + (m > 1 ? off[m - 2] * prev[i] : 0.0);
+            b += w[i] * w[i];
+        }
+        if (reduce)
+            reduce(ctx, &b, 1);
+        diag[m - 1] = a;
+        off[m - 1] = b = sqrt(b);
+
+        if (b == 0.0 || m == max_steps || m % SPECTRAL_CHECK == 0) {
+            double next = spectral_ritz(diag, off, m);
+            int stable = m > SPECTRAL_CHECK && fabs(next - theta) <= SPECTRAL_TOLERANCE * (1.0 - next);
+            theta = next;
+            if (b == 0.0 || stable)
+                break;
+        }
+        for (int i = first; i <= last; ++i) {
+            prev[i] = q[i];
+            q[i] = w[i] / b;
+        }
+    }
+    free(q);
+    free(prev);
+    free(w);
+    free(diag);
+    free(off);
+    return theta < 1.0 ? 1.0 - (1.0 - theta) * (1.0 - SPECTRAL_INFLATION) : theta;
+}
+
+// Cotas para una malla de n intervalos: analíticas, o estimadas con Lanczos si estimate no es 0
+static inline void spectral_bounds(int n, int estimate, double* alpha, double* beta) {
+    if (!estimate)
+        *beta = cos(acos(-1.0) / n);
+    else
+        *beta = spectral_lanczos(1, n - 1, n - 1, spectral_laplacian, NULL, NULL);
+    *alpha = -*beta - SPECTRAL_MARGIN;
+}
+
+#endif
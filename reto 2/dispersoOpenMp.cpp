@@ -0,0 +1,109 @@
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <omp.h>
+#include "sell.hpp"
+
+// Valores por defecto
+#define ITERACIONES_DEFECTO 1000
+#define HILOS_DEFECTO 4
+
+// Jacobi (ponderado) sobre la matriz de un archivo Matrix Market con OpenMP. El lado derecho es
+// b = A * 1, así que la solución exacta es el vector de unos y el error se mide contra ella.
+// Compilación: g++ -O3 -march=native -fopenmp dispersoOpenMp.cpp -o dispersoOpenMp
+
+int main(int argc, char** argv) {
+    int i, num_iteraciones, num_hilos;
+    double omega = 1.0;                // Peso de Jacobi (1 = Jacobi sin ponderar)
+    int sigma = SELL_SIGMA_DEFECTO;    // Ventana de ordenamiento de SELL-C-sigma
+    double tol = 0.0;                  // Tolerancia del residuo relativo (0 = sin criterio de parada)
+    int cada = 10;                     // Iteraciones entre mediciones del residuo
+    double residuo = -1.0;
+    char* args[3] = {NULL, NULL, NULL};
+    int nargs = 0;
+    Coo coo;
+    Csr csr;
+
+    // Separación de las opciones (--omega <w>, --sigma <s>, --tol <valor>, --cada <k>) y los
+    // argumentos posicionales
+    for (i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--omega") == 0 && i + 1 < argc)
+            omega = atof(argv[++i]);
+        else if (strcmp(argv[i], "--sigma") == 0 && i + 1 < argc)
+            sigma = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--tol") == 0 && i + 1 < argc)
+            tol = atof(argv[++i]);
+        else if (strcmp(argv[i], "--cada") == 0 && i + 1 < argc)
+            cada = atoi(argv[++i]);
+        else if (nargs < 3)
+            args[nargs++] = argv[i];
+    }
+    if (nargs < 1) {
+        printf("Uso: %s <matriz.mtx> [iteraciones] [hilos] [--omega w] [--sigma s] [--tol t] [--cada k]\n", argv[0]);
+        return 1;
+    }
+    num_iteraciones = (nargs > 1) ? atoi(args[1]) : ITERACIONES_DEFECTO;
+    num_hilos = (nargs > 2) ? atoi(args[2]) : HILOS_DEFECTO;
+    omp_set_num_threads(num_hilos);
+
+    if (leer_matrix_market(args[0], &coo) != 0)
+        return 1;
+    if (coo.filas != coo.columnas) {
+        printf("Error: la matriz debe ser cuadrada (%d x %d).\n", coo.filas, coo.columnas);
+        liberar_coo(&coo);
+        return 1;
+    }
+    int correcta = csr_de_coo(&coo, 0, coo.filas, &csr) == 0;
+    liberar_coo(&coo);
+    if (!correcta)
+        return 1;
+
+    int n = csr.filas;
+    Sell a = sell_de_csr(&csr, sigma);
+    double* inv_diagonal = (double*)reservar_alineado(n * sizeof(double));
+    double* b = (double*)reservar_alineado(n * sizeof(double));
+    double* x = (double*)reservar_alineado(n * sizeof(double));
+    for (i = 0; i < n; ++i) {
+        double suma = csr.diagonal[i];
+        for (long p = csr.inicio[i]; p < csr.inicio[i + 1]; ++p)
+            suma += csr.val[p];
+        b[i] = suma;
+        inv_diagonal[i] = 1.0 / csr.diagonal[i];
+        x[i] = 0.0;
+    }
+    liberar_csr(&csr);
+
+    double tiempo_inicio = omp_get_wtime();
+    int realizadas = jacobi_sell(num_iteraciones, &a, inv_diagonal, x, b, omega, tol, cada, &residuo);
+    double tiempo = omp_get_wtime() - tiempo_inicio;
+
+    double error = 0.0;
+    for (i = 0; i < n; ++i)
+        if (fabs(x[i] - 1.0) > error)
+            error = fabs(x[i] - 1.0);
+
+    // Referencia de ancho de banda: tríada con arreglos mayores que la matriz
+    long elementos = (long)(bytes_barrido(&a) / sizeof(double));
+    if (elementos < (1L << 22))
+        elementos = 1L << 22;
+    double triada = medir_triada(elementos, omp_get_wtime);
+    double gflops = operaciones_barrido(&a) * realizadas / tiempo / 1e9;
+    double ancho = bytes_barrido(&a) * realizadas / tiempo;
+
+    printf("Matriz: %d filas, %ld no nulos fuera de la diagonal, SELL-%d-%d con %.1f %% de relleno\n", n, a.nnz,
+           SELL_C, a.sigma, a.almacenados > 0 ? 100.0 * (a.almacenados - a.nnz) / a.almacenados : 0.0);
+    printf("\nTiempo de ejecución: %f segundos\n", tiempo);
+    printf("Rendimiento: %.3f GFLOP/s, %.2f GB/s (%.0f %% de la tríada, %.2f GB/s)\n", gflops, ancho / 1e9,
+           triada > 0 ? 100.0 * ancho / triada : 0.0, triada / 1e9);
+    if (tol > 0)
+        printf("Iteraciones: %d, residuo relativo final: %e\n", realizadas, residuo);
+    printf("Error máximo: %e\n", error);
+
+    liberar_sell(&a);
+    free(inv_diagonal);
+    free(b);
+    free(x);
+    return 0;
+}
@@ -1,77 +1,1035 @@
-#define _POSIX_C_SOURCE 199309L
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <omp.h>
-
-// Valores por defecto
-#define N_DEFECTO 100000
-#define ITERACIONES_DEFECTO 1000
-#define HILOS_DEFECTO 4
-
-// Funcin que implementa el mtodo de Jacobi para resolver ecuaciones diferenciales
-void jacobi(int num_iteraciones, int n, double* u, double* f) {
-    int iteracion;
-    double h = 1.0 / n;
-    double h2 = h * h;
-    double* u_temp = (double*)malloc((n + 1) * sizeof(double));
-
-    // Condiciones de frontera
-    u_temp[0] = u[0];
-    u_temp[n] = u[n];
-
-    for (iteracion = 0; iteracion < num_iteraciones; iteracion += 2) {
-        // Primera barrida: de u a u_temp
-        #pragma omp parallel for
-        for (int i = 1; i < n; ++i) {
-            u_temp[i] = (u[i - 1] + u[i + 1] + h2 * f[i]) / 2.0;
-        }
-
-        // Segunda barrida: de u_temp a u
-        #pragma omp parallel for
-        for (int i = 1; i < n; ++i) {
-            u[i] = (u_temp[i - 1] + u_temp[i + 1] + h2 * f[i]) / 2.0;
-        }
-    }
-
-    free(u_temp);
-}
-
-int main(int argc, char** argv) {
-    int i, n, num_iteraciones, num_hilos;
-    double* u;   // Solucin
-    double* f;   // Fuente
-    double h;
-    double tiempo_inicio, tiempo_fin;
-
-    // Lectura de argumentos o uso de valores por defecto
-    n = (argc > 1) ? atoi(argv[1]) : N_DEFECTO;
-    num_iteraciones = (argc > 2) ? atoi(argv[2]) : ITERACIONES_DEFECTO;
-    num_hilos = (argc > 3) ? atoi(argv[3]) : HILOS_DEFECTO;
-    h = 1.0 / n;
-
-    omp_set_num_threads(num_hilos);
-
-    // Asignacin de memoria
-    u = (double*)malloc((n + 1) * sizeof(double));
-    f = (double*)malloc((n + 1) * sizeof(double));
-
-    // Inicializacin
-    memset(u, 0, (n + 1) * sizeof(double));  // u empieza en cero
-    for (i = 0; i <= n; ++i)
-        f[i] = i * h;  // funcin fuente lineal
-
-    // Medicin del tiempo de ejecucin
-    tiempo_inicio = omp_get_wtime();
-    jacobi(num_iteraciones, n, u, f);
-    tiempo_fin = omp_get_wtime();
-
-    printf("\nTiempo de ejecucin: %f segundos\n", tiempo_fin - tiempo_inicio);
-
-    // Liberar memoria
-    free(f);
-    free(u);
-
-    return 0;
-}
-
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <omp.h>
+#include <sched.h>
+#include "../reto 1/Codigo/checkpoint.h"
+#include "../reto 1/Codigo/spectrum.h"
+
+// Valores por defecto
+#define N_DEFECTO 100000
+#define ITERACIONES_DEFECTO 1000
+#define HILOS_DEFECTO 4
+
+// Parámetros del multigrid
+#define MG_PRE_SUAVIZADO 2      // Barridos de suavizado antes de bajar de nivel
+#define MG_POST_SUAVIZADO 2     // Barridos de suavizado después de subir de nivel
+#define MG_PESO (2.0 / 3.0)     // Peso del Jacobi ponderado usado como suavizador
+#define MG_N_MINIMO 4           // No se crea un nivel con menos intervalos que este
+#define MG_UMBRAL_OMP 4096      // Por debajo de este tamaño los niveles se procesan en serie
+
+// Parámetros del Jacobi por lotes
+#define LOTE_CARRILES 8         // Lados derechos intercalados por bloque (64 bytes de double)
+#define LOTE_TROZO 2048         // Puntos de la malla por tarea
+
+#define ESPERA_ACTIVA 1000      // Consultas a un contador de un vecino antes de ceder el procesador
+
+// Función que implementa el método de Jacobi para resolver ecuaciones diferenciales
+// Si tol > 0, cada 'cada' iteraciones la segunda barrida calcula también la norma del
+// residuo con una reducción de OpenMP y se detiene en cuanto es menor que tol.
+// Si ckpt no es NULL, tras cada par de iteraciones se le ofrece u para el checkpoint periódico.
+// Devuelve el número de iteraciones realizadas y deja en *residuo la última norma medida.
+int jacobi(int num_iteraciones, int n, double* u, double* f, double tol, int cada, Checkpoint* ckpt,
+           double* residuo) {
+    int iteracion;
+    int desde_chequeo = 0; // Iteraciones desde la última medición del residuo
+    double h = 1.0 / n;
+    double h2 = h * h;
+    double* u_temp = (double*)malloc((n + 1) * sizeof(double));
+
+    // Condiciones de frontera
+    u_temp[0] = u[0];
+    u_temp[n] = u[n];
+
+    for (iteracion = 0; iteracion < num_iteraciones; iteracion += 2) {
+        // Primera barrida: de u a u_temp
+        #pragma omp parallel for
+        for (int i = 1; i < n; ++i) {
+            u_temp[i] = (u[i - 1] + u[i + 1] + h2 * f[i]) / 2.0;
+        }
+
+        desde_chequeo += 2;
+        if (tol > 0 && desde_chequeo >= cada) {
+            // Segunda barrida fusionada con el residuo de u_temp (cambio * 2 / h2)
+            double suma = 0.0;
+            #pragma omp parallel for reduction(+:suma)
+            for (int i = 1; i < n; ++i) {
+                double nuevo = (u_temp[i - 1] + u_temp[i + 1] + h2 * f[i]) / 2.0;
+                double d = nuevo - u_temp[i];
+                suma += d * d;
+                u[i] = nuevo;
+            }
+            desde_chequeo = 0;
+
+            // Norma L2 discreta del residuo
+            *residuo = (2.0 / h2) * sqrt(h * suma);
+            if (*residuo < tol) {
+                iteracion += 2;
+                break;
+            }
+        } else {
+            // Segunda barrida: de u_temp a u
+            #pragma omp parallel for
+            for (int i = 1; i < n; ++i) {
+                u[i] = (u_temp[i - 1] + u_temp[i + 1] + h2 * f[i]) / 2.0;
+            }
+        }
+        checkpoint_save(ckpt, iteracion + 2, u);
+    }
+
+    free(u_temp);
+    return iteracion;
+}
+
+// Contador de iteraciones terminadas por un hilo, solo en su línea de caché
+struct ContadorIteraciones {
+    int hechas;
+    char relleno[64 - sizeof(int)];
+};
+
+// Espera a que el hilo dueño del contador haya terminado al menos 'iteracion' iteraciones
+static void esperar_vecino(ContadorIteraciones* c, int iteracion) {
+    int consultas = 0;
+    for (;;) {
+        int hechas;
+        #pragma omp atomic read acquire
+        hechas = c->hechas;
+        if (hechas >= iteracion)
+            return;
+        if (++consultas >= ESPERA_ACTIVA) {
+            sched_yield();
+            consultas = 0;
+        }
+    }
+}
+
+// Jacobi sin la barrera implícita de cada 'omp for': cada hilo de una única región paralela
+// actualiza siempre el mismo trozo de la malla y publica con un contador atómico (release)
+// cuántas iteraciones lleva. Antes de la iteración k sólo espera (acquire) a que sus dos
+// vecinos hayan terminado la k - 1: sus bordes ya están al día en el arreglo de lectura y ya
+// no leen el de escritura. Los hilos no vecinos pueden ir varias iteraciones separados, así
+// que un retraso de un hilo no frena a todos. Sólo las iteraciones en que se mide el residuo
+// sincronizan a todos los hilos. Mismo criterio de parada y valor de retorno que jacobi, salvo
+// que devuelve -1 si no hay memoria para sus arreglos.
+int jacobi_vecinos(int num_iteraciones, int n, double* u, double* f, double tol, int cada, double* residuo) {
+    double h = 1.0 / n;
+    double h2 = h * h;
+    double* u_temp = (double*)malloc((n + 1) * sizeof(double));
+    int num_hilos = omp_get_max_threads();
+    ContadorIteraciones* hechas = NULL;  // posix_memalign no modifica el puntero si falla
+    double* sumas = (double*)calloc(num_hilos, sizeof(double));
+    int parar = 0;
+    int realizadas = num_iteraciones;
+
+    if (u_temp == NULL || sumas == NULL ||
+        posix_memalign((void**)&hechas, 64, num_hilos * sizeof(ContadorIteraciones)) != 0) {
+        printf("Error: no hay memoria para la sincronización con vecinos\n");
+        free(u_temp);
+        free(sumas);
+        free(hechas);
+        return -1;
+    }
+
+    // Condiciones de frontera
+    u_temp[0] = u[0];
+    u_temp[n] = u[n];
+    for (int t = 0; t < num_hilos; ++t)
+        hechas[t].hechas = 0;
+
+    #pragma omp parallel num_threads(num_hilos)
+    {
+        int id = omp_get_thread_num();
+        int hilos = omp_get_num_threads();
+        int trozo = (n - 1) / hilos;
+        int inicio = 1 + id * trozo;
+        int fin = (id == hilos - 1) ? n : inicio + trozo;
+        double* ent = u;
+        double* sal = u_temp;
+        int desde_chequeo = 0;
+
+        for (int iteracion = 0; iteracion < num_iteraciones; ++iteracion) {
+            int medir = 0;
+            if (tol > 0 && ++desde_chequeo >= cada) {
+                medir = 1;
+                desde_chequeo = 0;
+            }
+
+            if (id > 0)
+                esperar_vecino(&hechas[id - 1], iteracion);
+            if (id < hilos - 1)
+                esperar_vecino(&hechas[id + 1], iteracion);
+
+            if (medir) {
+                double suma = 0.0;
+                for (int i = inicio; i < fin; ++i) {
+                    double nuevo = (ent[i - 1] + ent[i + 1] + h2 * f[i]) / 2.0;
+                    double d = nuevo - ent[i];
+                    suma += d * d;
+                    sal[i] = nuevo;
+                }
+                sumas[id] = suma;
+            } else {
+                for (int i = inicio; i < fin; ++i)
+                    sal[i] = (ent[i - 1] + ent[i + 1] + h2 * f[i]) / 2.0;
+            }
+
+            // Publicación de la iteración junto con los valores escritos
+            #pragma omp atomic write release
+            hechas[id].hechas = iteracion + 1;
+
+            double* aux = ent;
+            ent = sal;
+            sal = aux;
+
+            if (medir) {
+                #pragma omp barrier
+                #pragma omp single
+                {
+                    double total = 0.0;
+                    for (int t = 0; t < hilos; ++t)
+                        total += sumas[t];
+                    *residuo = (2.0 / h2) * sqrt(h * total);
+                    if (*residuo < tol) {
+                        parar = 1;
+                        realizadas = iteracion + 1;
+                    }
+                }
+                if (parar)
+                    break;
+            }
+        }
+    }
+
+    // Tras un número impar de iteraciones la solución quedó en u_temp
+    if (realizadas % 2 == 1)
+        memcpy(u + 1, u_temp + 1, (n - 1) * sizeof(double));
+
+    free(sumas);
+    free(hechas);
+    free(u_temp);
+    return realizadas;
+}
+
+// Jacobi en precisión mixta con refinamiento iterativo. Cada 'cada' iteraciones se calcula en
+// double el residuo r = h2 f - A u (A = tridiag(-1, 2, -1)) y su norma; luego se hacen
+// 'cada' iteraciones de Jacobi en float sobre A e = r partiendo de e = 0 y se corrige u += e.
+// Esas iteraciones equivalen a continuar Jacobi sobre u (es una iteración lineal) pero mueven
+// la mitad de bytes, y el error de redondeo de float sólo afecta a la corrección, que se
+// recalcula desde el residuo en double: se llega a precisión double.
+// Mismo criterio de parada (norma L2 discreta del residuo) y valor de retorno que jacobi.
+int jacobi_mixto(int num_iteraciones, int n, double* u, double* f, double tol, int cada, double* residuo) {
+    int iteracion = 0;
+    double h = 1.0 / n;
+    double h2 = h * h;
+    float* r = (float*)malloc((n + 1) * sizeof(float));       // Residuo en float
+    float* e = (float*)calloc(n + 1, sizeof(float));          // Corrección (frontera en cero)
+    float* e_temp = (float*)calloc(n + 1, sizeof(float));
+
+    if (cada < 1)
+        cada = 1;
+    while (1) {
+        // Corrección de la ronda anterior y residuo en double
+        if (iteracion > 0) {
+            #pragma omp parallel for
+            for (int i = 1; i < n; ++i)
+                u[i] += e[i];
+        }
+        double suma = 0.0;
+        #pragma omp parallel for reduction(+:suma)
+        for (int i = 1; i < n; ++i) {
+            double ri = h2 * f[i] + u[i - 1] + u[i + 1] - 2.0 * u[i];
+            suma += ri * ri;
+            r[i] = (float)ri;
+        }
+        *residuo = (1.0 / h2) * sqrt(h * suma);
+        if ((tol > 0 && *residuo < tol) || iteracion >= num_iteraciones)
+            break;
+
+        // Iteraciones en float sobre A e = r desde e = 0, todas en una misma región paralela
+        int internas = (num_iteraciones - iteracion < cada) ? num_iteraciones - iteracion : cada;
+        memset(e, 0, (n + 1) * sizeof(float));
+        #pragma omp parallel
+        {
+            float* ent = e;
+            float* sal = e_temp;
+            for (int k = 0; k < internas; ++k) {
+                #pragma omp for
+                for (int i = 1; i < n; ++i)
+                    sal[i] = (ent[i - 1] + ent[i + 1] + r[i]) * 0.5f;
+                float* t = ent;
+                ent = sal;
+                sal = t;
+            }
+        }
+        if (internas % 2 == 1) {
+            float* t = e;
+            e = e_temp;
+            e_temp = t;
+        }
+        iteracion += internas;
+    }
+
+    free(r);
+    free(e);
+    free(e_temp);
+    return iteracion;
+}
+
+// Jacobi por lotes para num_rhs lados derechos del mismo operador, guardados uno tras otro en
+// u y f (desplazamiento n + 1). Internamente el lote se intercala en bloques de
+// LOTE_CARRILES lados derechos (AoSoA): el punto i de un bloque ocupa LOTE_CARRILES doubles
+// seguidos, uno por lado derecho, así que cada actualización del stencil es una operación
+// vectorial sobre todo el bloque y cada línea de caché de u y f sirve a LOTE_CARRILES
+// sistemas a la vez. Las tareas son pares (bloque, trozo de la malla), de modo que el
+// paralelismo sale tanto del lote como de la malla. Los carriles sobrantes del último bloque
+// tienen f = 0 y no cambian.
+// Si tol > 0, cada 'cada' iteraciones se mide la norma del residuo de cada lado derecho y se
+// detiene cuando la mayor es menor que tol. Devuelve las iteraciones realizadas (-1 si no hay
+// memoria para el lote) y deja en *residuo la mayor norma medida.
+int jacobi_lotes(int num_iteraciones, int n, int num_rhs, double* u, double* f, double tol, int cada, double* residuo) {
+    const int L = LOTE_CARRILES;
+    double h = 1.0 / n;
+    double h2 = h * h;
+    int num_bloques = (num_rhs + L - 1) / L;
+    int num_trozos = (n - 1 + LOTE_TROZO - 1) / LOTE_TROZO;
+    size_t tam = (size_t)num_bloques * (n + 1) * L;
+    double* U = NULL;   // posix_memalign no modifica el puntero si falla
+    double* T = NULL;
+    double* F = NULL;
+    double* sumas = (double*)calloc((size_t)num_bloques * L, sizeof(double));
+    if (sumas == NULL || posix_memalign((void**)&U, 64, tam * sizeof(double)) != 0 ||
+        posix_memalign((void**)&T, 64, tam * sizeof(double)) != 0 ||
+        posix_memalign((void**)&F, 64, tam * sizeof(double)) != 0) {
+        printf("Error: no hay memoria para el lote\n");
+        free(U);
+        free(T);
+        free(F);
+        free(sumas);
+        return -1;
+    }
+    int parar = 0;
+    int realizadas = num_iteraciones;
+
+    // Intercalado del lote (los carriles de relleno quedan en cero)
+    memset(U, 0, tam * sizeof(double));
+    memset(F, 0, tam * sizeof(double));
+    #pragma omp parallel for
+    for (int k = 0; k < num_rhs; ++k) {
+        size_t base = (size_t)(k / L) * (n + 1) * L + k % L;
+        for (int i = 0; i <= n; ++i) {
+            U[base + (size_t)i * L] = u[(size_t)k * (n + 1) + i];
+            F[base + (size_t)i * L] = f[(size_t)k * (n + 1) + i];
+        }
+    }
+    memcpy(T, U, tam * sizeof(double));  // Las fronteras son las mismas en ambos arreglos
+
+    #pragma omp parallel
+    {
+        double* ent = U;
+        double* sal = T;
+        int desde_chequeo = 0;
+
+        for (int iteracion = 0; iteracion < num_iteraciones; ++iteracion) {
+            int medir = 0;
+            if (tol > 0 && ++desde_chequeo >= cada) {
+                medir = 1;
+                desde_chequeo = 0;
+            }
+
+            #pragma omp for collapse(2) schedule(static)
+            for (int b = 0; b < num_bloques; ++b) {
+                for (int t = 0; t < num_trozos; ++t) {
+                    size_t base = (size_t)b * (n + 1) * L;
+                    const double* e = ent + base;
+                    const double* fb = F + base;
+                    double* s = sal + base;
+                    int i0 = 1 + t * LOTE_TROZO;
+                    int i1 = (i0 + LOTE_TROZO < n) ? i0 + LOTE_TROZO : n;
+                    double parcial[LOTE_CARRILES] = {0};
+
+                    for (int i = i0; i < i1; ++i) {
+                        #pragma omp simd
+                        for (int l = 0; l < L; ++l) {
+                            double nuevo = (e[(i - 1) * L + l] + e[(i + 1) * L + l] + h2 * fb[i * L + l]) * 0.5;
+                            if (medir) {
+                                double d = nuevo - e[i * L + l];
+                                parcial[l] += d * d;
+                            }
+                            s[i * L + l] = nuevo;
+                        }
+                    }
+                    if (medir) {
+                        for (int l = 0; l < L; ++l) {
+                            #pragma omp atomic
+                            sumas[b * L + l] += parcial[l];
+                        }
+                    }
+                }
+            }
+
+            double* aux = ent;
+            ent = sal;
+            sal = aux;
+
+            if (medir) {
+                #pragma omp single
+                {
+                    double mayor = 0.0;
+                    for (int k = 0; k < num_rhs; ++k) {
+                        double norma = (2.0 / h2) * sqrt(h * sumas[k]);
+                        if (norma > mayor)
+                            mayor = norma;
+                    }
+                    memset(sumas, 0, (size_t)num_bloques * L * sizeof(double));
+                    *residuo = mayor;
+                    if (mayor < tol) {
+                        parar = 1;
+                        realizadas = iteracion + 1;
+                    }
+                }
+                if (parar)
+                    break;
+            }
+        }
+    }
+
+    // Vuelta a la disposición de un lado derecho tras otro
+    double* final = (realizadas % 2 == 0) ? U : T;
+    #pragma omp parallel for
+    for (int k = 0; k < num_rhs; ++k) {
+        size_t base = (size_t)(k / L) * (n + 1) * L + k % L;
+        for (int i = 0; i <= n; ++i)
+            u[(size_t)k * (n + 1) + i] = final[base + (size_t)i * L];
+    }
+
+    free(U);
+    free(T);
+    free(F);
+    free(sumas);
+    return realizadas;
+}
+
+// Método SOR con ordenamiento rojo-negro: en cada iteración se actualizan primero los puntos
+// impares (rojos) y después los pares (negros), sobre el propio u y sin arreglo temporal.
+// Usa el omega óptimo del Laplaciano 1D, 2 / (1 + sin(pi h)). Cada color se recorre con un
+// índice comprimido j (i = primero + 2j) en un bucle "omp for simd".
+// Mismo criterio de parada y valor de retorno que jacobi.
+int sor_rojo_negro(int num_iteraciones, int n, double* u, double* f, double tol, int cada, double* residuo) {
+    int iteracion;
+    int desde_chequeo = 0;
+    double h = 1.0 / n;
+    double h2 = h * h;
+    double omega = 2.0 / (1.0 + sin(acos(-1.0) * h));
+
+    for (iteracion = 0; iteracion < num_iteraciones; ++iteracion) {
+        int medir = 0;
+        if (tol > 0 && ++desde_chequeo >= cada) {
+            medir = 1;
+            desde_chequeo = 0;
+        }
+
+        double suma = 0.0;
+        #pragma omp parallel
+        {
+            for (int color = 0; color < 2; ++color) {
+                int primero = 1 + color;
+                int cuantos = (n + 1 - primero) / 2;
+                if (medir) {
+                    #pragma omp for simd reduction(+:suma)
+                    for (int j = 0; j < cuantos; ++j) {
+                        int i = primero + 2 * j;
+                        double d = omega * ((u[i - 1] + u[i + 1] + h2 * f[i]) / 2.0 - u[i]);
+                        suma += d * d;
+                        u[i] += d;
+                    }
+                } else {
+                    #pragma omp for simd
+                    for (int j = 0; j < cuantos; ++j) {
+                        int i = primero + 2 * j;
+                        u[i] += omega * ((u[i - 1] + u[i + 1] + h2 * f[i]) / 2.0 - u[i]);
+                    }
+                }
+            }
+        }
+
+        if (medir) {
+            // El cambio de cada punto es omega * h2 / 2 veces su residuo local
+            *residuo = (2.0 / (omega * h2)) * sqrt(h * suma);
+            if (*residuo < tol) {
+                ++iteracion;
+                break;
+            }
+        }
+    }
+    return iteracion;
+}
+
+// Jacobi acelerado con Chebyshev (semi-iteración de Golub y Varga sobre [alfa, beta]): con J(u)
+// el barrido de Jacobi, gamma = 2 / (2 - alfa - beta) y sigma = (beta - alfa) / (2 - alfa - beta),
+//     u_{k+1} = omega_{k+1} (gamma J(u_k) + (1 - gamma) u_k - u_{k-1}) + u_{k-1},
+//     omega_1 = 1, omega_2 = 1 / (1 - sigma^2 / 2), omega_{k+1} = 1 / (1 - sigma^2 omega_k / 4).
+// u_{k+1} se escribe encima de u_{k-1}, así que usa los mismos arreglos que jacobi y un solo
+// "omp for" por iteración, sin reducciones fuera de las mediciones del residuo. Baja las
+// iteraciones de O(n^2) a O(n). Mismo criterio de parada y valor de retorno que jacobi.
+int jacobi_chebyshev(int num_iteraciones, int n, double* u, double* f, double alfa, double beta, double tol,
+                     int cada, double* residuo) {
+    int iteracion;
+    int desde_chequeo = 0;
+    double h = 1.0 / n;
+    double h2 = h * h;
+    double gamma = 2.0 / (2.0 - alfa - beta);
+    double sigma2 = (beta - alfa) * gamma / 2.0;
+    double omega = 1.0;
+    double* u_temp = (double*)malloc((n + 1) * sizeof(double));
+    double* actual = u;       // u_k
+    double* anterior = u_temp; // u_{k-1}, y luego u_{k+1}
+
+    sigma2 *= sigma2;
+    memcpy(u_temp, u, (n + 1) * sizeof(double));
+    for (iteracion = 0; iteracion < num_iteraciones; ++iteracion) {
+        int medir = 0;
+        if (tol > 0 && ++desde_chequeo >= cada) {
+            medir = 1;
+            desde_chequeo = 0;
+        }
+
+        double suma = 0.0;
+        if (medir) {
+            #pragma omp parallel for reduction(+:suma)
+            for (int i = 1; i < n; ++i) {
+                double d = (actual[i - 1] + actual[i + 1] + h2 * f[i]) / 2.0 - actual[i];
+                suma += d * d;
+                anterior[i] = omega * (actual[i] + gamma * d - anterior[i]) + anterior[i];
+            }
+        } else {
+            #pragma omp parallel for
+            for (int i = 1; i < n; ++i) {
+                double d = (actual[i - 1] + actual[i + 1] + h2 * f[i]) / 2.0 - actual[i];
+                anterior[i] = omega * (actual[i] + gamma * d - anterior[i]) + anterior[i];
+            }
+        }
+        double* t = actual;
+        actual = anterior;
+        anterior = t;
+        omega = (iteracion == 0) ? 1.0 / (1.0 - sigma2 / 2.0) : 1.0 / (1.0 - sigma2 * omega / 4.0);
+
+        if (medir) {
+            // Residuo de u_k, el estado anterior a esta iteración
+            *residuo = (2.0 / h2) * sqrt(h * suma);
+            if (*residuo < tol) {
+                ++iteracion;
+                break;
+            }
+        }
+    }
+
+    if (actual != u)
+        memcpy(u + 1, actual + 1, (n - 1) * sizeof(double));
+    free(u_temp);
+    return iteracion;
+}
+
+// Nivel de la jerarquía de mallas del multigrid. En el nivel 0, u y f son los arreglos del
+// llamador; en los demás niveles u es la corrección (con frontera cero) y f el residuo restringido.
+typedef struct {
+    int n;          // Número de intervalos del nivel
+    double h2;      // Cuadrado del tamaño de paso del nivel
+    double* u;
+    double* f;
+    double* tmp;    // Arreglo temporal del suavizador, del residuo y del resolvedor directo
+} NivelMG;
+
+// Jerarquía completa, reservada una sola vez antes de resolver
+typedef struct {
+    int num_niveles;
+    NivelMG* niveles;
+} Multigrid;
+
+// Crea la jerarquía para una malla de n intervalos, dividiendo entre dos mientras n sea par.
+// main rechaza los n sin nivel grueso (impares o menores que 2 * MG_N_MINIMO).
+Multigrid* crear_multigrid(int n) {
+    Multigrid* mg = (Multigrid*)malloc(sizeof(Multigrid));
+    int num_niveles = 1;
+    for (int m = n; m % 2 == 0 && m / 2 >= MG_N_MINIMO; m /= 2)
+        ++num_niveles;
+
+    mg->num_niveles = num_niveles;
+    mg->niveles = (NivelMG*)malloc(num_niveles * sizeof(NivelMG));
+    for (int l = 0, m = n; l < num_niveles; ++l, m /= 2) {
+        NivelMG* nivel = &mg->niveles[l];
+        double h = 1.0 / m;
+        nivel->n = m;
+        nivel->h2 = h * h;
+        nivel->u = (l == 0) ? NULL : (double*)calloc(m + 1, sizeof(double));
+        nivel->f = (l == 0) ? NULL : (double*)calloc(m + 1, sizeof(double));
+        nivel->tmp = (double*)calloc(m + 1, sizeof(double));
+    }
+    return mg;
+}
+
+// Libera la jerarquía (los arreglos del nivel 0 pertenecen al llamador)
+void liberar_multigrid(Multigrid* mg) {
+    for (int l = 0; l < mg->num_niveles; ++l) {
+        if (l > 0) {
+            free(mg->niveles[l].u);
+            free(mg->niveles[l].f);
+        }
+        free(mg->niveles[l].tmp);
+    }
+    free(mg->niveles);
+    free(mg);
+}
+
+// Suavizador: barridos del núcleo de jacobi ponderados con MG_PESO, alternando entre u y tmp
+// de dos en dos para que el resultado quede en u
+void suavizar(NivelMG* nivel, int barridos) {
+    int n = nivel->n;
+    double h2 = nivel->h2, w = MG_PESO;
+    double* u = nivel->u;
+    double* f = nivel->f;
+    double* tmp = nivel->tmp;
+
+    tmp[0] = u[0];
+    tmp[n] = u[n];
+    for (int b = 0; b < barridos; b += 2) {
+        #pragma omp parallel for if (n > MG_UMBRAL_OMP)
+        for (int i = 1; i < n; ++i)
+            tmp[i] = (1.0 - w) * u[i] + w * (u[i - 1] + u[i + 1] + h2 * f[i]) / 2.0;
+
+        #pragma omp parallel for if (n > MG_UMBRAL_OMP)
+        for (int i = 1; i < n; ++i)
+            u[i] = (1.0 - w) * tmp[i] + w * (tmp[i - 1] + tmp[i + 1] + h2 * f[i]) / 2.0;
+    }
+}
+
+// Calcula en tmp el residuo r = f - A u, con A u = (2 u[i] - u[i-1] - u[i+1]) / h2.
+// Devuelve la norma L2 discreta del residuo.
+double calcular_residuo(NivelMG* nivel) {
+    int n = nivel->n;
+    double h2 = nivel->h2;
+    double suma = 0.0;
+
+    nivel->tmp[0] = nivel->tmp[n] = 0.0;
+    #pragma omp parallel for reduction(+:suma) if (n > MG_UMBRAL_OMP)
+    for (int i = 1; i < n; ++i) {
+        double r = nivel->f[i] - (2.0 * nivel->u[i] - nivel->u[i - 1] - nivel->u[i + 1]) / h2;
+        nivel->tmp[i] = r;
+        suma += r * r;
+    }
+    return sqrt(suma / n);
+}
+
+// Restricción por ponderación completa de fino (n intervalos) a grueso (n / 2)
+void restringir(const double* fino, double* grueso, int n_grueso) {
+    grueso[0] = grueso[n_grueso] = 0.0;
+    #pragma omp parallel for if (n_grueso > MG_UMBRAL_OMP)
+    for (int j = 1; j < n_grueso; ++j)
+        grueso[j] = (fino[2 * j - 1] + 2.0 * fino[2 * j] + fino[2 * j + 1]) / 4.0;
+}
+
+// Prolongación por interpolación lineal de grueso a fino, sumando sobre fino
+void prolongar_sumar(const double* grueso, double* fino, int n_grueso) {
+    #pragma omp parallel for if (n_grueso > MG_UMBRAL_OMP)
+    for (int j = 0; j < n_grueso; ++j) {
+        if (j > 0)
+            fino[2 * j] += grueso[j];
+        fino[2 * j + 1] += (grueso[j] + grueso[j + 1]) / 2.0;
+    }
+}
+
+// Resolución directa del nivel más grueso por el algoritmo de Thomas para la matriz
+// tridiagonal (-1, 2, -1) / h2, usando tmp para los coeficientes modificados
+void resolver_grueso(NivelMG* nivel) {
+    int n = nivel->n;
+    double* c = nivel->tmp;
+    double* u = nivel->u;
+
+    // Eliminación hacia adelante (u guarda temporalmente el lado derecho modificado)
+    c[1] = -0.5;
+    u[1] = (nivel->h2 * nivel->f[1] + u[0]) / 2.0;
+    for (int i = 2; i < n; ++i) {
+        double m = 2.0 + c[i - 1];
+        double d = nivel->h2 * nivel->f[i] + ((i == n - 1) ? u[n] : 0.0);
+        c[i] = -1.0 / m;
+        u[i] = (d + u[i - 1]) / m;
+    }
+
+    // Sustitución hacia atrás
+    for (int i = n - 2; i >= 1; --i)
+        u[i] -= c[i] * u[i + 1];
+}
+
+// Un ciclo V desde el nivel l: suavizado, corrección con el nivel grueso y suavizado
+void ciclo_v(Multigrid* mg, int l) {
+    NivelMG* nivel = &mg->niveles[l];
+    if (l == mg->num_niveles - 1) {
+        resolver_grueso(nivel);
+        return;
+    }
+
+    NivelMG* grueso = &mg->niveles[l + 1];
+    suavizar(nivel, MG_PRE_SUAVIZADO);
+    calcular_residuo(nivel);
+    restringir(nivel->tmp, grueso->f, grueso->n);
+    memset(grueso->u, 0, (grueso->n + 1) * sizeof(double));
+    ciclo_v(mg, l + 1);
+    prolongar_sumar(grueso->u, nivel->u, grueso->n);
+    suavizar(nivel, MG_POST_SUAVIZADO);
+}
+
+// Multigrid completo a partir del nivel l (con frontera cero): resuelve primero el problema
+// restringido y usa su interpolación como aproximación inicial del ciclo V en este nivel
+void multigrid_completo(Multigrid* mg, int l) {
+    NivelMG* nivel = &mg->niveles[l];
+    if (l == mg->num_niveles - 1) {
+        resolver_grueso(nivel);
+        return;
+    }
+
+    NivelMG* grueso = &mg->niveles[l + 1];
+    restringir(nivel->f, grueso->f, grueso->n);
+    multigrid_completo(mg, l + 1);
+    memset(nivel->u, 0, (nivel->n + 1) * sizeof(double));
+    prolongar_sumar(grueso->u, nivel->u, grueso->n);
+    ciclo_v(mg, l);
+}
+
+// Resuelve A u = f con ciclos V sobre la jerarquía mg, usando el u recibido como
+// aproximación inicial. Si completo es 1, la primera corrección se obtiene con multigrid
+// completo sobre el residuo inicial. Se detiene tras num_ciclos ciclos o cuando la norma
+// del residuo es menor que tol. Devuelve el número de ciclos y deja la norma en *residuo.
+int multigrid(Multigrid* mg, int num_ciclos, double* u, double* f, int completo, double tol, double* residuo) {
+    NivelMG* fino = &mg->niveles[0];
+    int ciclo = 0;
+    fino->u = u;
+    fino->f = f;
+
+    if (completo && mg->num_niveles > 1) {
+        NivelMG* grueso = &mg->niveles[1];
+        calcular_residuo(fino);
+        restringir(fino->tmp, grueso->f, grueso->n);
+        multigrid_completo(mg, 1);
+        prolongar_sumar(grueso->u, u, grueso->n);
+    }
+
+    for (ciclo = 0; ciclo < num_ciclos; ++ciclo) {
+        ciclo_v(mg, 0);
+        if (tol > 0) {
+            *residuo = calcular_residuo(fino);
+            if (*residuo < tol) {
+                ++ciclo;
+                break;
+            }
+        }
+    }
+    if (tol <= 0)
+        *residuo = calcular_residuo(fino);
+
+    fino->u = fino->f = NULL;
+    return ciclo;
+}
+
+// Thomas sobre el interior [a, b] con valores de frontera izq y der, usando la factorización
+// c de la matriz (-1, 2, -1), que no depende del tamaño del bloque
+static void thomas_bloque(int a, int b, double izq, double der, const double* c, double h2, double* u, const double* f) {
+    double anterior = izq;
+    for (int i = a; i <= b; ++i) {
+        u[i] = (h2 * f[i] + anterior) * -c[i - a + 1];
+        anterior = u[i];
+    }
+    double siguiente = der;
+    for (int i = b; i >= a; --i) {
+        u[i] -= c[i - a + 1] * siguiente;
+        siguiente = u[i];
+    }
+}
+
+// Resuelve de forma exacta el sistema tridiagonal de jacobi, 2 u[i] - u[i-1] - u[i+1] = h2 f[i],
+// para num_rhs lados derechos guardados uno tras otro (u + k * (n + 1), f + k * (n + 1)).
+// Método particionado: los puntos 1..n-1 se reparten en un bloque por hilo cuyo último punto
+// (salvo en el bloque final) es un separador. Cada hilo resuelve su interior por Thomas con
+// separadores nulos, los separadores se obtienen de un sistema tridiagonal pequeño (repartido
+// por lados derechos) y cada bloque se corrige con las respuestas lineales a sus separadores.
+void thomas_particionado(int n, int num_rhs, double* u, double* f) {
+    double h = 1.0 / n;
+    double h2 = h * h;
+    int max_bloques = omp_get_max_threads();
+    double* c = (double*)malloc((n + 1) * sizeof(double));
+    int* primero = (int*)malloc((max_bloques + 1) * sizeof(int));
+    double* sep_sub = (double*)malloc(max_bloques * sizeof(double));
+    double* sep_c = (double*)malloc(max_bloques * sizeof(double));
+    double* sep_den = (double*)malloc(max_bloques * sizeof(double));
+
+    // Factorización de la matriz (-1, 2, -1), común a todos los bloques
+    c[0] = 0.0;
+    for (int i = 1; i < n; ++i)
+        c[i] = -1.0 / (2.0 + c[i - 1]);
+
+    #pragma omp parallel
+    {
+        int p = omp_get_thread_num();
+        int P = omp_get_num_threads();
+        if (P > (n - 1) / 2)
+            P = ((n - 1) / 2 > 0) ? (n - 1) / 2 : 1;  // Cada bloque necesita separador e interior
+
+        // Reparto de los bloques y factorización del sistema de separadores, con mq el
+        // interior del bloque q: -s[q-1] / (ml + 1) + diag s[q] - s[q+1] / (mr + 1) = rhs
+        #pragma omp single
+        {
+            for (int q = 0; q <= P; ++q)
+                primero[q] = 1 + (int)((long)q * (n - 1) / P);
+            for (int q = 0; q < P - 1; ++q) {
+                double ml = primero[q + 1] - primero[q];             // interior + 1
+                double mr = ((q + 1 == P - 1) ? n + 1 : primero[q + 2]) - primero[q + 1];
+                double sub = (q == 0) ? 0.0 : -1.0 / ml;
+                sep_sub[q] = sub;
+                sep_den[q] = 2.0 - (ml - 1) / ml - (mr - 1) / mr - ((q == 0) ? 0.0 : sub * sep_c[q - 1]);
+                sep_c[q] = (-1.0 / mr) / sep_den[q];
+            }
+        }
+
+        int a = (p < P) ? primero[p] : 0;
+        int b = (p < P) ? ((p == P - 1) ? n - 1 : primero[p + 1] - 2) : -1;
+        double m1 = b - a + 2;
+
+        if (p < P) {
+            for (int k = 0; k < num_rhs; ++k) {
+                double* uk = u + (size_t)k * (n + 1);
+                double* fk = f + (size_t)k * (n + 1);
+                thomas_bloque(a, b, (p == 0) ? uk[0] : 0.0, (p == P - 1) ? uk[n] : 0.0, c, h2, uk, fk);
+            }
+        }
+        #pragma omp barrier
+
+        // Sistema de separadores de cada lado derecho
+        #pragma omp for
+        for (int k = 0; k < num_rhs; ++k) {
+            double* uk = u + (size_t)k * (n + 1);
+            double* fk = f + (size_t)k * (n + 1);
+            double anterior = 0.0;
+            for (int q = 0; q < P - 1; ++q) {
+                int sep = primero[q + 1] - 1;
+                double r = h2 * fk[sep] + uk[sep - 1] + uk[sep + 1];
+                uk[sep] = (r - sep_sub[q] * anterior) / sep_den[q];
+                anterior = uk[sep];
+            }
+            for (int q = P - 3; q >= 0; --q)
+                uk[primero[q + 1] - 1] -= sep_c[q] * uk[primero[q + 2] - 1];
+        }
+
+        // Corrección de cada bloque con sus separadores
+        if (p < P) {
+            for (int k = 0; k < num_rhs; ++k) {
+                double* uk = u + (size_t)k * (n + 1);
+                double izq = (p == 0) ? 0.0 : uk[a - 1];
+                double der = (p == P - 1) ? 0.0 : uk[b + 1];
+                #pragma omp simd
+                for (int i = a; i <= b; ++i) {
+                    int j = i - a + 1;
+                    uk[i] += (izq * (m1 - j) + der * j) / m1;
+                }
+            }
+        }
+    }
+
+    free(c);
+    free(primero);
+    free(sep_sub);
+    free(sep_c);
+    free(sep_den);
+}
+
+// Norma L2 discreta de f - A u / h2 calculada en double
+double norma_residuo(int n, const double* u, const double* f) {
+    double h = 1.0 / n;
+    double h2 = h * h;
+    double suma = 0.0;
+    #pragma omp parallel for reduction(+:suma)
+    for (int i = 1; i < n; ++i) {
+        double ri = h2 * f[i] + u[i - 1] + u[i + 1] - 2.0 * u[i];
+        suma += ri * ri;
+    }
+    return (1.0 / h2) * sqrt(h * suma);
+}
+
+// Comparación de tiempo hasta la tolerancia: jacobi en double y jacobi_mixto, ambos desde
+// u = 0, con el residuo final recalculado en double para los dos
+void comparar_precision(int n, int num_iteraciones, double* f, double tol, int cada) {
+    const char* nombres[2] = {"double", "mixta"};
+    double* u = (double*)malloc((n + 1) * sizeof(double));
+
+    printf("\n%-8s %12s %12s %14s\n", "modo", "tiempo (s)", "iteraciones", "residuo");
+    for (int modo = 0; modo < 2; ++modo) {
+        double residuo = -1.0;
+        int realizadas;
+        memset(u, 0, (n + 1) * sizeof(double));
+        double t = omp_get_wtime();
+        if (modo == 0)
+            realizadas = jacobi(num_iteraciones, n, u, f, tol, cada, NULL, &residuo);
+        else
+            realizadas = jacobi_mixto(num_iteraciones, n, u, f, tol, cada, &residuo);
+        t = omp_get_wtime() - t;
+        printf("%-8s %12.6f %12d %14e\n", nombres[modo], t, realizadas, norma_residuo(n, u, f));
+    }
+    free(u);
+}
+
+int main(int argc, char** argv) {
+    int i, n, num_iteraciones, num_hilos, realizadas = 0;
+    const char* metodo = "jacobi"; // Método de solución: jacobi, chebyshev, mixto, lotes, sor, multigrid, fmg o thomas
+    const char* espectro = "analitico"; // Cotas del espectro para chebyshev: analitico o lanczos
+    int num_rhs = 1;       // Número de lados derechos (sólo thomas y lotes resuelven más de uno)
+    double tol = 0.0;      // Tolerancia del residuo (0 = sin criterio de parada)
+    int cada = 10;         // Iteraciones entre mediciones del residuo
+    double residuo = -1.0;
+    const char* nombre_ckpt = NULL; // Archivo de checkpoint de jacobi (si se proporciona)
+    int cada_ckpt = CHECKPOINT_EVERY;
+    int reanudar = 0;      // Reanudar desde el último checkpoint válido
+    int base = 0;          // Iteraciones ya hechas según el checkpoint
+    int comparar = 0;      // Comparar jacobi en double con el de precisión mixta
+    const char* sincronizacion = "barrera"; // Sincronización de jacobi: barrera o vecinos
+    Checkpoint* ckpt = NULL;
+    char* args[3] = {NULL, NULL, NULL};
+    int nargs = 0;
+    double* u;   // Solución
+    double* f;   // Fuente
+    double h;
+    double tiempo_inicio, tiempo_fin;
+
+    // Separación de las opciones (--metodo <jacobi|chebyshev|mixto|lotes|sor|multigrid|fmg|thomas>,
+    // --espectro <analitico|lanczos>, --sincronizacion <barrera|vecinos>, --rhs <m>, --tol <valor>,
+    // --cada <k>, --checkpoint <archivo>, --checkpoint-cada <k>, --restart, --comparar) y los
+    // argumentos posicionales
+    for (i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--metodo") == 0 && i + 1 < argc)
+            metodo = argv[++i];
+        else if (strcmp(argv[i], "--espectro") == 0 && i + 1 < argc)
+            espectro = argv[++i];
+        else if (strcmp(argv[i], "--sincronizacion") == 0 && i + 1 < argc)
+            sincronizacion = argv[++i];
+        else if (strcmp(argv[i], "--comparar") == 0)
+            comparar = 1;
+        else if (strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc)
+            nombre_ckpt = argv[++i];
+        else if (strcmp(argv[i], "--checkpoint-cada") == 0 && i + 1 < argc)
+            cada_ckpt = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--restart") == 0)
+            reanudar = 1;
+        else if (strcmp(argv[i], "--rhs") == 0 && i + 1 < argc)
+            num_rhs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--tol") == 0 && i + 1 < argc)
+            tol = atof(argv[++i]);
+        else if (strcmp(argv[i], "--cada") == 0 && i + 1 < argc)
+            cada = atoi(argv[++i]);
+        else if (nargs < 3)
+            args[nargs++] = argv[i];
+    }
+
+    // Lectura de argumentos o uso de valores por defecto
+    n = (nargs > 0) ? atoi(args[0]) : N_DEFECTO;
+    num_iteraciones = (nargs > 1) ? atoi(args[1]) : ITERACIONES_DEFECTO;
+    num_hilos = (nargs > 2) ? atoi(args[2]) : HILOS_DEFECTO;
+    h = 1.0 / n;
+
+    // Sin un nivel grueso el multigrid sería una sola resolución directa
+    if ((strcmp(metodo, "multigrid") == 0 || strcmp(metodo, "fmg") == 0) && (n % 2 != 0 || n / 2 < MG_N_MINIMO)) {
+        printf("Error: el multigrid necesita un número de intervalos par y de al menos %d (n = %d)\n",
+               2 * MG_N_MINIMO, n);
+        return 1;
+    }
+
+    omp_set_num_threads(num_hilos);
+
+    // Asignación de memoria (num_rhs pares seguidos)
+    u = (double*)malloc((size_t)num_rhs * (n + 1) * sizeof(double));
+    f = (double*)malloc((size_t)num_rhs * (n + 1) * sizeof(double));
+
+    // Inicialización
+    memset(u, 0, (size_t)num_rhs * (n + 1) * sizeof(double));  // u empieza en cero
+    for (int k = 0; k < num_rhs; ++k)
+        for (i = 0; i <= n; ++i)
+            f[(size_t)k * (n + 1) + i] = (k + 1) * i * h;  // función fuente lineal, escalada por k + 1
+
+    if (comparar) {
+        comparar_precision(n, num_iteraciones, f, tol, cada);
+        free(f);
+        free(u);
+        return 0;
+    }
+
+    // El checkpoint sólo se usa con jacobi sincronizado con barrera; al reanudar, u parte del
+    // estado guardado
+    int vecinos = strcmp(sincronizacion, "vecinos") == 0;
+    if (nombre_ckpt && strcmp(metodo, "jacobi") == 0 && !vecinos) {
+        ckpt = checkpoint_open(nombre_ckpt, n, num_iteraciones, tol, cada_ckpt, reanudar);
+        if (ckpt && reanudar) {
+            base = checkpoint_restore(ckpt, u);
+            if (base < 0) {
+                printf("No hay un checkpoint válido en %s, se empieza de cero\n", nombre_ckpt);
+                base = 0;
+            } else {
+                printf("Reanudando desde la iteración %d\n", base);
+            }
+        }
+    }
+
+    // Para multigrid la jerarquía de mallas se reserva antes de medir el tiempo
+    int es_multigrid = strcmp(metodo, "multigrid") == 0 || strcmp(metodo, "fmg") == 0;
+    Multigrid* mg = es_multigrid ? crear_multigrid(n) : NULL;
+
+    // Medición del tiempo de ejecución
+    tiempo_inicio = omp_get_wtime();
+    if (strcmp(metodo, "thomas") == 0)
+        thomas_particionado(n, num_rhs, u, f);
+    else if (es_multigrid)
+        realizadas = multigrid(mg, num_iteraciones, u, f, strcmp(metodo, "fmg") == 0, tol, &residuo);
+    else if (strcmp(metodo, "sor") == 0)
+        realizadas = sor_rojo_negro(num_iteraciones, n, u, f, tol, cada, &residuo);
+    else if (strcmp(metodo, "chebyshev") == 0) {
+        double alfa, beta;
+        spectral_bounds(n, strcmp(espectro, "lanczos") == 0, &alfa, &beta);
+        printf("Cotas del espectro de la iteración de Jacobi: [%.12f, %.12f] (%s)\n", alfa, beta, espectro);
+        realizadas = jacobi_chebyshev(num_iteraciones, n, u, f, alfa, beta, tol, cada, &residuo);
+    }
+    else if (strcmp(metodo, "mixto") == 0)
+        realizadas = jacobi_mixto(num_iteraciones, n, u, f, tol, cada, &residuo);
+    else if (strcmp(metodo, "lotes") == 0)
+        realizadas = jacobi_lotes(num_iteraciones, n, num_rhs, u, f, tol, cada, &residuo);
+    else if (vecinos)
+        realizadas = jacobi_vecinos(num_iteraciones, n, u, f, tol, cada, &residuo);
+    else
+        realizadas = base + jacobi(num_iteraciones - base, n, u, f, tol, cada, ckpt, &residuo);
+    tiempo_fin = omp_get_wtime();
+
+    // Un resolvedor que no pudo reservar sus arreglos devuelve -1
+    if (realizadas < 0) {
+        if (ckpt)
+            checkpoint_close(ckpt);
+        free(f);
+        free(u);
+        return 1;
+    }
+
+    printf("\nTiempo de ejecución: %f segundos\n", tiempo_fin - tiempo_inicio);
+    if (strcmp(metodo, "thomas") == 0)
+        printf("Lados derechos resueltos: %d\n", num_rhs);
+    else if (strcmp(metodo, "lotes") == 0 && tol > 0)
+        printf("Lados derechos: %d, iteraciones: %d, mayor residuo final: %e\n", num_rhs, realizadas, residuo);
+    else if (es_multigrid)
+        printf("Niveles: %d, ciclos: %d, residuo final: %e\n", mg->num_niveles, realizadas, residuo);
+    else if (tol > 0)
+        printf("Iteraciones: %d, residuo final: %e\n", realizadas, residuo);
+    if (mg)
+        liberar_multigrid(mg);
+    if (ckpt)
+        checkpoint_close(ckpt);
+
+    // Liberar memoria
+    free(f);
+    free(u);
+
+    return 0;
+}
+
@@ -0,0 +1,393 @@
+// Jacobi sobre matrices dispersas generales guardadas en formato SELL-C-sigma.
+// Generaliza el barrido de jacobi (1D) a un sistema A x = b cualquiera leído de un archivo
+// Matrix Market: cada barrido calcula
+//     x_nuevo[i] = x[i] + omega * ((b[i] - suma_{j != i} a_ij x[j]) / a_ii - x[i])
+// (omega = 1 es Jacobi; omega < 1, Jacobi ponderado). La diagonal se guarda aparte y el resto
+// de la matriz en SELL-C-sigma: las filas se agrupan en trozos de SELL_C filas que se guardan
+// por columnas, rellenos hasta la fila más larga del trozo, así que el producto avanza SELL_C
+// filas a la vez con un bucle que se vectoriza. Para que el relleno sea poco, antes de formar
+// los trozos se ordenan las filas por longitud dentro de ventanas de sigma filas.
+// Requiere _POSIX_C_SOURCE >= 200112L (posix_memalign).
+#ifndef SELL_HPP
+#define SELL_HPP
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <math.h>
+
+#define SELL_C 8               // Filas por trozo: un double por carril de un registro de 512 bits
+#define SELL_SIGMA_DEFECTO 256 // Ventana de ordenamiento por defecto
+
+// Matriz en coordenadas (índices desde 0), como se lee del archivo
+struct Coo {
+    int filas, columnas;
+    long nnz;
+    int* fila;
+    int* col;
+    double* val;
+};
+
+// Filas [fila0, fila1) en CSR con la diagonal aparte. Las columnas conservan la numeración
+// global de la matriz.
+struct Csr {
+    int fila0, filas;
+    long* inicio;      // filas + 1 desplazamientos
+    int* col;
+    double* val;
+    double* diagonal;
+};
+
+// Matriz sin diagonal en SELL-C-sigma. El elemento j de la fila r del trozo t está en
+// inicio[t] + j * SELL_C + r; el relleno tiene columna 0 y valor 0.
+struct Sell {
+    int filas, num_trozos, sigma;
+    long nnz;          // No nulos fuera de la diagonal
+    long almacenados;  // Elementos guardados, relleno incluido
+    long* inicio;      // Primer elemento de cada trozo
+    int* ancho;        // Longitud de la fila más larga de cada trozo
+    int* fila;         // Fila original de cada posición (num_trozos * SELL_C; -1 si es relleno)
+    int* col;
+    double* val;
+};
+
+static void* reservar_alineado(size_t bytes) {
+    void* p = NULL;
+    if (posix_memalign(&p, 64, bytes ? bytes : 64) != 0)
+        return NULL;
+    return p;
+}
+
+inline void liberar_coo(Coo* a) {
+    free(a->fila);
+    free(a->col);
+    free(a->val);
+}
+
+// Lee un archivo Matrix Market "coordinate" real, integer o pattern, general o symmetric
+// (de una matriz simétrica se guardan los dos triángulos). Devuelve 0 o -1 con un mensaje.
+inline int leer_matrix_market(const char* archivo, Coo* a) {
+    FILE* fp = fopen(archivo, "r");
+    char linea[1024], banner[64], objeto[64], formato[64], campo[64], simetria[64];
+    long declarados;
+
+    if (fp == NULL) {
+        perror(archivo);
+        return -1;
+    }
+    if (fgets(linea, sizeof(linea), fp) == NULL ||
+        sscanf(linea, "%63s %63s %63s %63s %63s", banner, objeto, formato, campo, simetria) != 5 ||
+        strcmp(banner, "%%MatrixMarket") != 0 || strcasecmp(objeto, "matrix") != 0 ||
+        strcasecmp(formato, "coordinate") != 0) {
+        fprintf(stderr, "%s: no es una matriz Matrix Market en coordenadas\n", archivo);
+        fclose(fp);
+        return -1;
+    }
+    int patron = strcasecmp(campo, "pattern") == 0;
+    int simetrica = strcasecmp(simetria, "symmetric") == 0;
+    if ((!patron && strcasecmp(campo, "real") != 0 && strcasecmp(campo, "integer") != 0) ||
+        (!simetrica && strcasecmp(simetria, "general") != 0)) {
+        fprintf(stderr, "%s: sólo se admiten matrices real, integer o pattern, general o symmetric\n", archivo);
+        fclose(fp);
+        return -1;
+    }
+
+    // Comentarios y luego el tamaño
+    do {
+        if (fgets(linea, sizeof(linea), fp) == NULL) {
+            fprintf(stderr, "%s: falta el tamaño de la matriz\n", archivo);
+            fclose(fp);
+            return -1;
+        }
+    } while (linea[0] == '%');
+    if (sscanf(linea, "%d %d %ld", &a->filas, &a->columnas, &declarados) != 3) {
+        fprintf(stderr, "%s: tamaño mal escrito\n", archivo);
+        fclose(fp);
+        return -1;
+    }
+
+    long capacidad = simetrica ? 2 * declarados : declarados;
+    a->fila = (int*)malloc(capacidad * sizeof(int));
+    a->col = (int*)malloc(capacidad * sizeof(int));
+    a->val = (double*)malloc(capacidad * sizeof(double));
+    a->nnz = 0;
+    for (long e = 0; e < declarados; ++e) {
+        int i, j;
+        double v = 1.0;
+        if (fscanf(fp, "%d %d", &i, &j) != 2 || (!patron && fscanf(fp, "%lf", &v) != 1) || i < 1 ||
+            i > a->filas || j < 1 || j > a->columnas) {
+            fprintf(stderr, "%s: entrada %ld mal escrita\n", archivo, e + 1);
+            fclose(fp);
+            liberar_coo(a);
+            return -1;
+        }
+        a->fila[a->nnz] = i - 1;
+        a->col[a->nnz] = j - 1;
+        a->val[a->nnz++] = v;
+        if (simetrica && i != j) {
+            a->fila[a->nnz] = j - 1;
+            a->col[a->nnz] = i - 1;
+            a->val[a->nnz++] = v;
+        }
+    }
+    fclose(fp);
+    return 0;
+}
+
+inline void liberar_csr(Csr* m) {
+    free(m->inicio);
+    free(m->col);
+    free(m->val);
+    free(m->diagonal);
+}
+
+// Filas [fila0, fila1) de la matriz; devuelve -1 si alguna tiene la diagonal nula
+inline int csr_de_coo(const Coo* a, int fila0, int fila1, Csr* m) {
+    int filas = fila1 - fila0;
+    m->fila0 = fila0;
+    m->filas = filas;
+    m->inicio = (long*)calloc(filas + 1, sizeof(long));
+    m->diagonal = (double*)calloc(filas > 0 ? filas : 1, sizeof(double));
+
+    for (long e = 0; e < a->nnz; ++e)
+        if (a->fila[e] >= fila0 && a->fila[e] < fila1 && a->fila[e] != a->col[e])
+            m->inicio[a->fila[e] - fila0 + 1]++;
+    for (int i = 0; i < filas; ++i)
+        m->inicio[i + 1] += m->inicio[i];
+    m->col = (int*)malloc((m->inicio[filas] > 0 ? m->inicio[filas] : 1) * sizeof(int));
+    m->val = (double*)malloc((m->inicio[filas] > 0 ? m->inicio[filas] : 1) * sizeof(double));
+
+    long* siguiente = (long*)malloc((filas > 0 ? filas : 1) * sizeof(long));
+    memcpy(siguiente, m->inicio, filas * sizeof(long));
+    for (long e = 0; e < a->nnz; ++e) {
+        int i = a->fila[e];
+        if (i < fila0 || i >= fila1)
+            continue;
+        if (i == a->col[e]) {
+            m->diagonal[i - fila0] += a->val[e];  // Las entradas repetidas se suman
+        } else {
+            long p = siguiente[i - fila0]++;
+            m->col[p] = a->col[e];
+            m->val[p] = a->val[e];
+        }
+    }
+    free(siguiente);
+
+    for (int i = 0; i < filas; ++i) {
+        if (m->diagonal[i] == 0.0) {
+            fprintf(stderr, "La fila %d tiene la diagonal nula: Jacobi no se puede aplicar\n", fila0 + i + 1);
+            liberar_csr(m);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+struct LargoFila {
+    int largo, fila;
+};
+
+static int por_largo_descendente(const void* x, const void* y) {
+    const LargoFila* a = (const LargoFila*)x;
+    const LargoFila* b = (const LargoFila*)y;
+    if (a->largo != b->largo)
+        return b->largo - a->largo;
+    return a->fila - b->fila;  // Mismo orden de siempre entre filas iguales
+}
+
+// Construye la SELL-C-sigma a partir de la CSR; las columnas quedan como estén en m->col
+inline Sell sell_de_csr(const Csr* m, int sigma) {
+    Sell a;
+    int filas = m->filas;
+    if (sigma < SELL_C)
+        sigma = SELL_C;
+    sigma = (sigma + SELL_C - 1) / SELL_C * SELL_C;  // Las ventanas no parten trozos
+    a.filas = filas;
+    a.sigma = sigma;
+    a.num_trozos = (filas + SELL_C - 1) / SELL_C;
+    a.nnz = m->inicio[filas];
+
+    // Orden de las filas: por longitud descendente dentro de cada ventana
+    LargoFila* orden = (LargoFila*)malloc((filas > 0 ? filas : 1) * sizeof(LargoFila));
+    for (int i = 0; i < filas; ++i) {
+        orden[i].largo = (int)(m->inicio[i + 1] - m->inicio[i]);
+        orden[i].fila = i;
+    }
+    for (int v = 0; v < filas; v += sigma)
+        qsort(orden + v, (v + sigma < filas) ? sigma : filas - v, sizeof(LargoFila), por_largo_descendente);
+
+    a.inicio = (long*)malloc((a.num_trozos + 1) * sizeof(long));
+    a.ancho = (int*)malloc((a.num_trozos > 0 ? a.num_trozos : 1) * sizeof(int));
+    a.fila = (int*)malloc(((long)a.num_trozos * SELL_C > 0 ? (long)a.num_trozos * SELL_C : 1) * sizeof(int));
+    a.inicio[0] = 0;
+    for (int t = 0; t < a.num_trozos; ++t) {
+        int ancho = 0;
+        for (int r = 0; r < SELL_C; ++r) {
+            int s = t * SELL_C + r;
+            a.fila[s] = (s < filas) ? orden[s].fila : -1;
+            if (s < filas && orden[s].largo > ancho)
+                ancho = orden[s].largo;
+        }
+        a.ancho[t] = ancho;
+        a.inicio[t + 1] = a.inicio[t] + (long)ancho * SELL_C;
+    }
+    a.almacenados = a.inicio[a.num_trozos];
+    free(orden);
+
+    a.col = (int*)reservar_alineado(a.almacenados * sizeof(int));
+    a.val = (double*)reservar_alineado(a.almacenados * sizeof(double));
+    for (int t = 0; t < a.num_trozos; ++t) {
+        for (int r = 0; r < SELL_C; ++r) {
+            int i = a.fila[t * SELL_C + r];
+            long largo = (i >= 0) ? m->inicio[i + 1] - m->inicio[i] : 0;
+            for (int j = 0; j < a.ancho[t]; ++j) {
+                long p = a.inicio[t] + (long)j * SELL_C + r;
+                a.col[p] = (j < largo) ? m->col[m->inicio[i] + j] : 0;
+                a.val[p] = (j < largo) ? m->val[m->inicio[i] + j] : 0.0;
+            }
+        }
+    }
+    return a;
+}
+
+inline void liberar_sell(Sell* a) {
+    free(a->inicio);
+    free(a->ancho);
+    free(a->fila);
+    free(a->col);
+    free(a->val);
+}
+
+// Operaciones y bytes de un barrido, para el rendimiento. Las operaciones útiles son 2 por no
+// nulo fuera de la diagonal y 5 por fila; los bytes son el tráfico mínimo: la matriz con su
+// relleno (valor y columna), la fila de cada posición, y leer b, 1 / a_ii y x y escribir el
+// nuevo x una vez por fila (se supone que las lecturas indirectas de x aciertan en caché).
+inline double operaciones_barrido(const Sell* a) {
+    return 2.0 * a->nnz + 5.0 * a->filas;
+}
+
+inline double bytes_barrido(const Sell* a) {
+    return a->almacenados * (double)(sizeof(double) + sizeof(int)) + (double)a->num_trozos * SELL_C * sizeof(int) +
+           a->filas * 4.0 * sizeof(double);
+}
+
+// Barrido del trozo t de ent a sal. El cambio de la fila i es r_i / a_ii, así que si MEDIR se
+// devuelve la suma de los cuadrados del residuo b - A x de ent en esas filas.
+template <bool MEDIR>
+inline double barrido_trozo(const Sell* a, int t, const double* __restrict inv_diagonal, const double* __restrict b,
+                            const double* __restrict ent, double* __restrict sal, double omega) {
+    const double* __restrict v = a->val + a->inicio[t];
+    const int* __restrict c = a->col + a->inicio[t];
+    double s[SELL_C];
+    double suma = 0.0;
+
+    for (int r = 0; r < SELL_C; ++r)
+        s[r] = 0.0;
+    for (int j = 0; j < a->ancho[t]; ++j) {
+        #pragma omp simd
+        for (int r = 0; r < SELL_C; ++r)
+            s[r] += v[j * SELL_C + r] * ent[c[j * SELL_C + r]];
+    }
+    for (int r = 0; r < SELL_C; ++r) {
+        int i = a->fila[t * SELL_C + r];
+        if (i < 0)
+            continue;
+        double d = (b[i] - s[r]) * inv_diagonal[i] - ent[i];
+        sal[i] = ent[i] + omega * d;
+        if (MEDIR) {
+            double residuo = d / inv_diagonal[i];
+            suma += residuo * residuo;
+        }
+    }
+    return suma;
+}
+
+// Barrido completo repartiendo los trozos entre los hilos de OpenMP
+template <bool MEDIR>
+double barrido_sell(const Sell* a, const double* inv_diagonal, const double* b, const double* ent, double* sal,
+                    double omega) {
+    double suma = 0.0;
+    #pragma omp parallel for schedule(static) reduction(+:suma)
+    for (int t = 0; t < a->num_trozos; ++t)
+        suma += barrido_trozo<MEDIR>(a, t, inv_diagonal, b, ent, sal, omega);
+    return suma;
+}
+
+// Jacobi (ponderado) con OpenMP sobre la estructura de jacobi: alterna entre x y un temporal
+// y, si tol > 0, cada 'cada' barridos mide dentro del propio barrido el residuo relativo
+// ||b - A x|| / ||b|| y se detiene en cuanto es menor que tol. Devuelve el número de barridos
+// realizados y deja en *residuo la última norma medida.
+inline int jacobi_sell(int num_barridos, const Sell* a, const double* inv_diagonal, double* x, const double* b,
+                       double omega, double tol, int cada, double* residuo) {
+    double* tmp = (double*)reservar_alineado(a->filas * sizeof(double));
+    double* ent = x;
+    double* sal = tmp;
+    double norma_b = 0.0;
+    int barrido_actual, desde_chequeo = 0;
+
+    for (int i = 0; i < a->filas; ++i)
+        norma_b += b[i] * b[i];
+    norma_b = (norma_b > 0) ? sqrt(norma_b) : 1.0;
+
+    for (barrido_actual = 0; barrido_actual < num_barridos; ++barrido_actual) {
+        int medir = 0;
+        if (tol > 0 && ++desde_chequeo >= cada) {
+            medir = 1;
+            desde_chequeo = 0;
+        }
+
+        if (medir)
+            *residuo = sqrt(barrido_sell<true>(a, inv_diagonal, b, ent, sal, omega)) / norma_b;
+        else
+            barrido_sell<false>(a, inv_diagonal, b, ent, sal, omega);
+        double* t = ent;
+        ent = sal;
+        sal = t;
+        if (medir && *residuo < tol) {
+            ++barrido_actual;
+            break;
+        }
+    }
+
+    if (ent != x)
+        memcpy(x, ent, a->filas * sizeof(double));
+    free(tmp);
+    return barrido_actual;
+}
+
+// Ancho de banda de la tríada de STREAM (a = b + s c) con arreglos de 'elementos' doubles, en
+// bytes por segundo; referencia para la utilización del ancho de banda. Se usa el mejor de
+// varios intentos.
+inline double medir_triada(long elementos, double (*reloj)(void)) {
+    double* x = (double*)reservar_alineado(elementos * sizeof(double));
+    double* y = (double*)reservar_alineado(elementos * sizeof(double));
+    double* z = (double*)reservar_alineado(elementos * sizeof(double));
+    double mejor = 0.0;
+
+    #pragma omp parallel for schedule(static)
+    for (long i = 0; i < elementos; ++i) {
+        x[i] = 0.0;
+        y[i] = 1.0;
+        z[i] = 2.0;
+    }
+    for (int intento = 0; intento < 5; ++intento) {
+        double inicio = reloj();
+        #pragma omp parallel for schedule(static)
+        for (long i = 0; i < elementos; ++i)
+            x[i] = y[i] + 3.0 * z[i];
+        double t = reloj() - inicio;
+        if (x[elementos / 2] != 7.0) {  // Comprobación, y para que el compilador no quite el bucle
+            mejor = 0.0;
+            break;
+        }
+        if (t > 0 && 3.0 * elementos * sizeof(double) / t > mejor)
+            mejor = 3.0 * elementos * sizeof(double) / t;
+    }
+    free(x);
+    free(y);
+    free(z);
+    return mejor;
+}
+
+#endif
@@ -0,0 +1,327 @@
+// Motor genérico de stencils para Jacobi en 2D y 3D.
+// Generaliza el núcleo 1D (u[i-1] + u[i+1] + h2 * f[i]) / 2 de jacobiOpenMp.cpp a un patrón de
+// coeficientes cualquiera: cada barrido calcula
+//     u_nuevo = (suma de peso[v] * u[vecino v] + h2 * f) / DIAGONAL
+// para la discretización -Laplaciano(u) = f con frontera de Dirichlet.
+// Las mallas se guardan con relleno para que cada fila empiece alineada a 64 bytes, los
+// barridos recorren la malla por bloques que caben en caché y el bucle interno se vectoriza
+// con omp simd. Hay dos backends sobre el mismo núcleo: OpenMP y pthreads.
+// Requiere _POSIX_C_SOURCE >= 200112L (posix_memalign y barreras de pthreads).
+#ifndef STENCIL_HPP
+#define STENCIL_HPP
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+#define STENCIL_ALINEACION 8    // Elementos double por línea de caché de 64 bytes
+#define STENCIL_BLOQUE_I 512    // Tamaño de los bloques de caché en cada dimensión
+#define STENCIL_BLOQUE_J 16
+#define STENCIL_BLOQUE_K 16
+
+// Patrones de coeficientes. desp son los desplazamientos (i, j, k) de los vecinos y peso sus
+// coeficientes en h2 * (-Laplaciano); DIAGONAL es el coeficiente del punto central.
+
+// Laplaciano 2D de 5 puntos
+struct Laplaciano5 {
+    static const int DIM = 2;
+    static const int NUM = 4;
+    static constexpr int desp[NUM][3] = {{-1, 0, 0}, {1, 0, 0}, {0, -1, 0}, {0, 1, 0}};
+    static constexpr double peso[NUM] = {1, 1, 1, 1};
+    static constexpr double DIAGONAL = 4.0;
+};
+
+// Laplaciano 3D de 7 puntos
+struct Laplaciano7 {
+    static const int DIM = 3;
+    static const int NUM = 6;
+    static constexpr int desp[NUM][3] = {{-1, 0, 0}, {1, 0, 0}, {0, -1, 0}, {0, 1, 0}, {0, 0, -1}, {0, 0, 1}};
+    static constexpr double peso[NUM] = {1, 1, 1, 1, 1, 1};
+    static constexpr double DIAGONAL = 6.0;
+};
+
+// Laplaciano 3D isótropo de 27 puntos: caras 7/15, aristas 1/10 y esquinas 1/30
+struct Laplaciano27 {
+    static const int DIM = 3;
+    static const int NUM = 26;
+    static constexpr int desp[NUM][3] = {
+        {-1, 0, 0}, {1, 0, 0}, {0, -1, 0}, {0, 1, 0}, {0, 0, -1}, {0, 0, 1},
+        {-1, -1, 0}, {1, -1, 0}, {-1, 1, 0}, {1, 1, 0},
+        {-1, 0, -1}, {1, 0, -1}, {-1, 0, 1}, {1, 0, 1},
+        {0, -1, -1}, {0, 1, -1}, {0, -1, 1}, {0, 1, 1},
+        {-1, -1, -1}, {1, -1, -1}, {-1, 1, -1}, {1, 1, -1},
+        {-1, -1, 1}, {1, -1, 1}, {-1, 1, 1}, {1, 1, 1}};
+    static constexpr double peso[NUM] = {
+        7.0 / 15, 7.0 / 15, 7.0 / 15, 7.0 / 15, 7.0 / 15, 7.0 / 15,
+        0.1, 0.1, 0.1, 0.1, 0.1, 0.1, 0.1, 0.1, 0.1, 0.1, 0.1, 0.1,
+        1.0 / 30, 1.0 / 30, 1.0 / 30, 1.0 / 30, 1.0 / 30, 1.0 / 30, 1.0 / 30, 1.0 / 30};
+    static constexpr double DIAGONAL = 64.0 / 15;
+};
+
+// Disposición en memoria de una malla de DIM dimensiones con puntos 0..n[d] en cada una
+// (los extremos son frontera o celdas fantasma). Varios campos (u, f, temporal) comparten
+// la misma disposición.
+template <int DIM>
+struct Malla {
+    int n[3];        // Intervalos por dimensión (n[2] = 0 en 2D)
+    long paso[3];    // Distancia en memoria entre puntos vecinos de cada dimensión
+    long desfase;    // Relleno inicial para que el punto (1, j, k) quede alineado
+    size_t total;    // Elementos por campo, incluido el relleno
+
+    long indice(int i, int j, int k) const { return desfase + i + j * paso[1] + k * paso[2]; }
+};
+
+// Construye la disposición: las filas se rellenan hasta un múltiplo de la línea de caché
+template <int DIM>
+Malla<DIM> crear_malla(int nx, int ny, int nz) {
+    Malla<DIM> m;
+    m.n[0] = nx;
+    m.n[1] = ny;
+    m.n[2] = (DIM == 3) ? nz : 0;
+    m.paso[0] = 1;
+    m.paso[1] = (nx + 1 + STENCIL_ALINEACION - 1) / STENCIL_ALINEACION * STENCIL_ALINEACION;
+    m.paso[2] = (DIM == 3) ? m.paso[1] * (ny + 1) : 0;
+    m.desfase = STENCIL_ALINEACION - 1;
+    m.total = m.desfase + (size_t)m.paso[1] * (ny + 1) * (m.n[2] + 1) + STENCIL_ALINEACION;
+    return m;
+}
+
+// Reserva un campo alineado a 64 bytes e inicializado en cero
+template <int DIM>
+double* crear_campo(const Malla<DIM>& m) {
+    void* p = NULL;
+    if (posix_memalign(&p, STENCIL_ALINEACION * sizeof(double), m.total * sizeof(double)) != 0)
+        return NULL;
+    memset(p, 0, m.total * sizeof(double));
+    return (double*)p;
+}
+
+// Norma L2 discreta del residuo a partir de la suma de los cuadrados de los cambios de un
+// barrido (el cambio de cada punto es h2 / DIAGONAL veces su residuo)
+template <class Patron>
+double norma_residuo(double suma, double h) {
+    return (Patron::DIAGONAL / (h * h)) * sqrt(pow(h, Patron::DIM) * suma);
+}
+
+// Bloques de caché: los puntos interiores se recorren en bloques de
+// STENCIL_BLOQUE_I x STENCIL_BLOQUE_J (x STENCIL_BLOQUE_K en 3D) numerados de forma lineal
+template <int DIM>
+int numero_bloques(const Malla<DIM>& m) {
+    int bi = (m.n[0] - 1 + STENCIL_BLOQUE_I - 1) / STENCIL_BLOQUE_I;
+    int bj = (m.n[1] - 1 + STENCIL_BLOQUE_J - 1) / STENCIL_BLOQUE_J;
+    int bk = (DIM == 3) ? (m.n[2] - 1 + STENCIL_BLOQUE_K - 1) / STENCIL_BLOQUE_K : 1;
+    return bi * bj * bk;
+}
+
+// Barrido de Jacobi sobre el bloque b, de ent a sal. Si MEDIR, devuelve la suma de los
+// cuadrados de los cambios.
+template <class Patron, bool MEDIR>
+double barrido_bloque(const Malla<Patron::DIM>& m, int b, const double* __restrict ent, double* __restrict sal,
+                      const double* __restrict f, double h2) {
+    const int DIM = Patron::DIM;
+    int bi = (m.n[0] - 1 + STENCIL_BLOQUE_I - 1) / STENCIL_BLOQUE_I;
+    int bj = (m.n[1] - 1 + STENCIL_BLOQUE_J - 1) / STENCIL_BLOQUE_J;
+    int i0 = 1 + (b % bi) * STENCIL_BLOQUE_I;
+    int j0 = 1 + (b / bi % bj) * STENCIL_BLOQUE_J;
+    int k0 = (DIM == 3) ? 1 + (b / bi / bj) * STENCIL_BLOQUE_K : 0;
+    int i1 = (i0 + STENCIL_BLOQUE_I < m.n[0]) ? i0 + STENCIL_BLOQUE_I : m.n[0];
+    int j1 = (j0 + STENCIL_BLOQUE_J < m.n[1]) ? j0 + STENCIL_BLOQUE_J : m.n[1];
+    int k1 = (DIM == 3) ? ((k0 + STENCIL_BLOQUE_K < m.n[2]) ? k0 + STENCIL_BLOQUE_K : m.n[2]) : 1;
+
+    // Desplazamientos de los vecinos en memoria
+    long vecino[Patron::NUM];
+    for (int v = 0; v < Patron::NUM; ++v)
+        vecino[v] = Patron::desp[v][0] + Patron::desp[v][1] * m.paso[1] + Patron::desp[v][2] * m.paso[2];
+    const double inv_diagonal = 1.0 / Patron::DIAGONAL;
+
+    double suma = 0.0;
+    for (int k = k0; k < k1; ++k) {
+        for (int j = j0; j < j1; ++j) {
+            long base = m.indice(0, j, k);
+            #pragma omp simd reduction(+:suma)
+            for (int i = i0; i < i1; ++i) {
+                long p = base + i;
+                double s = h2 * f[p];
+                for (int v = 0; v < Patron::NUM; ++v)
+                    s += Patron::peso[v] * ent[p + vecino[v]];
+                double nuevo = s * inv_diagonal;
+                if (MEDIR) {
+                    double d = nuevo - ent[p];
+                    suma += d * d;
+                }
+                sal[p] = nuevo;
+            }
+        }
+    }
+    return suma;
+}
+
+// Barrido completo de ent a sal repartiendo los bloques entre los hilos de OpenMP
+template <class Patron, bool MEDIR>
+double barrido(const Malla<Patron::DIM>& m, const double* ent, double* sal, const double* f, double h2) {
+    int num_bloques = numero_bloques(m);
+    double suma = 0.0;
+    #pragma omp parallel for schedule(static) reduction(+:suma)
+    for (int b = 0; b < num_bloques; ++b)
+        suma += barrido_bloque<Patron, MEDIR>(m, b, ent, sal, f, h2);
+    return suma;
+}
+
+// Jacobi con OpenMP: alterna entre u y un campo temporal. Si tol > 0, cada 'cada' barridos
+// mide el residuo dentro del propio barrido y se detiene en cuanto es menor que tol.
+// Devuelve el número de barridos realizados y deja en *residuo la última norma medida.
+template <class Patron>
+int jacobi_omp(int num_barridos, const Malla<Patron::DIM>& m, double* u, const double* f, double tol, int cada,
+               double* residuo) {
+    double h = 1.0 / m.n[0];
+    double h2 = h * h;
+    double* tmp = crear_campo(m);
+    memcpy(tmp, u, m.total * sizeof(double));  // La frontera es la misma en ambos campos
+    double* ent = u;
+    double* sal = tmp;
+    int barrido_actual, desde_chequeo = 0;
+
+    for (barrido_actual = 0; barrido_actual < num_barridos; ++barrido_actual) {
+        int medir = 0;
+        if (tol > 0 && ++desde_chequeo >= cada) {
+            medir = 1;
+            desde_chequeo = 0;
+        }
+
+        if (medir)
+            *residuo = norma_residuo<Patron>(barrido<Patron, true>(m, ent, sal, f, h2), h);
+        else
+            barrido<Patron, false>(m, ent, sal, f, h2);
+        double* t = ent;
+        ent = sal;
+        sal = t;
+        if (medir && *residuo < tol) {
+            ++barrido_actual;
+            break;
+        }
+    }
+
+    if (ent != u)
+        memcpy(u, ent, m.total * sizeof(double));
+    free(tmp);
+    return barrido_actual;
+}
+
+// Backend de pthreads: hilos persistentes que se reparten bloques contiguos y se sincronizan
+// con una barrera al final de cada barrido
+template <class Patron>
+struct StencilCompartido {
+    const Malla<Patron::DIM>* m;
+    int num_hilos, num_barridos, cada;
+    double h, h2, tol;
+    double* u;
+    double* tmp;
+    const double* f;
+    double* sumas;      // Suma parcial de cada hilo
+    int parar;
+    int barridos;
+    double residuo;
+    pthread_barrier_t barrera;
+};
+
+template <class Patron>
+struct StencilHilo {
+    int id;
+    StencilCompartido<Patron>* s;
+};
+
+template <class Patron>
+void* hilo_stencil(void* arg) {
+    StencilHilo<Patron>* datos = (StencilHilo<Patron>*)arg;
+    StencilCompartido<Patron>* s = datos->s;
+    int num_bloques = numero_bloques(*s->m);
+    int b0 = (int)((long)num_bloques * datos->id / s->num_hilos);
+    int b1 = (int)((long)num_bloques * (datos->id + 1) / s->num_hilos);
+    double* ent = s->u;
+    double* sal = s->tmp;
+    int desde_chequeo = 0;
+
+    for (int barrido_actual = 0; barrido_actual < s->num_barridos; ++barrido_actual) {
+        int medir = 0;
+        if (s->tol > 0 && ++desde_chequeo >= s->cada) {
+            medir = 1;
+            desde_chequeo = 0;
+        }
+
+        double suma = 0.0;
+        for (int b = b0; b < b1; ++b) {
+            if (medir)
+                suma += barrido_bloque<Patron, true>(*s->m, b, ent, sal, s->f, s->h2);
+            else
+                barrido_bloque<Patron, false>(*s->m, b, ent, sal, s->f, s->h2);
+        }
+        double* t = ent;
+        ent = sal;
+        sal = t;
+
+        if (medir) {
+            s->sumas[datos->id] = suma;
+            // Un único hilo reduce las sumas parciales y decide si se detiene
+            if (pthread_barrier_wait(&s->barrera) == PTHREAD_BARRIER_SERIAL_THREAD) {
+                double total = 0.0;
+                for (int t = 0; t < s->num_hilos; ++t)
+                    total += s->sumas[t];
+                s->residuo = norma_residuo<Patron>(total, s->h);
+                if (s->residuo < s->tol) {
+                    s->parar = 1;
+                    s->barridos = barrido_actual + 1;
+                }
+            }
+        }
+        pthread_barrier_wait(&s->barrera);
+        if (s->parar)
+            break;
+    }
+    return NULL;
+}
+
+// Jacobi con pthreads; mismo criterio de parada y valor de retorno que jacobi_omp
+template <class Patron>
+int jacobi_hilos(int num_barridos, int num_hilos, const Malla<Patron::DIM>& m, double* u, const double* f, double tol,
+                 int cada, double* residuo) {
+    StencilCompartido<Patron> s;
+    pthread_t hilos[num_hilos];
+    StencilHilo<Patron> datos[num_hilos];
+
+    s.m = &m;
+    s.num_hilos = num_hilos;
+    s.num_barridos = num_barridos;
+    s.cada = cada;
+    s.h = 1.0 / m.n[0];
+    s.h2 = s.h * s.h;
+    s.tol = tol;
+    s.u = u;
+    s.tmp = crear_campo(m);
+    memcpy(s.tmp, u, m.total * sizeof(double));
+    s.f = f;
+    s.sumas = (double*)calloc(num_hilos, sizeof(double));
+    s.parar = 0;
+    s.barridos = num_barridos;
+    s.residuo = *residuo;
+
+    pthread_barrier_init(&s.barrera, NULL, num_hilos);
+    for (int t = 0; t < num_hilos; ++t) {
+        datos[t].id = t;
+        datos[t].s = &s;
+        pthread_create(&hilos[t], NULL, hilo_stencil<Patron>, &datos[t]);
+    }
+    for (int t = 0; t < num_hilos; ++t)
+        pthread_join(hilos[t], NULL);
+    pthread_barrier_destroy(&s.barrera);
+
+    // Tras un número impar de barridos el resultado quedó en el temporal
+    if (s.barridos % 2 == 1)
+        memcpy(u, s.tmp, m.total * sizeof(double));
+    *residuo = s.residuo;
+    free(s.tmp);
+    free(s.sumas);
+    return s.barridos;
+}
+
+#endif
@@ -0,0 +1,120 @@
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <omp.h>
+#include "stencil.hpp"
+
+// Valores por defecto
+#define N_DEFECTO 256
+#define ITERACIONES_DEFECTO 1000
+#define HILOS_DEFECTO 4
+
+// Prueba del motor de stencils con el problema -Laplaciano(u) = f en el cubo unidad con
+// u = 0 en la frontera. f se elige para que la solución sea el producto de x (1 - x) en cada
+// dimensión, que los Laplacianos de 5 y 7 puntos reproducen exactamente en la malla.
+template <class Patron>
+int resolver(int n, int num_iteraciones, int num_hilos, const char* backend, double tol, int cada) {
+    const int DIM = Patron::DIM;
+    Malla<DIM> m = crear_malla<DIM>(n, n, n);
+    double* u = crear_campo(m);
+    double* f = crear_campo(m);
+    double h = 1.0 / n;
+    double residuo = -1.0;
+    double tiempo_inicio, tiempo_fin;
+    int realizadas;
+    int kmax = (DIM == 3) ? n : 0;
+
+    // Inicialización de la fuente
+    for (int k = 0; k <= kmax; ++k) {
+        for (int j = 0; j <= n; ++j) {
+            for (int i = 0; i <= n; ++i) {
+                double q[3] = {i * h * (1 - i * h), j * h * (1 - j * h), k * h * (1 - k * h)};
+                double suma = 0.0;
+                for (int d = 0; d < DIM; ++d) {
+                    double producto = 2.0;
+                    for (int e = 0; e < DIM; ++e)
+                        if (e != d)
+                            producto *= q[e];
+                    suma += producto;
+                }
+                f[m.indice(i, j, k)] = suma;
+            }
+        }
+    }
+
+    tiempo_inicio = omp_get_wtime();
+    if (strcmp(backend, "hilos") == 0)
+        realizadas = jacobi_hilos<Patron>(num_iteraciones, num_hilos, m, u, f, tol, cada, &residuo);
+    else
+        realizadas = jacobi_omp<Patron>(num_iteraciones, m, u, f, tol, cada, &residuo);
+    tiempo_fin = omp_get_wtime();
+
+    // Error máximo respecto a la solución del problema continuo
+    double error = 0.0;
+    for (int k = 0; k <= kmax; ++k) {
+        for (int j = 0; j <= n; ++j) {
+            for (int i = 0; i <= n; ++i) {
+                double exacta = i * h * (1 - i * h) * j * h * (1 - j * h);
+                if (DIM == 3)
+                    exacta *= k * h * (1 - k * h);
+                double d = fabs(u[m.indice(i, j, k)] - exacta);
+                if (d > error)
+                    error = d;
+            }
+        }
+    }
+
+    printf("\nTiempo de ejecución: %f segundos\n", tiempo_fin - tiempo_inicio);
+    printf("Puntos actualizados por segundo: %e\n", pow(n - 1, DIM) * realizadas / (tiempo_fin - tiempo_inicio));
+    if (tol > 0)
+        printf("Iteraciones: %d, residuo final: %e\n", realizadas, residuo);
+    printf("Error máximo: %e\n", error);
+
+    free(f);
+    free(u);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    int i, n, num_iteraciones, num_hilos;
+    int puntos = 5;             // Patrón del stencil: 5 (2D), 7 o 27 (3D)
+    const char* backend = "omp"; // Backend: omp o hilos
+    double tol = 0.0;           // Tolerancia del residuo (0 = sin criterio de parada)
+    int cada = 10;              // Iteraciones entre mediciones del residuo
+    char* args[3] = {NULL, NULL, NULL};
+    int nargs = 0;
+
+    // Separación de las opciones (--stencil <5|7|27>, --backend <omp|hilos>, --tol <valor>,
+    // --cada <k>) y los argumentos posicionales
+    for (i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--stencil") == 0 && i + 1 < argc)
+            puntos = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--backend") == 0 && i + 1 < argc)
+            backend = argv[++i];
+        else if (strcmp(argv[i], "--tol") == 0 && i + 1 < argc)
+            tol = atof(argv[++i]);
+        else if (strcmp(argv[i], "--cada") == 0 && i + 1 < argc)
+            cada = atoi(argv[++i]);
+        else if (nargs < 3)
+            args[nargs++] = argv[i];
+    }
+
+    // Lectura de argumentos o uso de valores por defecto
+    n = (nargs > 0) ? atoi(args[0]) : N_DEFECTO;
+    num_iteraciones = (nargs > 1) ? atoi(args[1]) : ITERACIONES_DEFECTO;
+    num_hilos = (nargs > 2) ? atoi(args[2]) : HILOS_DEFECTO;
+
+    omp_set_num_threads(num_hilos);
+
+    if (puntos == 5)
+        return resolver<Laplaciano5>(n, num_iteraciones, num_hilos, backend, tol, cada);
+    if (puntos == 7)
+        return resolver<Laplaciano7>(n, num_iteraciones, num_hilos, backend, tol, cada);
+    if (puntos == 27)
+        return resolver<Laplaciano27>(n, num_iteraciones, num_hilos, backend, tol, cada);
+
+    printf("Error: stencil de %d puntos no soportado (5, 7 o 27).\n", puntos);
+    return 1;
+}
@@ -1,87 +1,1336 @@
-#include <mpi.h>
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-
-#define N_POR_DEFECTO 100000
-#define PASOS_POR_DEFECTO 1000
-
-// Funcin que aplica el mtodo de Jacobi en paralelo
-void jacobi(int pasos, int n_local, int n_total, double* u_local, double* f_local, int rango, int num_procesos) {
-    double h = 1.0 / n_total;
-    double h2 = h * h;
-    double* tmp = malloc((n_local + 2) * sizeof(double)); // incluye celdas fantasma
-
-    for (int paso = 0; paso < pasos; ++paso) {
-        // Intercambio de bordes con procesos vecinos
-        if (rango > 0)
-            MPI_Sendrecv(&u_local[1], 1, MPI_DOUBLE, rango - 1, 0,
-                         &u_local[0], 1, MPI_DOUBLE, rango - 1, 0,
-                         MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-
-        if (rango < num_procesos - 1)
-            MPI_Sendrecv(&u_local[n_local], 1, MPI_DOUBLE, rango + 1, 0,
-                         &u_local[n_local + 1], 1, MPI_DOUBLE, rango + 1, 0,
-                         MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-
-        // Clculo del nuevo valor en cada punto local
-        for (int i = 1; i <= n_local; ++i) {
-            tmp[i] = (u_local[i - 1] + u_local[i + 1] + h2 * f_local[i]) / 2.0;
-        }
-
-        // Intercambio de punteros para la siguiente iteracin
-        double* aux = u_local;
-        u_local = tmp;
-        tmp = aux;
-    }
-
-    free(tmp);
-}
-
-int main(int argc, char** argv) {
-    int n = N_POR_DEFECTO;          // Tamao total del dominio
-    int pasos = PASOS_POR_DEFECTO;  // Nmero de barridos del mtodo Jacobi
-
-    if (argc > 1) n = atoi(argv[1]);
-    if (argc > 2) pasos = atoi(argv[2]);
-
-    MPI_Init(&argc, &argv);
-    int rango, num_procesos;
-    MPI_Comm_rank(MPI_COMM_WORLD, &rango);
-    MPI_Comm_size(MPI_COMM_WORLD, &num_procesos);
-
-    // Verifica que n sea divisible por el nmero de procesos
-    if (n % num_procesos != 0) {
-        if (rango == 0)
-            printf("Error: N debe ser divisible por el nmero de procesos.\n");
-        MPI_Finalize();
-        return 1;
-    }
-
-    int n_local = n / num_procesos;
-
-    // u_local tiene celdas adicionales en los extremos para los valores fantasma
-    double* u_local = calloc(n_local + 2, sizeof(double));
-    double* f_local = malloc((n_local + 2) * sizeof(double));
-
-    // Inicializacin del vector f_local
-    double h = 1.0 / n;
-    for (int i = 1; i <= n_local; ++i) {
-        int i_global = rango * n_local + i;
-        f_local[i] = i_global * h;  // Ejemplo simple de funcin fuente
-    }
-
-    // Medicin del tiempo de ejecucin
-    double tiempo_inicio = MPI_Wtime();
-    jacobi(pasos, n_local, n, u_local, f_local, rango, num_procesos);
-    double tiempo_fin = MPI_Wtime();
-
-    if (rango == 0)
-        printf("Tiempo de ejecucin: %f segundos\n", tiempo_fin - tiempo_inicio);
-
-    free(u_local);
-    free(f_local);
-    MPI_Finalize();
-    return 0;
-}
-
+#include <mpi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../reto 1/Codigo/spectrum.h"
+
+#define N_POR_DEFECTO 100000
+#define PASOS_POR_DEFECTO 1000
+
+// Parámetros del multigrid
+#define MG_PRE_SUAVIZADO 2      // Barridos de suavizado antes de bajar de nivel
+#define MG_POST_SUAVIZADO 2     // Barridos de suavizado después de subir de nivel
+#define MG_PESO (2.0 / 3.0)     // Peso del Jacobi ponderado usado como suavizador
+#define MG_N_MINIMO 4           // No se crea un nivel con menos intervalos que este
+#define MG_LOCAL_MINIMO 64      // Por debajo de estos puntos por proceso se aglomera en el rango 0
+
+// Parámetros del halo ancho
+#define HALO_MAXIMO 64          // Profundidad máxima que prueba el ajuste automático
+#define HALO_PASOS_PRUEBA 256   // Pasos de Jacobi medidos por cada profundidad candidata
+
+// Tamaño de los trozos del interior que se reparten los hilos en el modo híbrido
+#define HIBRIDO_BLOQUE 4096
+
+// Ancho fijo de cada línea del archivo de texto: "% .10e % .16e\n"
+#define ANCHO_LINEA 42
+
+// Intercambio de bordes con procesos vecinos: envía los puntos extremos de v y recibe
+// las celdas fantasma v[0] y v[n_local + 1]
+void intercambiar_bordes(double* v, int n_local, int rango, int num_procesos) {
+    if (rango > 0)
+        MPI_Sendrecv(&v[1], 1, MPI_DOUBLE, rango - 1, 0,
+                     &v[0], 1, MPI_DOUBLE, rango - 1, 0,
+                     MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+    if (rango < num_procesos - 1)
+        MPI_Sendrecv(&v[n_local], 1, MPI_DOUBLE, rango + 1, 0,
+                     &v[n_local + 1], 1, MPI_DOUBLE, rango + 1, 0,
+                     MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+}
+
+// Intercambio de k celdas fantasma por lado en un arreglo con halo ancho: v[0..k-1] y
+// v[k + n_local..2k + n_local - 1] son fantasma y los puntos propios van de v[k] a
+// v[k + n_local - 1]. Requiere que los vecinos tengan al menos k puntos.
+void intercambiar_bordes_ancho(double* v, int n_local, int k, int rango, int num_procesos) {
+    if (rango > 0)
+        MPI_Sendrecv(&v[k], k, MPI_DOUBLE, rango - 1, 0,
+                     &v[0], k, MPI_DOUBLE, rango - 1, 0,
+                     MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+    if (rango < num_procesos - 1)
+        MPI_Sendrecv(&v[n_local], k, MPI_DOUBLE, rango + 1, 0,
+                     &v[n_local + k], k, MPI_DOUBLE, rango + 1, 0,
+                     MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+}
+
+// Versión no bloqueante: publica la recepción de las dos celdas fantasma y el envío de los
+// dos puntos extremos, y devuelve cuántas peticiones quedaron en peticiones[0..3]
+int iniciar_intercambio(double* v, int n_local, int rango, int num_procesos, MPI_Request* peticiones) {
+    int num = 0;
+    if (rango > 0) {
+        MPI_Irecv(&v[0], 1, MPI_DOUBLE, rango - 1, 0, MPI_COMM_WORLD, &peticiones[num++]);
+        MPI_Isend(&v[1], 1, MPI_DOUBLE, rango - 1, 0, MPI_COMM_WORLD, &peticiones[num++]);
+    }
+    if (rango < num_procesos - 1) {
+        MPI_Irecv(&v[n_local + 1], 1, MPI_DOUBLE, rango + 1, 0, MPI_COMM_WORLD, &peticiones[num++]);
+        MPI_Isend(&v[n_local], 1, MPI_DOUBLE, rango + 1, 0, MPI_COMM_WORLD, &peticiones[num++]);
+    }
+    return num;
+}
+
+// Paso de Jacobi sobre los puntos desde..hasta, de u a tmp. Si medir es 1 devuelve la suma
+// de los cuadrados de los cambios.
+static double actualizar_puntos(int desde, int hasta, const double* u, double* tmp, const double* f, double h2,
+                                int medir) {
+    double suma = 0.0;
+    if (medir) {
+        for (int i = desde; i <= hasta; ++i) {
+            double nuevo = (u[i - 1] + u[i + 1] + h2 * f[i]) / 2.0;
+            double d = nuevo - u[i];
+            suma += d * d;
+            tmp[i] = nuevo;
+        }
+    } else {
+        for (int i = desde; i <= hasta; ++i)
+            tmp[i] = (u[i - 1] + u[i + 1] + h2 * f[i]) / 2.0;
+    }
+    return suma;
+}
+
+// Función que aplica el método de Jacobi en paralelo
+// Cada proceso guarda n_local puntos consecutivos de la malla global en u_local[1..n_local];
+// el punto global 0 (primer punto local del rango 0) y el punto global n_total (celda
+// fantasma derecha del último rango) son condiciones de frontera y no se actualizan.
+// Si tol > 0, cada 'cada' pasos se acumula el residuo local durante el cálculo y se inicia
+// un MPI_Iallreduce que se completa en el paso siguiente, solapado con su cálculo.
+// Si solapar es 1, el intercambio de bordes es no bloqueante: mientras los mensajes viajan se
+// actualizan los puntos que no dependen de las celdas fantasma, y los dos extremos se
+// calculan después de MPI_Waitall.
+// Devuelve el número de pasos realizados y deja en *residuo la última norma medida.
+int jacobi(int pasos, int n_local, int n_total, double* u_local, double* f_local, int rango, int num_procesos,
+           double tol, int cada, int solapar, double* residuo) {
+    double h = 1.0 / n_total;
+    double h2 = h * h;
+    double* u_entrada = u_local; // arreglo del llamador, donde debe quedar la solución
+    double* buffer = calloc(n_local + 2, sizeof(double)); // incluye celdas fantasma
+    double* tmp = buffer;
+    int primero = (rango == 0) ? 2 : 1; // el rango 0 no actualiza la frontera izquierda
+    int desde_chequeo = 0;              // pasos desde la última medición del residuo
+    int pendiente = 0;                  // hay una reducción en curso
+    double suma_local = 0.0, suma_global = 0.0;
+    MPI_Request peticion;
+    MPI_Request bordes[4];
+    int paso;
+
+    // Las fronteras se copian también en el arreglo temporal
+    tmp[1] = u_local[1];
+    tmp[n_local + 1] = u_local[n_local + 1];
+
+    for (paso = 0; paso < pasos; ++paso) {
+        int medir = 0;
+        if (tol > 0 && !pendiente && ++desde_chequeo >= cada) {
+            medir = 1;
+            desde_chequeo = 0;
+        }
+
+        // Cálculo del nuevo valor en cada punto local, fusionado con la suma local del
+        // residuo (cambio * 2 / h2) si se mide
+        double suma;
+        if (solapar) {
+            int num_bordes = iniciar_intercambio(u_local, n_local, rango, num_procesos, bordes);
+            suma = actualizar_puntos((primero > 2) ? primero : 2, n_local - 1, u_local, tmp, f_local, h2, medir);
+            MPI_Waitall(num_bordes, bordes, MPI_STATUSES_IGNORE);
+            if (primero == 1)
+                suma += actualizar_puntos(1, 1, u_local, tmp, f_local, h2, medir);
+            if (n_local >= 2)
+                suma += actualizar_puntos(n_local, n_local, u_local, tmp, f_local, h2, medir);
+        } else {
+            // Intercambio de bordes con procesos vecinos
+            intercambiar_bordes(u_local, n_local, rango, num_procesos);
+            suma = actualizar_puntos(primero, n_local, u_local, tmp, f_local, h2, medir);
+        }
+        if (medir)
+            suma_local = suma;
+
+        // Intercambio de punteros para la siguiente iteración
+        double* aux = u_local;
+        u_local = tmp;
+        tmp = aux;
+
+        // La reducción iniciada en el paso anterior ya tuvo un barrido completo para avanzar
+        if (pendiente) {
+            MPI_Wait(&peticion, MPI_STATUS_IGNORE);
+            pendiente = 0;
+            *residuo = (2.0 / h2) * sqrt(h * suma_global);
+            if (*residuo < tol) {
+                ++paso;
+                break;
+            }
+        }
+        if (medir) {
+            MPI_Iallreduce(&suma_local, &suma_global, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD, &peticion);
+            pendiente = 1;
+        }
+    }
+
+    // Completa una reducción que haya quedado pendiente al agotar los pasos
+    if (pendiente) {
+        MPI_Wait(&peticion, MPI_STATUS_IGNORE);
+        *residuo = (2.0 / h2) * sqrt(h * suma_global);
+    }
+
+    // Si la solución quedó en el arreglo temporal, se copia al del llamador
+    if (u_local != u_entrada)
+        memcpy(u_entrada + 1, u_local + 1, n_local * sizeof(double));
+
+    free(buffer);
+    return paso;
+}
+
+// Contexto de la estimación del espectro repartida entre los procesos
+typedef struct {
+    int n_local, rango, num_procesos;
+} Espectro;
+
+// G del Laplaciano 1D sobre el bloque local, con las celdas fantasma al día
+static void aplicar_espectro(void* ctx, double* q, double* w, int primero, int ultimo) {
+    Espectro* e = (Espectro*)ctx;
+    intercambiar_bordes(q, e->n_local, e->rango, e->num_procesos);
+    spectral_laplacian(ctx, q, w, primero, ultimo);
+}
+
+static void sumar_espectro(void* ctx, double* valores, int cuantos) {
+    (void)ctx;
+    MPI_Allreduce(MPI_IN_PLACE, valores, cuantos, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+}
+
+// Cotas [alfa, beta] del espectro de la matriz de iteración de Jacobi (ver spectrum.h). Las
+// analíticas no necesitan comunicación; con Lanczos cada paso intercambia bordes y hace dos
+// reducciones, un costo que se paga una vez antes de resolver.
+void cotas_espectro(int n_local, int n_total, int rango, int num_procesos, int estimar, double* alfa,
+                    double* beta) {
+    if (!estimar) {
+        *beta = cos(acos(-1.0) / n_total);
+    } else {
+        Espectro e = {n_local, rango, num_procesos};
+        int primero = (rango == 0) ? 2 : 1; // El punto 1 del rango 0 es la frontera
+        *beta = spectral_lanczos(primero, n_local, n_total - 1, aplicar_espectro, sumar_espectro, &e);
+    }
+    *alfa = -*beta - SPECTRAL_MARGIN;
+}
+
+// Paso de Chebyshev sobre los puntos desde..hasta: escribe u_{k+1} encima de u_{k-1} (en
+// anterior) a partir de u_k (en actual). Si medir es 1 devuelve la suma de los cuadrados de
+// los cambios de Jacobi de u_k.
+static double actualizar_chebyshev(int desde, int hasta, const double* actual, double* anterior, const double* f,
+                                   double h2, double omega, double gamma, int medir) {
+    double suma = 0.0;
+    if (medir) {
+        for (int i = desde; i <= hasta; ++i) {
+            double d = (actual[i - 1] + actual[i + 1] + h2 * f[i]) / 2.0 - actual[i];
+            suma += d * d;
+            anterior[i] = omega * (actual[i] + gamma * d - anterior[i]) + anterior[i];
+        }
+    } else {
+        for (int i = desde; i <= hasta; ++i) {
+            double d = (actual[i - 1] + actual[i + 1] + h2 * f[i]) / 2.0 - actual[i];
+            anterior[i] = omega * (actual[i] + gamma * d - anterior[i]) + anterior[i];
+        }
+    }
+    return suma;
+}
+
+// Jacobi acelerado con Chebyshev (semi-iteración de Golub y Varga sobre [alfa, beta]): con J(u)
+// el paso de Jacobi, gamma = 2 / (2 - alfa - beta) y sigma = (beta - alfa) / (2 - alfa - beta),
+//     u_{k+1} = omega_{k+1} (gamma J(u_k) + (1 - gamma) u_k - u_{k-1}) + u_{k-1},
+//     omega_1 = 1, omega_2 = 1 / (1 - sigma^2 / 2), omega_{k+1} = 1 / (1 - sigma^2 omega_k / 4).
+// Los omega son los mismos en todos los rangos, así que cada paso sólo intercambia bordes con
+// los vecinos, como jacobi: no hay productos internos y las únicas reducciones son las del
+// residuo cada 'cada' pasos, solapadas igual que en jacobi. u_{k+1} se escribe encima de
+// u_{k-1}, con lo que usa los mismos arreglos. Baja los pasos de O(n^2) a O(n).
+// Mismo criterio de parada, opción solapar y valor de retorno que jacobi.
+int jacobi_chebyshev(int pasos, int n_local, int n_total, double* u_local, double* f_local, int rango,
+                     int num_procesos, double alfa, double beta, double tol, int cada, int solapar, double* residuo) {
+    double h = 1.0 / n_total;
+    double h2 = h * h;
+    double gamma = 2.0 / (2.0 - alfa - beta);
+    double sigma2 = (beta - alfa) * gamma / 2.0;
+    double omega = 1.0;
+    double* u_entrada = u_local;  // arreglo del llamador, donde debe quedar la solución
+    double* buffer = malloc((n_local + 2) * sizeof(double));
+    double* anterior = buffer;    // u_{k-1}, y luego u_{k+1}
+    int primero = (rango == 0) ? 2 : 1;
+    int desde_chequeo = 0;
+    int pendiente = 0;
+    double suma_local = 0.0, suma_global = 0.0;
+    MPI_Request peticion;
+    MPI_Request bordes[4];
+    int paso;
+
+    // u_{-1} = u_0, fronteras incluidas
+    sigma2 *= sigma2;
+    memcpy(anterior, u_local, (n_local + 2) * sizeof(double));
+
+    for (paso = 0; paso < pasos; ++paso) {
+        int medir = 0;
+        if (tol > 0 && !pendiente && ++desde_chequeo >= cada) {
+            medir = 1;
+            desde_chequeo = 0;
+        }
+
+        double suma;
+        if (solapar) {
+            int num_bordes = iniciar_intercambio(u_local, n_local, rango, num_procesos, bordes);
+            suma = actualizar_chebyshev((primero > 2) ? primero : 2, n_local - 1, u_local, anterior, f_local, h2,
+                                        omega, gamma, medir);
+            MPI_Waitall(num_bordes, bordes, MPI_STATUSES_IGNORE);
+            if (primero == 1)
+                suma += actualizar_chebyshev(1, 1, u_local, anterior, f_local, h2, omega, gamma, medir);
+            if (n_local >= 2)
+                suma += actualizar_chebyshev(n_local, n_local, u_local, anterior, f_local, h2, omega, gamma, medir);
+        } else {
+            intercambiar_bordes(u_local, n_local, rango, num_procesos);
+            suma = actualizar_chebyshev(primero, n_local, u_local, anterior, f_local, h2, omega, gamma, medir);
+        }
+        if (medir)
+            suma_local = suma;
+
+        double* aux = u_local;
+        u_local = anterior;
+        anterior = aux;
+        omega = (paso == 0) ? 1.0 / (1.0 - sigma2 / 2.0) : 1.0 / (1.0 - sigma2 * omega / 4.0);
+
+        // La reducción iniciada en el paso anterior ya tuvo un barrido completo para avanzar
+        if (pendiente) {
+            MPI_Wait(&peticion, MPI_STATUS_IGNORE);
+            pendiente = 0;
+            *residuo = (2.0 / h2) * sqrt(h * suma_global);
+            if (*residuo < tol) {
+                ++paso;
+                break;
+            }
+        }
+        if (medir) {
+            MPI_Iallreduce(&suma_local, &suma_global, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD, &peticion);
+            pendiente = 1;
+        }
+    }
+
+    if (pendiente) {
+        MPI_Wait(&peticion, MPI_STATUS_IGNORE);
+        *residuo = (2.0 / h2) * sqrt(h * suma_global);
+    }
+
+    if (u_local != u_entrada)
+        memcpy(u_entrada + 1, u_local + 1, n_local * sizeof(double));
+
+    free(buffer);
+    return paso;
+}
+
+// Jacobi con halo de profundidad k: cada k pasos se intercambian k celdas por lado y en los
+// k - 1 pasos siguientes no hay comunicación. En el paso s del bloque se actualiza también la
+// parte del halo que todavía es válida (se reduce en una celda por lado en cada paso), con
+// lo que se repite en la zona solapada el cálculo del vecino. Los valores de cada punto son
+// los mismos que con jacobi, así como los pasos realizados y el residuo.
+int jacobi_halo_ancho(int pasos, int n_local, int n_total, int k, double* u_local, double* f_local, int rango,
+                      int num_procesos, double tol, int cada, double* residuo) {
+    double h = 1.0 / n_total;
+    double h2 = h * h;
+    int largo = n_local + 2 * k;
+    double* u = calloc(largo, sizeof(double));
+    double* tmp = calloc(largo, sizeof(double));
+    double* f = calloc(largo, sizeof(double));
+    int propio = (rango == 0) ? k + 1 : k;  // primer punto propio que se actualiza
+    int ultimo = k + n_local - 1;            // último punto propio
+    int desde_chequeo = 0;
+    int pendiente = 0;
+    double suma_local = 0.0, suma_global = 0.0;
+    MPI_Request peticion;
+    int paso;
+
+    // Copia a la disposición con halo ancho; la frontera derecha del último rango queda en
+    // u[k + n_local] y la fuente del halo se intercambia una sola vez
+    memcpy(&u[k], &u_local[1], (n_local + 1) * sizeof(double));
+    memcpy(&f[k], &f_local[1], n_local * sizeof(double));
+    intercambiar_bordes_ancho(f, n_local, k, rango, num_procesos);
+    memcpy(tmp, u, largo * sizeof(double));
+
+    for (paso = 0; paso < pasos; ++paso) {
+        int s = paso % k;
+        if (s == 0)
+            intercambiar_bordes_ancho(u, n_local, k, rango, num_procesos);
+
+        int medir = 0;
+        if (tol > 0 && !pendiente && ++desde_chequeo >= cada) {
+            medir = 1;
+            desde_chequeo = 0;
+        }
+
+        // Zona válida en este paso: el halo menos s + 1 celdas por lado, salvo en las
+        // fronteras físicas. Sólo los puntos propios entran en el residuo.
+        int desde = (rango == 0) ? propio : s + 1;
+        int hasta = (rango == num_procesos - 1) ? ultimo : largo - 2 - s;
+        actualizar_puntos(desde, propio - 1, u, tmp, f, h2, 0);
+        double suma = actualizar_puntos(propio, ultimo, u, tmp, f, h2, medir);
+        actualizar_puntos(ultimo + 1, hasta, u, tmp, f, h2, 0);
+        if (medir)
+            suma_local = suma;
+
+        double* aux = u;
+        u = tmp;
+        tmp = aux;
+
+        // Mismo criterio de parada que jacobi
+        if (pendiente) {
+            MPI_Wait(&peticion, MPI_STATUS_IGNORE);
+            pendiente = 0;
+            *residuo = (2.0 / h2) * sqrt(h * suma_global);
+            if (*residuo < tol) {
+                ++paso;
+                break;
+            }
+        }
+        if (medir) {
+            MPI_Iallreduce(&suma_local, &suma_global, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD, &peticion);
+            pendiente = 1;
+        }
+    }
+
+    if (pendiente) {
+        MPI_Wait(&peticion, MPI_STATUS_IGNORE);
+        *residuo = (2.0 / h2) * sqrt(h * suma_global);
+    }
+
+    memcpy(&u_local[1], &u[k], n_local * sizeof(double));
+
+    free(u);
+    free(tmp);
+    free(f);
+    return paso;
+}
+
+// Intercambio de bordes de la corrección en float del modo de precisión mixta
+void intercambiar_bordes_float(float* v, int n_local, int rango, int num_procesos) {
+    if (rango > 0)
+        MPI_Sendrecv(&v[1], 1, MPI_FLOAT, rango - 1, 0,
+                     &v[0], 1, MPI_FLOAT, rango - 1, 0,
+                     MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+    if (rango < num_procesos - 1)
+        MPI_Sendrecv(&v[n_local], 1, MPI_FLOAT, rango + 1, 0,
+                     &v[n_local + 1], 1, MPI_FLOAT, rango + 1, 0,
+                     MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+}
+
+// Norma L2 discreta de f - A u / h2 calculada en double (operación colectiva; actualiza las
+// celdas fantasma de u_local)
+double norma_residuo(int n_local, int n_total, double* u_local, double* f_local, int rango, int num_procesos) {
+    double h = 1.0 / n_total;
+    double h2 = h * h;
+    double suma = 0.0;
+    intercambiar_bordes(u_local, n_local, rango, num_procesos);
+    for (int i = (rango == 0) ? 2 : 1; i <= n_local; ++i) {
+        double ri = h2 * f_local[i] + u_local[i - 1] + u_local[i + 1] - 2.0 * u_local[i];
+        suma += ri * ri;
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &suma, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    return (1.0 / h2) * sqrt(h * suma);
+}
+
+// Jacobi en precisión mixta con refinamiento iterativo. Cada 'cada' pasos se calcula en
+// double el residuo r = h2 f - A u y su norma global; luego se hacen 'cada' pasos de Jacobi
+// en float sobre A e = r desde e = 0, con celdas fantasma de float, y se corrige u += e.
+// Equivale a continuar Jacobi sobre u pero mueve y envía la mitad de bytes; el redondeo de
+// float sólo afecta a la corrección, que se recalcula desde el residuo en double.
+// Devuelve el número de pasos realizados y deja en *residuo la última norma medida.
+int jacobi_mixto(int pasos, int n_local, int n_total, double* u_local, double* f_local, int rango, int num_procesos,
+                 double tol, int cada, double* residuo) {
+    double h = 1.0 / n_total;
+    double h2 = h * h;
+    int primero = (rango == 0) ? 2 : 1;
+    float* r = calloc(n_local + 2, sizeof(float));      // Residuo en float
+    float* e = calloc(n_local + 2, sizeof(float));      // Corrección; las fronteras quedan en cero
+    float* e_tmp = calloc(n_local + 2, sizeof(float));
+    int paso = 0;
+
+    if (cada < 1)
+        cada = 1;
+    while (1) {
+        if (paso > 0)
+            for (int i = primero; i <= n_local; ++i)
+                u_local[i] += e[i];
+        *residuo = norma_residuo(n_local, n_total, u_local, f_local, rango, num_procesos);
+        if ((tol > 0 && *residuo < tol) || paso >= pasos)
+            break;
+        for (int i = primero; i <= n_local; ++i)
+            r[i] = (float)(h2 * f_local[i] + u_local[i - 1] + u_local[i + 1] - 2.0 * u_local[i]);
+
+        // Pasos en float sobre A e = r desde e = 0
+        int internos = (pasos - paso < cada) ? pasos - paso : cada;
+        memset(e, 0, (n_local + 2) * sizeof(float));
+        memset(e_tmp, 0, (n_local + 2) * sizeof(float));
+        for (int k = 0; k < internos; ++k) {
+            intercambiar_bordes_float(e, n_local, rango, num_procesos);
+            for (int i = primero; i <= n_local; ++i)
+                e_tmp[i] = (e[i - 1] + e[i + 1] + r[i]) * 0.5f;
+            float* aux = e;
+            e = e_tmp;
+            e_tmp = aux;
+        }
+        paso += internos;
+    }
+
+    free(r);
+    free(e);
+    free(e_tmp);
+    return paso;
+}
+
+// Comparación de tiempo hasta la tolerancia: jacobi en double y jacobi_mixto, ambos desde
+// u = 0, con el residuo final recalculado en double para los dos (imprime el rango 0)
+void comparar_precision(int pasos, int n_local, int n_total, double* f_local, int rango, int num_procesos,
+                        double tol, int cada) {
+    const char* nombres[2] = {"double", "mixta"};
+    double* u = malloc((n_local + 2) * sizeof(double));
+
+    if (rango == 0)
+        printf("%-8s %12s %10s %14s\n", "modo", "tiempo (s)", "pasos", "residuo");
+    for (int modo = 0; modo < 2; ++modo) {
+        double residuo = -1.0;
+        int realizados;
+        memset(u, 0, (n_local + 2) * sizeof(double));
+        MPI_Barrier(MPI_COMM_WORLD);
+        double t = MPI_Wtime();
+        if (modo == 0)
+            realizados = jacobi(pasos, n_local, n_total, u, f_local, rango, num_procesos, tol, cada, 0, &residuo);
+        else
+            realizados = jacobi_mixto(pasos, n_local, n_total, u, f_local, rango, num_procesos, tol, cada, &residuo);
+        t = MPI_Wtime() - t;
+        double final = norma_residuo(n_local, n_total, u, f_local, rango, num_procesos);
+        if (rango == 0)
+            printf("%-8s %12.6f %10d %14e\n", nombres[modo], t, realizados, final);
+    }
+    free(u);
+}
+
+// Jacobi híbrido MPI + OpenMP (compilar con mpicc -fopenmp; sin OpenMP corre con un hilo).
+// Sólo el hilo maestro llama a MPI (MPI_THREAD_FUNNELED): en cada paso publica el intercambio
+// de bordes y espera a que termine mientras los demás hilos actualizan los puntos que no
+// dependen de las celdas fantasma. El interior se reparte en trozos dinámicos, así que el
+// maestro se suma al cálculo en cuanto termina la comunicación. Después de una barrera el
+// maestro actualiza los dos extremos y gestiona la reducción del residuo.
+// Mismo criterio de parada, valores y valor de retorno que jacobi.
+int jacobi_hibrido(int pasos, int n_local, int n_total, double* u_local, double* f_local, int rango,
+                   int num_procesos, int num_hilos, double tol, int cada, double* residuo) {
+    double h = 1.0 / n_total;
+    double h2 = h * h;
+    double* buffer = calloc(n_local + 2, sizeof(double));
+    double* u = u_local;
+    double* tmp = buffer;
+    int primero = (rango == 0) ? 2 : 1;
+    int desde = (primero > 2) ? primero : 2;    // Interior: no lee celdas fantasma
+    int hasta = n_local - 1;
+    int num_bloques = (hasta >= desde) ? (hasta - desde) / HIBRIDO_BLOQUE + 1 : 0;
+    int desde_chequeo = 0;
+    int pendiente = 0;
+    int parar = 0;
+    int realizados = pasos;
+    double suma = 0.0, suma_local = 0.0, suma_global = 0.0;
+    MPI_Request peticion;
+    MPI_Request bordes[4];
+
+    tmp[1] = u[1];
+    tmp[n_local + 1] = u[n_local + 1];
+
+    // La decisión de medir se toma en la parte serial del paso anterior
+    int medir = tol > 0 && ++desde_chequeo >= cada;
+    if (medir)
+        desde_chequeo = 0;
+
+    #pragma omp parallel num_threads(num_hilos)
+    {
+        for (int paso = 0; paso < pasos; ++paso) {
+            #pragma omp master
+            {
+                int num_bordes = iniciar_intercambio(u, n_local, rango, num_procesos, bordes);
+                MPI_Waitall(num_bordes, bordes, MPI_STATUSES_IGNORE);
+            }
+
+            #pragma omp for schedule(dynamic, 1) reduction(+:suma) nowait
+            for (int b = 0; b < num_bloques; ++b) {
+                int fin = desde + (b + 1) * HIBRIDO_BLOQUE - 1;
+                suma += actualizar_puntos(desde + b * HIBRIDO_BLOQUE, (fin < hasta) ? fin : hasta, u, tmp, f_local,
+                                          h2, medir);
+            }
+            #pragma omp barrier
+
+            #pragma omp master
+            {
+                // Extremos, que necesitan las celdas fantasma ya recibidas
+                if (primero == 1)
+                    suma += actualizar_puntos(1, 1, u, tmp, f_local, h2, medir);
+                if (n_local >= 2)
+                    suma += actualizar_puntos(n_local, n_local, u, tmp, f_local, h2, medir);
+                if (medir)
+                    suma_local = suma;
+                suma = 0.0;
+
+                double* aux = u;
+                u = tmp;
+                tmp = aux;
+
+                if (pendiente) {
+                    MPI_Wait(&peticion, MPI_STATUS_IGNORE);
+                    pendiente = 0;
+                    *residuo = (2.0 / h2) * sqrt(h * suma_global);
+                    if (*residuo < tol) {
+                        parar = 1;
+                        realizados = paso + 1;
+                    }
+                }
+                if (medir) {
+                    MPI_Iallreduce(&suma_local, &suma_global, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD, &peticion);
+                    pendiente = 1;
+                }
+
+                medir = 0;
+                if (tol > 0 && !pendiente && ++desde_chequeo >= cada) {
+                    medir = 1;
+                    desde_chequeo = 0;
+                }
+            }
+            #pragma omp barrier
+            if (parar)
+                break;
+        }
+    }
+
+    if (pendiente) {
+        MPI_Wait(&peticion, MPI_STATUS_IGNORE);
+        *residuo = (2.0 / h2) * sqrt(h * suma_global);
+    }
+
+    if (u != u_local)
+        memcpy(u_local + 1, u + 1, n_local * sizeof(double));
+
+    free(buffer);
+    return realizados;
+}
+
+// Elige la profundidad del halo (operación colectiva): mide HALO_PASOS_PRUEBA pasos sobre
+// copias de u_local con cada potencia de dos hasta HALO_MAXIMO y el menor bloque local, y
+// devuelve la de menor tiempo en el proceso más lento
+int elegir_halo(int n_local, int n_total, double* u_local, double* f_local, int rango, int num_procesos) {
+    int limite = n_local;
+    MPI_Allreduce(MPI_IN_PLACE, &limite, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    if (limite > HALO_MAXIMO)
+        limite = HALO_MAXIMO;
+
+    double* copia = malloc((n_local + 2) * sizeof(double));
+    double mejor_tiempo = 0.0, residuo = 0.0;
+    int mejor = 1;
+    for (int k = 1; k <= limite; k *= 2) {
+        memcpy(copia, u_local, (n_local + 2) * sizeof(double));
+        MPI_Barrier(MPI_COMM_WORLD);
+        double t = MPI_Wtime();
+        if (k == 1)
+            jacobi(HALO_PASOS_PRUEBA, n_local, n_total, copia, f_local, rango, num_procesos, 0.0, 1, 0, &residuo);
+        else
+            jacobi_halo_ancho(HALO_PASOS_PRUEBA, n_local, n_total, k, copia, f_local, rango, num_procesos, 0.0, 1,
+                              &residuo);
+        t = MPI_Wtime() - t;
+        MPI_Allreduce(MPI_IN_PLACE, &t, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+        if (k == 1 || t < mejor_tiempo) {
+            mejor_tiempo = t;
+            mejor = k;
+        }
+    }
+    free(copia);
+    return mejor;
+}
+
+// Método SOR con ordenamiento rojo-negro en paralelo. El color de cada punto depende de la
+// paridad de su índice global (inicio + i - 1): primero se actualizan los impares (rojos) y
+// después los pares (negros), con un intercambio de bordes antes de cada color. Trabaja sobre
+// u_local sin arreglo temporal, con el omega óptimo 2 / (1 + sin(pi h)).
+// Un proceso con uno o dos puntos puede no tener ninguno de un color.
+// Mismo criterio de parada (reducción no bloqueante) y valor de retorno que jacobi.
+int sor_rojo_negro(int pasos, int n_local, int n_total, int inicio, double* u_local, double* f_local,
+                   int rango, int num_procesos, double tol, int cada, double* residuo) {
+    double h = 1.0 / n_total;
+    double h2 = h * h;
+    double omega = 2.0 / (1.0 + sin(acos(-1.0) * h));
+    int primero = (rango == 0) ? 2 : 1;
+    int desde_chequeo = 0;
+    int pendiente = 0;
+    double suma_local = 0.0, suma_global = 0.0;
+    MPI_Request peticion;
+    int paso;
+
+    for (paso = 0; paso < pasos; ++paso) {
+        int medir = 0;
+        if (tol > 0 && !pendiente && ++desde_chequeo >= cada) {
+            medir = 1;
+            desde_chequeo = 0;
+        }
+
+        double suma = 0.0;
+        for (int color = 0; color < 2; ++color) {
+            intercambiar_bordes(u_local, n_local, rango, num_procesos);
+
+            // Primer punto local del color y recorrido con índice comprimido
+            int i0 = primero + (inicio + primero + color) % 2;
+            int cuantos = (i0 <= n_local) ? (n_local - i0) / 2 + 1 : 0; // Puede no haber puntos del color
+            if (medir) {
+                for (int j = 0; j < cuantos; ++j) {
+                    int i = i0 + 2 * j;
+                    double d = omega * ((u_local[i - 1] + u_local[i + 1] + h2 * f_local[i]) / 2.0 - u_local[i]);
+                    suma += d * d;
+                    u_local[i] += d;
+                }
+            } else {
+                for (int j = 0; j < cuantos; ++j) {
+                    int i = i0 + 2 * j;
+                    u_local[i] += omega * ((u_local[i - 1] + u_local[i + 1] + h2 * f_local[i]) / 2.0 - u_local[i]);
+                }
+            }
+        }
+
+        if (pendiente) {
+            MPI_Wait(&peticion, MPI_STATUS_IGNORE);
+            pendiente = 0;
+            *residuo = (2.0 / (omega * h2)) * sqrt(h * suma_global);
+            if (*residuo < tol) {
+                ++paso;
+                break;
+            }
+        }
+        if (medir) {
+            suma_local = suma;
+            MPI_Iallreduce(&suma_local, &suma_global, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD, &peticion);
+            pendiente = 1;
+        }
+    }
+
+    if (pendiente) {
+        MPI_Wait(&peticion, MPI_STATUS_IGNORE);
+        *residuo = (2.0 / (omega * h2)) * sqrt(h * suma_global);
+    }
+    return paso;
+}
+
+// Nivel de la jerarquía del multigrid. Usa la misma distribución que u_local: el proceso
+// guarda los puntos globales inicio .. inicio + n_local - 1 en v[1..n_local] con celdas
+// fantasma en v[0] y v[n_local + 1]. Los niveles aglomerados contienen la malla completa
+// (inicio = 0, n_local = n) y sólo existen en el rango 0.
+typedef struct {
+    int n;            // Número de intervalos globales del nivel
+    int n_local;      // Puntos locales
+    int inicio;       // Índice global del primer punto local
+    int aglomerado;   // 1 si el nivel está reunido en el rango 0
+    int activo;       // 1 si este proceso trabaja en el nivel
+    int izq, der;     // Vecinos (MPI_PROC_NULL si no hay)
+    double h2;
+    double* u;        // Solución (nivel 0) o corrección con frontera cero
+    double* f;        // Lado derecho o residuo restringido
+    double* tmp;      // Temporal del suavizador, del residuo y del resolvedor directo
+} NivelMG;
+
+// Jerarquía completa, igual en todos los procesos y reservada una sola vez
+typedef struct {
+    int num_niveles;
+    NivelMG* niveles;
+    int* cuentas;     // Puntos locales de cada rango en el nivel que se aglomera
+    int* desplaz;     // Índice global inicial de cada rango en ese nivel
+} Multigrid;
+
+// Añade un nivel a la jerarquía y reserva sus arreglos si el proceso participa
+static NivelMG* agregar_nivel(Multigrid* mg, int n, int n_local, int inicio, int aglomerado, int activo,
+                              int izq, int der) {
+    NivelMG* nivel;
+    mg->niveles = realloc(mg->niveles, (mg->num_niveles + 1) * sizeof(NivelMG));
+    nivel = &mg->niveles[mg->num_niveles++];
+    nivel->n = n;
+    nivel->n_local = n_local;
+    nivel->inicio = inicio;
+    nivel->aglomerado = aglomerado;
+    nivel->activo = activo;
+    nivel->izq = izq;
+    nivel->der = der;
+    nivel->h2 = 1.0 / ((double)n * n);
+    nivel->u = (activo && mg->num_niveles > 1) ? calloc(n_local + 2, sizeof(double)) : NULL;
+    nivel->f = (activo && mg->num_niveles > 1) ? calloc(n_local + 2, sizeof(double)) : NULL;
+    nivel->tmp = activo ? calloc(n_local + 2, sizeof(double)) : NULL;
+    return nivel;
+}
+
+// Crea la jerarquía (operación colectiva). Los niveles distribuidos se dividen entre dos
+// mientras todos los procesos tengan un bloque par, alineado y con al menos MG_LOCAL_MINIMO
+// puntos por proceso en el nivel grueso. Después la malla se aglomera en el rango 0, que
+// sigue engrosando en serie hasta que n deja de ser par.
+Multigrid* crear_multigrid(int n, int n_local, int inicio, int rango, int num_procesos) {
+    Multigrid* mg = malloc(sizeof(Multigrid));
+    mg->num_niveles = 0;
+    mg->niveles = NULL;
+    mg->cuentas = malloc(num_procesos * sizeof(int));
+    mg->desplaz = malloc(num_procesos * sizeof(int));
+
+    agregar_nivel(mg, n, n_local, inicio, 0, 1,
+                  (rango > 0) ? rango - 1 : MPI_PROC_NULL,
+                  (rango < num_procesos - 1) ? rango + 1 : MPI_PROC_NULL);
+
+    while (1) {
+        NivelMG a = mg->niveles[mg->num_niveles - 1];
+        if (!a.aglomerado && num_procesos > 1) {
+            int puede = a.n_local % 2 == 0 && a.inicio % 2 == 0 && a.n_local / 2 >= MG_LOCAL_MINIMO;
+            MPI_Allreduce(MPI_IN_PLACE, &puede, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+            if (puede) {
+                agregar_nivel(mg, a.n / 2, a.n_local / 2, a.inicio / 2, 0, 1, a.izq, a.der);
+            } else {
+                // Misma malla reunida en el rango 0
+                MPI_Allgather(&a.n_local, 1, MPI_INT, mg->cuentas, 1, MPI_INT, MPI_COMM_WORLD);
+                MPI_Allgather(&a.inicio, 1, MPI_INT, mg->desplaz, 1, MPI_INT, MPI_COMM_WORLD);
+                agregar_nivel(mg, a.n, a.n, 0, 1, rango == 0, MPI_PROC_NULL, MPI_PROC_NULL);
+            }
+        } else if (a.n % 2 == 0 && a.n / 2 >= MG_N_MINIMO) {
+            agregar_nivel(mg, a.n / 2, a.n_local / 2, 0, a.aglomerado, a.activo, a.izq, a.der);
+        } else {
+            break;
+        }
+    }
+    return mg;
+}
+
+// Libera la jerarquía (los arreglos del nivel 0 pertenecen al llamador)
+void liberar_multigrid(Multigrid* mg) {
+    for (int l = 0; l < mg->num_niveles; ++l) {
+        if (l > 0) {
+            free(mg->niveles[l].u);
+            free(mg->niveles[l].f);
+        }
+        free(mg->niveles[l].tmp);
+    }
+    free(mg->niveles);
+    free(mg->cuentas);
+    free(mg->desplaz);
+    free(mg);
+}
+
+// Intercambio de las celdas fantasma de un arreglo del nivel con sus vecinos
+static void intercambiar_nivel(NivelMG* nivel, double* v) {
+    MPI_Sendrecv(&v[1], 1, MPI_DOUBLE, nivel->izq, 1,
+                 &v[nivel->n_local + 1], 1, MPI_DOUBLE, nivel->der, 1,
+                 MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    MPI_Sendrecv(&v[nivel->n_local], 1, MPI_DOUBLE, nivel->der, 2,
+                 &v[0], 1, MPI_DOUBLE, nivel->izq, 2,
+                 MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+}
+
+// Suavizador: barridos del núcleo de jacobi ponderados con MG_PESO, alternando entre u y tmp
+// de dos en dos para que el resultado quede en u
+void suavizar(NivelMG* nivel, int barridos) {
+    int n_local = nivel->n_local;
+    int primero = (nivel->inicio == 0) ? 2 : 1;
+    double h2 = nivel->h2, w = MG_PESO;
+    double* u = nivel->u;
+    double* f = nivel->f;
+    double* tmp = nivel->tmp;
+
+    // Las fronteras globales se mantienen también en el temporal
+    if (nivel->inicio == 0)
+        tmp[1] = u[1];
+    if (nivel->der == MPI_PROC_NULL)
+        tmp[n_local + 1] = u[n_local + 1];
+
+    for (int b = 0; b < barridos; b += 2) {
+        intercambiar_nivel(nivel, u);
+        for (int i = primero; i <= n_local; ++i)
+            tmp[i] = (1.0 - w) * u[i] + w * (u[i - 1] + u[i + 1] + h2 * f[i]) / 2.0;
+
+        intercambiar_nivel(nivel, tmp);
+        for (int i = primero; i <= n_local; ++i)
+            u[i] = (1.0 - w) * tmp[i] + w * (tmp[i - 1] + tmp[i + 1] + h2 * f[i]) / 2.0;
+    }
+}
+
+// Calcula en tmp el residuo r = f - A u y devuelve la suma local de sus cuadrados
+double calcular_residuo(NivelMG* nivel) {
+    int n_local = nivel->n_local;
+    int primero = (nivel->inicio == 0) ? 2 : 1;
+    double suma = 0.0;
+
+    intercambiar_nivel(nivel, nivel->u);
+    nivel->tmp[1] = 0.0;
+    nivel->tmp[n_local + 1] = 0.0;
+    for (int i = primero; i <= n_local; ++i) {
+        double r = nivel->f[i] - (2.0 * nivel->u[i] - nivel->u[i - 1] - nivel->u[i + 1]) / nivel->h2;
+        nivel->tmp[i] = r;
+        suma += r * r;
+    }
+    return suma;
+}
+
+// Restricción por ponderación completa del arreglo fino del nivel al del nivel grueso.
+// El punto grueso local I corresponde al punto fino local 2I - 1.
+void restringir(NivelMG* fino, double* origen, NivelMG* grueso, double* destino) {
+    intercambiar_nivel(fino, origen);
+    for (int I = 1; I <= grueso->n_local; ++I) {
+        if (grueso->inicio + I - 1 == 0)
+            destino[I] = 0.0;
+        else
+            destino[I] = (origen[2 * I - 2] + 2.0 * origen[2 * I - 1] + origen[2 * I]) / 4.0;
+    }
+}
+
+// Prolongación por interpolación lineal del arreglo grueso, sumando sobre el arreglo fino
+void prolongar_sumar(NivelMG* grueso, double* origen, NivelMG* fino, double* destino) {
+    intercambiar_nivel(grueso, origen);
+    for (int i = 1; i <= fino->n_local; ++i) {
+        if (fino->inicio + i - 1 == 0)
+            continue;
+        if (i % 2 == 1)
+            destino[i] += origen[(i + 1) / 2];     // Punto global par: coincide con uno grueso
+        else
+            destino[i] += (origen[i / 2] + origen[i / 2 + 1]) / 2.0;
+    }
+}
+
+// Pasa un arreglo del nivel l al nivel l + 1: restricción, o reunión en el rango 0 si el
+// nivel grueso es el primero aglomerado (operación colectiva en ese caso)
+static void bajar(Multigrid* mg, int l, double* origen, double* destino) {
+    NivelMG* fino = &mg->niveles[l];
+    NivelMG* grueso = &mg->niveles[l + 1];
+    if (grueso->aglomerado && !fino->aglomerado)
+        MPI_Gatherv(&origen[1], fino->n_local, MPI_DOUBLE, grueso->activo ? &destino[1] : NULL,
+                    mg->cuentas, mg->desplaz, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    else if (fino->activo)
+        restringir(fino, origen, grueso, destino);
+}
+
+// Suma al arreglo del nivel l la corrección del nivel l + 1: prolongación, o reparto desde el
+// rango 0 si el nivel grueso es el primero aglomerado
+static void subir_sumar(Multigrid* mg, int l, double* origen, double* destino) {
+    NivelMG* fino = &mg->niveles[l];
+    NivelMG* grueso = &mg->niveles[l + 1];
+    if (grueso->aglomerado && !fino->aglomerado) {
+        MPI_Scatterv(grueso->activo ? &origen[1] : NULL, mg->cuentas, mg->desplaz, MPI_DOUBLE,
+                     &fino->tmp[1], fino->n_local, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+        for (int i = 1; i <= fino->n_local; ++i)
+            destino[i] += fino->tmp[i];
+    } else if (fino->activo) {
+        prolongar_sumar(grueso, origen, fino, destino);
+    }
+}
+
+// Resolución directa del nivel más grueso (siempre en un solo proceso) por el algoritmo de
+// Thomas para la matriz tridiagonal (-1, 2, -1) / h2; los punteros se desplazan para usar
+// índices globales 0..n
+void resolver_grueso(NivelMG* nivel) {
+    int n = nivel->n;
+    double* c = nivel->tmp + 1;
+    double* u = nivel->u + 1;
+    double* f = nivel->f + 1;
+
+    c[1] = -0.5;
+    u[1] = (nivel->h2 * f[1] + u[0]) / 2.0;
+    for (int i = 2; i < n; ++i) {
+        double m = 2.0 + c[i - 1];
+        double d = nivel->h2 * f[i] + ((i == n - 1) ? u[n] : 0.0);
+        c[i] = -1.0 / m;
+        u[i] = (d + u[i - 1]) / m;
+    }
+    for (int i = n - 2; i >= 1; --i)
+        u[i] -= c[i] * u[i + 1];
+}
+
+// Un ciclo V desde el nivel l (todos los procesos recorren la recursión; sólo trabajan en
+// los niveles en los que están activos)
+void ciclo_v(Multigrid* mg, int l) {
+    NivelMG* nivel = &mg->niveles[l];
+    if (l == mg->num_niveles - 1) {
+        if (nivel->activo)
+            resolver_grueso(nivel);
+        return;
+    }
+
+    NivelMG* grueso = &mg->niveles[l + 1];
+    if (nivel->activo) {
+        suavizar(nivel, MG_PRE_SUAVIZADO);
+        calcular_residuo(nivel);
+    }
+    bajar(mg, l, nivel->tmp, grueso->f);
+    if (grueso->activo)
+        memset(grueso->u, 0, (grueso->n_local + 2) * sizeof(double));
+    ciclo_v(mg, l + 1);
+    subir_sumar(mg, l, grueso->u, nivel->u);
+    if (nivel->activo)
+        suavizar(nivel, MG_POST_SUAVIZADO);
+}
+
+// Multigrid completo desde el nivel l >= 1 (frontera cero): resuelve el problema restringido
+// y usa su interpolación como aproximación inicial del ciclo V de este nivel
+void multigrid_completo(Multigrid* mg, int l) {
+    NivelMG* nivel = &mg->niveles[l];
+    if (l == mg->num_niveles - 1) {
+        if (nivel->activo)
+            resolver_grueso(nivel);
+        return;
+    }
+
+    NivelMG* grueso = &mg->niveles[l + 1];
+    bajar(mg, l, nivel->f, grueso->f);
+    multigrid_completo(mg, l + 1);
+    if (nivel->activo)
+        memset(nivel->u, 0, (nivel->n_local + 2) * sizeof(double));
+    subir_sumar(mg, l, grueso->u, nivel->u);
+    ciclo_v(mg, l);
+}
+
+// Resuelve A u = f con ciclos V distribuidos partiendo del u_local recibido. Si completo es 1,
+// la primera corrección se obtiene con multigrid completo sobre el residuo inicial. Se detiene
+// tras num_ciclos ciclos o cuando la norma del residuo es menor que tol. Devuelve el número
+// de ciclos y deja en *residuo la norma final.
+int multigrid(Multigrid* mg, int num_ciclos, double* u_local, double* f_local, int completo, double tol, double* residuo) {
+    NivelMG* fino = &mg->niveles[0];
+    double suma;
+    int ciclo;
+    fino->u = u_local;
+    fino->f = f_local;
+
+    if (completo && mg->num_niveles > 1) {
+        calcular_residuo(fino);
+        bajar(mg, 0, fino->tmp, mg->niveles[1].f);
+        multigrid_completo(mg, 1);
+        subir_sumar(mg, 0, mg->niveles[1].u, u_local);
+    }
+
+    for (ciclo = 0; ciclo < num_ciclos; ++ciclo) {
+        ciclo_v(mg, 0);
+        if (tol > 0 || ciclo == num_ciclos - 1) {
+            suma = calcular_residuo(fino);
+            MPI_Allreduce(MPI_IN_PLACE, &suma, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+            *residuo = sqrt(suma / fino->n);
+            if (tol > 0 && *residuo < tol) {
+                ++ciclo;
+                break;
+            }
+        }
+    }
+
+    fino->u = fino->f = NULL;
+    return ciclo;
+}
+
+// Resuelve de forma exacta el sistema tridiagonal de jacobi para num_rhs lados derechos
+// guardados uno tras otro con la distribución de u_local (desplazamiento n_local + 2).
+// Método particionado: el último punto de cada rango (salvo el del último) es un separador.
+// Cada rango resuelve su interior por Thomas con separadores nulos; después se reúnen con
+// MPI_Allgather los extremos de cada interior, todos los rangos resuelven el sistema
+// tridiagonal de num_procesos - 1 separadores y cada uno corrige su interior con las
+// respuestas lineales a sus dos separadores.
+// Requiere al menos un punto interior por rango.
+void thomas_particionado(int n_local, int n_total, int num_rhs, double* u_local, double* f_local,
+                         int rango, int num_procesos) {
+    int P = num_procesos;
+    int paso = n_local + 2;
+    double h = 1.0 / n_total;
+    double h2 = h * h;
+    int a = (rango == 0) ? 2 : 1;                            // Interior local [a, b]
+    int b = (rango == P - 1) ? n_local : n_local - 1;
+    int m = b - a + 1;
+    int por_rango = 1 + 3 * num_rhs;
+    double* c = malloc((m + 1) * sizeof(double));
+    double* enviado = malloc(por_rango * sizeof(double));
+    double* datos = malloc((size_t)P * por_rango * sizeof(double));
+    double* sep = malloc((P + 1) * sizeof(double));
+    double* sep_c = malloc(P * sizeof(double));
+    double* sep_den = malloc(P * sizeof(double));
+
+    // Factorización de la matriz (-1, 2, -1) del interior y solución con separadores nulos
+    c[0] = 0.0;
+    for (int j = 1; j <= m; ++j)
+        c[j] = -1.0 / (2.0 + c[j - 1]);
+
+    enviado[0] = m;
+    for (int k = 0; k < num_rhs; ++k) {
+        double* uk = u_local + (size_t)k * paso;
+        double* fk = f_local + (size_t)k * paso;
+        double anterior = (rango == 0) ? uk[1] : 0.0;
+        for (int i = a; i <= b; ++i) {
+            uk[i] = (h2 * fk[i] + anterior) * -c[i - a + 1];
+            anterior = uk[i];
+        }
+        double siguiente = (rango == P - 1) ? uk[n_local + 1] : 0.0;
+        for (int i = b; i >= a; --i) {
+            uk[i] -= c[i - a + 1] * siguiente;
+            siguiente = uk[i];
+        }
+        enviado[1 + 3 * k] = uk[a];
+        enviado[2 + 3 * k] = uk[b];
+        enviado[3 + 3 * k] = (rango < P - 1) ? h2 * fk[n_local] : 0.0;
+    }
+    MPI_Allgather(enviado, por_rango, MPI_DOUBLE, datos, por_rango, MPI_DOUBLE, MPI_COMM_WORLD);
+
+    // Sistema de separadores, con mq el interior del rango q:
+    // -s[q-1] / (ml + 1) + (2 - ml / (ml + 1) - mr / (mr + 1)) s[q] - s[q+1] / (mr + 1) = rhs
+    for (int q = 0; q < P - 1; ++q) {
+        double ml = datos[(size_t)q * por_rango] + 1;
+        double mr = datos[(size_t)(q + 1) * por_rango] + 1;
+        double sub = (q == 0) ? 0.0 : -1.0 / ml;
+        sep_den[q] = 2.0 - (ml - 1) / ml - (mr - 1) / mr - ((q == 0) ? 0.0 : sub * sep_c[q - 1]);
+        sep_c[q] = (-1.0 / mr) / sep_den[q];
+    }
+
+    for (int k = 0; k < num_rhs; ++k) {
+        double* uk = u_local + (size_t)k * paso;
+        double anterior = 0.0;
+        for (int q = 0; q < P - 1; ++q) {
+            double ml = datos[(size_t)q * por_rango] + 1;
+            double sub = (q == 0) ? 0.0 : -1.0 / ml;
+            double r = datos[(size_t)q * por_rango + 3 + 3 * k]           // h2 f del separador
+                     + datos[(size_t)q * por_rango + 2 + 3 * k]           // último del interior izquierdo
+                     + datos[(size_t)(q + 1) * por_rango + 1 + 3 * k];    // primero del interior derecho
+            sep[q] = (r - sub * anterior) / sep_den[q];
+            anterior = sep[q];
+        }
+        for (int q = P - 3; q >= 0; --q)
+            sep[q] -= sep_c[q] * sep[q + 1];
+
+        // Corrección del interior con los separadores vecinos
+        double izq = (rango == 0) ? 0.0 : sep[rango - 1];
+        double der = (rango == P - 1) ? 0.0 : sep[rango];
+        double m1 = m + 1;
+        for (int i = a; i <= b; ++i) {
+            int j = i - a + 1;
+            uk[i] += (izq * (m1 - j) + der * j) / m1;
+        }
+        if (rango < P - 1)
+            uk[n_local] = der;
+    }
+
+    free(c);
+    free(enviado);
+    free(datos);
+    free(sep);
+    free(sep_c);
+    free(sep_den);
+}
+
+// Escribe la solución distribuida en fname sin reunirla en un proceso: cada rango escribe sus
+// puntos globales inicio..inicio + n_local - 1 (el último también el punto n_total) con
+// MPI_File_write_at_all en el desplazamiento que les corresponde. En binario el archivo
+// tiene los n_total + 1 valores double de u; en texto, una línea "x u" de ANCHO_LINEA
+// caracteres por punto, de modo que el desplazamiento también se conoce de antemano.
+void escribir_solucion(const char* fname, int texto, int n_local, int n_total, int inicio, double* u_local,
+                       int rango, int num_procesos) {
+    MPI_File fh;
+    int cuantos = (rango == num_procesos - 1) ? n_local + 1 : n_local;
+    double h = 1.0 / n_total;
+
+    if (MPI_File_open(MPI_COMM_WORLD, fname, MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fh) != MPI_SUCCESS) {
+        if (rango == 0)
+            printf("Error al abrir el archivo %s\n", fname);
+        return;
+    }
+    MPI_File_set_size(fh, 0);  // Descarta el contenido de una ejecución anterior
+
+    if (texto) {
+        char* lineas = malloc((size_t)cuantos * ANCHO_LINEA + 1);
+        for (int i = 0; i < cuantos; ++i) {
+            double v = u_local[i + 1];
+            if (fabs(v) < 1e-99)
+                v = 0.0;  // Mantiene el exponente en dos cifras
+            snprintf(lineas + (size_t)i * ANCHO_LINEA, ANCHO_LINEA + 1, "% .10e % .16e\n", (inicio + i) * h, v);
+        }
+        MPI_File_write_at_all(fh, (MPI_Offset)inicio * ANCHO_LINEA, lineas, cuantos * ANCHO_LINEA, MPI_CHAR,
+                              MPI_STATUS_IGNORE);
+        free(lineas);
+    } else {
+        MPI_File_write_at_all(fh, (MPI_Offset)inicio * sizeof(double), &u_local[1], cuantos, MPI_DOUBLE,
+                              MPI_STATUS_IGNORE);
+    }
+
+    MPI_File_close(&fh);
+}
+
+int main(int argc, char** argv) {
+    int n = N_POR_DEFECTO;          // Tamaño total del dominio
+    int pasos = PASOS_POR_DEFECTO;  // Número de barridos del método Jacobi
+    const char* metodo = "jacobi";  // Método de solución: jacobi, chebyshev, mixto, sor, multigrid, fmg o thomas
+    const char* espectro = "analitico"; // Cotas del espectro para chebyshev: analitico o lanczos
+    int num_rhs = 1;                // Número de lados derechos (sólo thomas resuelve más de uno)
+    int solapar = 0;                // Intercambio no bloqueante solapado con el cálculo (jacobi)
+    int halo = 1;                   // Profundidad del halo de jacobi (0 = ajuste automático)
+    int num_hilos = 1;              // Hilos por proceso del modo híbrido de jacobi
+    int texto = 0;                  // Formato del archivo de salida: binario (0) o texto (1)
+    int comparar = 0;               // Comparar jacobi en double con el de precisión mixta
+    char* fname = NULL;             // Archivo de salida (si se proporciona)
+    double tol = 0.0;               // Tolerancia del residuo (0 = sin criterio de parada)
+    int cada = 10;                  // Pasos entre mediciones del residuo
+    double residuo = -1.0;
+    char* args[3] = {NULL, NULL, NULL};
+    int nargs = 0;
+
+    // Opciones (--metodo <jacobi|chebyshev|mixto|sor|multigrid|fmg|thomas>, --espectro <analitico|lanczos>,
+    // --rhs <m>, --tol <valor>, --cada <k>, --solapar, --halo <k>, --hilos <t>, --formato <binario|texto>,
+    // --comparar) y argumentos posicionales
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--metodo") == 0 && i + 1 < argc)
+            metodo = argv[++i];
+        else if (strcmp(argv[i], "--espectro") == 0 && i + 1 < argc)
+            espectro = argv[++i];
+        else if (strcmp(argv[i], "--comparar") == 0)
+            comparar = 1;
+        else if (strcmp(argv[i], "--formato") == 0 && i + 1 < argc)
+            texto = strcmp(argv[++i], "texto") == 0;
+        else if (strcmp(argv[i], "--hilos") == 0 && i + 1 < argc)
+            num_hilos = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--halo") == 0 && i + 1 < argc)
+            halo = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--solapar") == 0)
+            solapar = 1;
+        else if (strcmp(argv[i], "--rhs") == 0 && i + 1 < argc)
+            num_rhs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--tol") == 0 && i + 1 < argc)
+            tol = atof(argv[++i]);
+        else if (strcmp(argv[i], "--cada") == 0 && i + 1 < argc)
+            cada = atoi(argv[++i]);
+        else if (nargs < 3)
+            args[nargs++] = argv[i];
+    }
+    if (nargs > 0) n = atoi(args[0]);
+    if (nargs > 1) pasos = atoi(args[1]);
+    if (nargs > 2) fname = args[2];
+
+    // Con hilos sólo el maestro hace llamadas a MPI
+    int provisto;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provisto);
+    int rango, num_procesos;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rango);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procesos);
+
+    if (num_hilos > 1 && provisto < MPI_THREAD_FUNNELED) {
+        if (rango == 0)
+            printf("Error: la biblioteca MPI no soporta MPI_THREAD_FUNNELED.\n");
+        MPI_Finalize();
+        return 1;
+    }
+
+    // Cada proceso necesita al menos un punto
+    if (n < num_procesos) {
+        if (rango == 0)
+            printf("Error: N debe ser al menos el número de procesos.\n");
+        MPI_Finalize();
+        return 1;
+    }
+
+    // Reparto equilibrado: los primeros n % num_procesos rangos reciben un punto más
+    int resto = n % num_procesos;
+    int n_local = n / num_procesos + (rango < resto);
+    int inicio = rango * (n / num_procesos) + ((rango < resto) ? rango : resto); // índice global del primer punto local
+
+    if (strcmp(metodo, "thomas") == 0 && n / num_procesos < 3) {
+        if (rango == 0)
+            printf("Error: thomas necesita al menos 3 puntos por proceso.\n");
+        MPI_Finalize();
+        return 1;
+    }
+
+    // Sin un nivel grueso el multigrid sería una sola resolución directa en el rango 0
+    if ((strcmp(metodo, "multigrid") == 0 || strcmp(metodo, "fmg") == 0) && (n % 2 != 0 || n / 2 < MG_N_MINIMO)) {
+        if (rango == 0)
+            printf("Error: el multigrid necesita un número de intervalos par y de al menos %d.\n", 2 * MG_N_MINIMO);
+        MPI_Finalize();
+        return 1;
+    }
+
+    if (halo > n / num_procesos) {
+        if (rango == 0)
+            printf("Error: el halo no puede ser mayor que los puntos de cada proceso (%d).\n", n / num_procesos);
+        MPI_Finalize();
+        return 1;
+    }
+
+    // u_local tiene celdas adicionales en los extremos para los valores fantasma
+    // (num_rhs pares de vectores seguidos; los demás métodos usan sólo el primero)
+    double* u_local = calloc((size_t)num_rhs * (n_local + 2), sizeof(double));
+    double* f_local = malloc((size_t)num_rhs * (n_local + 2) * sizeof(double));
+
+    // Inicialización del vector f_local
+    double h = 1.0 / n;
+    for (int k = 0; k < num_rhs; ++k) {
+        for (int i = 1; i <= n_local; ++i) {
+            int i_global = inicio + i - 1;
+            f_local[(size_t)k * (n_local + 2) + i] = (k + 1) * i_global * h;  // Ejemplo simple de función fuente
+        }
+    }
+
+    if (comparar) {
+        comparar_precision(pasos, n_local, n, f_local, rango, num_procesos, tol, cada);
+        free(u_local);
+        free(f_local);
+        MPI_Finalize();
+        return 0;
+    }
+
+    // Para multigrid la jerarquía de mallas se reserva antes de medir el tiempo
+    int es_multigrid = strcmp(metodo, "multigrid") == 0 || strcmp(metodo, "fmg") == 0;
+    Multigrid* mg = es_multigrid ? crear_multigrid(n, n_local, inicio, rango, num_procesos) : NULL;
+
+    // El ajuste automático del halo también se hace fuera de la medición
+    if (strcmp(metodo, "jacobi") == 0 && halo <= 0)
+        halo = elegir_halo(n_local, n, u_local, f_local, rango, num_procesos);
+
+    // Y la estimación de las cotas del espectro de chebyshev
+    double alfa = 0.0, beta = 0.0;
+    if (strcmp(metodo, "chebyshev") == 0) {
+        cotas_espectro(n_local, n, rango, num_procesos, strcmp(espectro, "lanczos") == 0, &alfa, &beta);
+        if (rango == 0)
+            printf("Cotas del espectro de la iteración de Jacobi: [%.12f, %.12f] (%s)\n", alfa, beta, espectro);
+    }
+
+    // Medición del tiempo de ejecución
+    double tiempo_inicio = MPI_Wtime();
+    int realizados = 0;
+    if (strcmp(metodo, "thomas") == 0)
+        thomas_particionado(n_local, n, num_rhs, u_local, f_local, rango, num_procesos);
+    else if (es_multigrid)
+        realizados = multigrid(mg, pasos, u_local, f_local, strcmp(metodo, "fmg") == 0, tol, &residuo);
+    else if (strcmp(metodo, "sor") == 0)
+        realizados = sor_rojo_negro(pasos, n_local, n, inicio, u_local, f_local, rango, num_procesos, tol, cada, &residuo);
+    else if (strcmp(metodo, "chebyshev") == 0)
+        realizados = jacobi_chebyshev(pasos, n_local, n, u_local, f_local, rango, num_procesos, alfa, beta, tol, cada,
+                                      solapar, &residuo);
+    else if (strcmp(metodo, "mixto") == 0)
+        realizados = jacobi_mixto(pasos, n_local, n, u_local, f_local, rango, num_procesos, tol, cada, &residuo);
+    else if (halo > 1)
+        realizados = jacobi_halo_ancho(pasos, n_local, n, halo, u_local, f_local, rango, num_procesos, tol, cada,
+                                       &residuo);
+    else if (num_hilos > 1)
+        realizados = jacobi_hibrido(pasos, n_local, n, u_local, f_local, rango, num_procesos, num_hilos, tol, cada,
+                                    &residuo);
+    else
+        realizados = jacobi(pasos, n_local, n, u_local, f_local, rango, num_procesos, tol, cada, solapar, &residuo);
+    double tiempo_fin = MPI_Wtime();
+
+    if (rango == 0) {
+        printf("Tiempo de ejecución: %f segundos\n", tiempo_fin - tiempo_inicio);
+        if (strcmp(metodo, "thomas") == 0)
+            printf("Lados derechos resueltos: %d\n", num_rhs);
+        else if (es_multigrid)
+            printf("Niveles: %d, ciclos: %d, residuo final: %e\n", mg->num_niveles, realizados, residuo);
+        else if (tol > 0)
+            printf("Pasos: %d, residuo final: %e\n", realizados, residuo);
+        if (strcmp(metodo, "jacobi") == 0 && halo > 1)
+            printf("Profundidad del halo: %d\n", halo);
+    }
+    if (mg)
+        liberar_multigrid(mg);
+
+    // Si se proporciona un nombre de archivo, guarda la solución (primer lado derecho)
+    if (fname) {
+        double tiempo_escritura = MPI_Wtime();
+        escribir_solucion(fname, texto, n_local, n, inicio, u_local, rango, num_procesos);
+        tiempo_escritura = MPI_Wtime() - tiempo_escritura;
+        if (rango == 0)
+            printf("Tiempo de escritura: %f segundos\n", tiempo_escritura);
+    }
+
+    free(u_local);
+    free(f_local);
+    MPI_Finalize();
+    return 0;
+}
+
@@ -0,0 +1,356 @@
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <mpi.h>
+#include "../reto 2/sell.hpp"
+
+// Jacobi (ponderado) sobre la matriz de un archivo Matrix Market con las filas repartidas
+// entre los procesos MPI en bloques contiguos (los primeros reciben una fila más si no es
+// exacto). Cada proceso lee el archivo y se queda con sus filas. Las columnas que pertenecen a
+// otros procesos se renumeran como celdas fantasma detrás de las filas propias, igual que
+// v[0] y v[n_local + 1] en JacobiMPI.c, sólo que aquí cada proceso puede necesitar valores de
+// cualquier otro: el intercambio se arma una vez con listas de envío y recepción por vecino y
+// en cada barrido se solapa con los trozos que no tocan fantasmas.
+// Como en dispersoOpenMp.cpp, b = A * 1 y el error se mide contra el vector de unos.
+// Compilación: mpicxx -O3 -march=native -fopenmp dispersoMPI.cpp -o dispersoMPI
+
+// Intercambio de las celdas fantasma
+struct Halo {
+    int num_recibir, num_enviar;
+    int* de;               // Rango de cada proceso del que se reciben fantasmas
+    int* recibir_desde;    // Primer fantasma de cada uno (num_recibir + 1, desde n_local)
+    int* para;             // Rango de cada proceso al que se envían valores
+    int* enviar_desde;     // Primer índice de cada uno en enviar (num_enviar + 1)
+    int* enviar;           // Filas locales que se envían, agrupadas por destino
+    double* paquete;       // Valores empaquetados para enviar
+    int fantasmas;
+};
+
+// Primera fila del proceso p
+static int primera_fila(int filas, int num_procesos, int p) {
+    int base = filas / num_procesos, resto = filas % num_procesos;
+    return p * base + (p < resto ? p : resto);
+}
+
+static int comparar_enteros(const void* x, const void* y) {
+    int a = *(const int*)x, b = *(const int*)y;
+    return (a > b) - (a < b);
+}
+
+// Renumera las columnas de m (filas propias 0..n_local-1, fantasmas desde n_local) y arma las
+// listas del intercambio
+static Halo crear_halo(Csr* m, int n, int num_procesos) {
+    Halo h;
+    int fila0 = m->fila0, fila1 = m->fila0 + m->filas;
+    long nnz = m->inicio[m->filas];
+
+    // Columnas externas distintas, en orden: quedan agrupadas por dueño
+    int* externas = (int*)malloc((nnz > 0 ? nnz : 1) * sizeof(int));
+    int num_externas = 0;
+    for (long p = 0; p < nnz; ++p)
+        if (m->col[p] < fila0 || m->col[p] >= fila1)
+            externas[num_externas++] = m->col[p];
+    qsort(externas, num_externas, sizeof(int), comparar_enteros);
+    int distintas = 0;
+    for (int e = 0; e < num_externas; ++e)
+        if (distintas == 0 || externas[e] != externas[distintas - 1])
+            externas[distintas++] = externas[e];
+    h.fantasmas = distintas;
+
+    for (long p = 0; p < nnz; ++p) {
+        int c = m->col[p];
+        if (c >= fila0 && c < fila1) {
+            m->col[p] = c - fila0;
+        } else {
+            int* pos = (int*)bsearch(&c, externas, distintas, sizeof(int), comparar_enteros);
+            m->col[p] = m->filas + (int)(pos - externas);
+        }
+    }
+
+    // Cuántos valores se piden a cada proceso y cuántos pide cada uno a este
+    int* pido = (int*)calloc(num_procesos, sizeof(int));
+    int* me_piden = (int*)calloc(num_procesos, sizeof(int));
+    int dueno = 0;
+    for (int e = 0; e < distintas; ++e) {
+        while (externas[e] >= primera_fila(n, num_procesos, dueno + 1))
+            dueno++;
+        pido[dueno]++;
+    }
+    MPI_Alltoall(pido, 1, MPI_INT, me_piden, 1, MPI_INT, MPI_COMM_WORLD);
+
+    int* desp_pido = (int*)calloc(num_procesos + 1, sizeof(int));
+    int* desp_me_piden = (int*)calloc(num_procesos + 1, sizeof(int));
+    for (int p = 0; p < num_procesos; ++p) {
+        desp_pido[p + 1] = desp_pido[p] + pido[p];
+        desp_me_piden[p + 1] = desp_me_piden[p] + me_piden[p];
+    }
+    int total_enviar = desp_me_piden[num_procesos];
+    h.enviar = (int*)malloc((total_enviar > 0 ? total_enviar : 1) * sizeof(int));
+    MPI_Alltoallv(externas, pido, desp_pido, MPI_INT, h.enviar, me_piden, desp_me_piden, MPI_INT, MPI_COMM_WORLD);
+    for (int e = 0; e < total_enviar; ++e)
+        h.enviar[e] -= fila0;  // Índices globales pedidos -> filas locales
+    h.paquete = (double*)malloc((total_enviar > 0 ? total_enviar : 1) * sizeof(double));
+
+    // Listas compactas de vecinos
+    h.num_recibir = h.num_enviar = 0;
+    h.de = (int*)malloc(num_procesos * sizeof(int));
+    h.para = (int*)malloc(num_procesos * sizeof(int));
+    h.recibir_desde = (int*)malloc((num_procesos + 1) * sizeof(int));
+    h.enviar_desde = (int*)malloc((num_procesos + 1) * sizeof(int));
+    for (int p = 0; p < num_procesos; ++p) {
+        if (pido[p] > 0) {
+            h.de[h.num_recibir] = p;
+            h.recibir_desde[h.num_recibir++] = desp_pido[p];
+        }
+        if (me_piden[p] > 0) {
+            h.para[h.num_enviar] = p;
+            h.enviar_desde[h.num_enviar++] = desp_me_piden[p];
+        }
+    }
+    h.recibir_desde[h.num_recibir] = distintas;
+    h.enviar_desde[h.num_enviar] = total_enviar;
+
+    free(externas);
+    free(pido);
+    free(me_piden);
+    free(desp_pido);
+    free(desp_me_piden);
+    return h;
+}
+
+static void liberar_halo(Halo* h) {
+    free(h->de);
+    free(h->para);
+    free(h->recibir_desde);
+    free(h->enviar_desde);
+    free(h->enviar);
+    free(h->paquete);
+}
+
+// Publica la recepción de los fantasmas de x y el envío de los valores que piden los demás;
+// devuelve cuántas peticiones quedaron en peticiones
+static int iniciar_intercambio(Halo* h, double* x, int n_local, MPI_Request* peticiones) {
+    int num = 0;
+    for (int v = 0; v < h->num_recibir; ++v)
+        MPI_Irecv(x + n_local + h->recibir_desde[v], h->recibir_desde[v + 1] - h->recibir_desde[v], MPI_DOUBLE,
+                  h->de[v], 0, MPI_COMM_WORLD, &peticiones[num++]);
+    for (int e = 0; e < h->enviar_desde[h->num_enviar]; ++e)
+        h->paquete[e] = x[h->enviar[e]];
+    for (int v = 0; v < h->num_enviar; ++v)
+        MPI_Isend(h->paquete + h->enviar_desde[v], h->enviar_desde[v + 1] - h->enviar_desde[v], MPI_DOUBLE, h->para[v],
+                  0, MPI_COMM_WORLD, &peticiones[num++]);
+    return num;
+}
+
+// Barrido de los trozos de la lista, repartidos entre los hilos si hay OpenMP
+template <bool MEDIR>
+static double barrido_lista(const Sell* a, const int* trozos, int num, const double* inv_diagonal, const double* b,
+                            const double* ent, double* sal, double omega) {
+    double suma = 0.0;
+    #pragma omp parallel for schedule(static) reduction(+:suma)
+    for (int k = 0; k < num; ++k)
+        suma += barrido_trozo<MEDIR>(a, trozos[k], inv_diagonal, b, ent, sal, omega);
+    return suma;
+}
+
+// Jacobi distribuido con la misma estructura y criterio de parada que jacobi_sell: los trozos
+// interiores se calculan mientras viajan los fantasmas y los de frontera después
+static int jacobi_sell_mpi(int num_barridos, const Sell* a, Halo* h, const double* inv_diagonal, double* x,
+                           const double* b, double omega, double tol, int cada, double* residuo) {
+    int n_local = a->filas;
+    double* tmp = (double*)reservar_alineado((n_local + h->fantasmas) * sizeof(double));
+    double* ent = x;
+    double* sal = tmp;
+    MPI_Request* peticiones = (MPI_Request*)malloc((h->num_recibir + h->num_enviar + 1) * sizeof(MPI_Request));
+    int* interiores = (int*)malloc((a->num_trozos > 0 ? a->num_trozos : 1) * sizeof(int));
+    int* frontera = (int*)malloc((a->num_trozos > 0 ? a->num_trozos : 1) * sizeof(int));
+    int num_interiores = 0, num_frontera = 0;
+    double norma_b = 0.0;
+    int barrido_actual, desde_chequeo = 0;
+
+    // Un trozo es de frontera si alguna de sus columnas es un fantasma
+    for (int t = 0; t < a->num_trozos; ++t) {
+        int toca = 0;
+        for (long p = a->inicio[t]; p < a->inicio[t + 1] && !toca; ++p)
+            toca = a->col[p] >= n_local;
+        if (toca)
+            frontera[num_frontera++] = t;
+        else
+            interiores[num_interiores++] = t;
+    }
+
+    for (int i = 0; i < n_local; ++i)
+        norma_b += b[i] * b[i];
+    MPI_Allreduce(MPI_IN_PLACE, &norma_b, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    norma_b = (norma_b > 0) ? sqrt(norma_b) : 1.0;
+
+    for (barrido_actual = 0; barrido_actual < num_barridos; ++barrido_actual) {
+        int medir = 0;
+        if (tol > 0 && ++desde_chequeo >= cada) {
+            medir = 1;
+            desde_chequeo = 0;
+        }
+
+        int num = iniciar_intercambio(h, ent, n_local, peticiones);
+        double suma;
+        if (medir) {
+            suma = barrido_lista<true>(a, interiores, num_interiores, inv_diagonal, b, ent, sal, omega);
+            MPI_Waitall(num, peticiones, MPI_STATUSES_IGNORE);
+            suma += barrido_lista<true>(a, frontera, num_frontera, inv_diagonal, b, ent, sal, omega);
+            MPI_Allreduce(MPI_IN_PLACE, &suma, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+            *residuo = sqrt(suma) / norma_b;
+        } else {
+            barrido_lista<false>(a, interiores, num_interiores, inv_diagonal, b, ent, sal, omega);
+            MPI_Waitall(num, peticiones, MPI_STATUSES_IGNORE);
+            barrido_lista<false>(a, frontera, num_frontera, inv_diagonal, b, ent, sal, omega);
+        }
+        double* t = ent;
+        ent = sal;
+        sal = t;
+        if (medir && *residuo < tol) {
+            ++barrido_actual;
+            break;
+        }
+    }
+
+    if (ent != x)
+        memcpy(x, ent, n_local * sizeof(double));
+    free(tmp);
+    free(peticiones);
+    free(interiores);
+    free(frontera);
+    return barrido_actual;
+}
+
+int main(int argc, char** argv) {
+    int num_iteraciones = 1000;
+    double omega = 1.0;                // Peso de Jacobi (1 = Jacobi sin ponderar)
+    int sigma = SELL_SIGMA_DEFECTO;    // Ventana de ordenamiento de SELL-C-sigma
+    double tol = 0.0;                  // Tolerancia del residuo relativo (0 = sin criterio de parada)
+    int cada = 10;                     // Iteraciones entre mediciones del residuo
+    double residuo = -1.0;
+    char* args[2] = {NULL, NULL};
+    int nargs = 0;
+    int rango, num_procesos;
+    Coo coo;
+    Csr csr;
+
+    // Opciones (--omega <w>, --sigma <s>, --tol <valor>, --cada <k>) y argumentos posicionales
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--omega") == 0 && i + 1 < argc)
+            omega = atof(argv[++i]);
+        else if (strcmp(argv[i], "--sigma") == 0 && i + 1 < argc)
+            sigma = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--tol") == 0 && i + 1 < argc)
+            tol = atof(argv[++i]);
+        else if (strcmp(argv[i], "--cada") == 0 && i + 1 < argc)
+            cada = atoi(argv[++i]);
+        else if (nargs < 2)
+            args[nargs++] = argv[i];
+    }
+    if (nargs > 1)
+        num_iteraciones = atoi(args[1]);
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rango);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procesos);
+
+    // Cada proceso lee la matriz por su cuenta; todos deciden juntos si siguen, porque uno que
+    // saliera solo dejaría a los demás esperando en las operaciones colectivas
+    int leida = nargs >= 1 && leer_matrix_market(args[0], &coo) == 0;
+    int valido = leida;
+    MPI_Allreduce(MPI_IN_PLACE, &valido, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+    if (valido && coo.filas != coo.columnas) {
+        if (rango == 0)
+            printf("Error: la matriz debe ser cuadrada (%d x %d).\n", coo.filas, coo.columnas);
+        valido = 0;
+    }
+    if (!valido) {
+        if (leida)
+            liberar_coo(&coo);
+        if (rango == 0 && nargs < 1)
+            printf("Uso: %s <matriz.mtx> [iteraciones] [--omega w] [--sigma s] [--tol t] [--cada k]\n", argv[0]);
+        MPI_Finalize();
+        return 1;
+    }
+
+    int n = coo.filas;
+    int fila0 = primera_fila(n, num_procesos, rango);
+    int fila1 = primera_fila(n, num_procesos, rango + 1);
+    int propia = csr_de_coo(&coo, fila0, fila1, &csr) == 0;
+    int correcta = propia;
+    liberar_coo(&coo);
+    MPI_Allreduce(MPI_IN_PLACE, &correcta, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+    if (!correcta) {
+        if (propia)
+            liberar_csr(&csr);
+        MPI_Finalize();
+        return 1;
+    }
+
+    // b = A * 1 con las columnas todavía globales
+    int n_local = csr.filas;
+    double* b = (double*)reservar_alineado(n_local * sizeof(double));
+    double* inv_diagonal = (double*)reservar_alineado(n_local * sizeof(double));
+    for (int i = 0; i < n_local; ++i) {
+        double suma = csr.diagonal[i];
+        for (long p = csr.inicio[i]; p < csr.inicio[i + 1]; ++p)
+            suma += csr.val[p];
+        b[i] = suma;
+        inv_diagonal[i] = 1.0 / csr.diagonal[i];
+    }
+
+    Halo halo = crear_halo(&csr, n, num_procesos);
+    Sell a = sell_de_csr(&csr, sigma);
+    liberar_csr(&csr);
+    double* x = (double*)reservar_alineado((n_local + halo.fantasmas) * sizeof(double));
+    memset(x, 0, (n_local + halo.fantasmas) * sizeof(double));
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double tiempo_inicio = MPI_Wtime();
+    int realizadas = jacobi_sell_mpi(num_iteraciones, &a, &halo, inv_diagonal, x, b, omega, tol, cada, &residuo);
+    double tiempo = MPI_Wtime() - tiempo_inicio;
+
+    double error = 0.0;
+    for (int i = 0; i < n_local; ++i)
+        if (fabs(x[i] - 1.0) > error)
+            error = fabs(x[i] - 1.0);
+
+    // Totales: operaciones, bytes y relleno de todos los procesos, tiempo del más lento y la
+    // tríada medida a la vez en todos (el ancho de banda agregado de los nodos)
+    long elementos = (long)(bytes_barrido(&a) / sizeof(double));
+    if (elementos < (1L << 22))
+        elementos = 1L << 22;
+    MPI_Barrier(MPI_COMM_WORLD);
+    double triada = medir_triada(elementos, MPI_Wtime);
+    double locales[6] = {operaciones_barrido(&a), bytes_barrido(&a), (double)a.nnz, (double)a.almacenados,
+                         (double)halo.fantasmas, triada};
+    double totales[6];
+    MPI_Reduce(locales, totales, 6, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(rango == 0 ? MPI_IN_PLACE : &tiempo, &tiempo, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(rango == 0 ? MPI_IN_PLACE : &error, &error, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    if (rango == 0) {
+        double ancho = totales[1] * realizadas / tiempo;
+        printf("Matriz: %d filas, %.0f no nulos fuera de la diagonal, SELL-%d-%d con %.1f %% de relleno\n", n,
+               totales[2], SELL_C, a.sigma, totales[3] > 0 ? 100.0 * (totales[3] - totales[2]) / totales[3] : 0.0);
+        printf("Procesos: %d, fantasmas intercambiados por barrido: %.0f\n", num_procesos, totales[4]);
+        printf("\nTiempo de ejecución: %f segundos\n", tiempo);
+        printf("Rendimiento: %.3f GFLOP/s, %.2f GB/s (%.0f %% de la tríada, %.2f GB/s)\n",
+               totales[0] * realizadas / tiempo / 1e9, ancho / 1e9, totales[5] > 0 ? 100.0 * ancho / totales[5] : 0.0,
+               totales[5] / 1e9);
+        if (tol > 0)
+            printf("Iteraciones: %d, residuo relativo final: %e\n", realizadas, residuo);
+        printf("Error máximo: %e\n", error);
+    }
+
+    liberar_sell(&a);
+    liberar_halo(&halo);
+    free(inv_diagonal);
+    free(b);
+    free(x);
+    MPI_Finalize();
+    return 0;
+}
@@ -0,0 +1,249 @@
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <mpi.h>
+#include "../reto 2/stencil.hpp"
+
+// Jacobi 2D/3D con el motor de stencils y descomposición cartesiana del dominio.
+// Los puntos interiores 1..n-1 de cada dimensión se reparten entre los procesos de la malla
+// creada con MPI_Cart_create (los primeros reciben un punto más si no es exacto). Cada
+// proceso guarda su bloque en una Malla local cuyos puntos extremos son las celdas
+// fantasma o la frontera física.
+
+// Tipos de MPI para las caras de la malla local
+template <int DIM>
+struct Caras {
+    MPI_Datatype cara[3];   // Capa de puntos con índice fijo en la dimensión d
+};
+
+// Cada cara abarca la capa completa de las demás dimensiones, celdas fantasma incluidas, para
+// que al intercambiar las dimensiones en orden se completen también aristas y esquinas
+template <int DIM>
+Caras<DIM> crear_caras(const Malla<DIM>& m) {
+    Caras<DIM> c;
+    // Orden de C: la última dimensión de MPI es la de paso 1
+    int tamanos[3], sub[3], inicio[3] = {0, 0, 0};
+    for (int d = 0; d < DIM; ++d) {
+        int e = DIM - 1 - d;
+        tamanos[e] = (d == 0) ? (int)m.paso[1] : m.n[d] + 1;
+    }
+    for (int d = 0; d < DIM; ++d) {
+        for (int e = 0; e < DIM; ++e)
+            sub[DIM - 1 - e] = (e == d) ? 1 : m.n[e] + 1;
+        MPI_Type_create_subarray(DIM, tamanos, sub, inicio, MPI_ORDER_C, MPI_DOUBLE, &c.cara[d]);
+        MPI_Type_commit(&c.cara[d]);
+    }
+    return c;
+}
+
+template <int DIM>
+void liberar_caras(Caras<DIM>& c) {
+    for (int d = 0; d < DIM; ++d)
+        MPI_Type_free(&c.cara[d]);
+}
+
+// Intercambio de las celdas fantasma con los vecinos de cada dimensión
+template <int DIM>
+void intercambiar_caras(const Malla<DIM>& m, const Caras<DIM>& c, double* v, const int (*vecinos)[2], MPI_Comm cart) {
+    for (int d = 0; d < DIM; ++d) {
+        long ultimo = (long)(m.n[d] - 1) * m.paso[d];
+        long fantasma = (long)m.n[d] * m.paso[d];
+        double* base = v + m.desfase;
+        // Hacia el vecino superior y desde el inferior
+        MPI_Sendrecv(base + ultimo, 1, c.cara[d], vecinos[d][1], 0,
+                     base, 1, c.cara[d], vecinos[d][0], 0, cart, MPI_STATUS_IGNORE);
+        // Hacia el vecino inferior y desde el superior
+        MPI_Sendrecv(base + m.paso[d], 1, c.cara[d], vecinos[d][0], 1,
+                     base + fantasma, 1, c.cara[d], vecinos[d][1], 1, cart, MPI_STATUS_IGNORE);
+    }
+}
+
+// Jacobi distribuido: intercambio de caras y barrido local en cada iteración. Si tol > 0,
+// cada 'cada' iteraciones se reduce la norma del residuo entre todos los procesos.
+template <class Patron>
+int jacobi_cart(int num_iteraciones, int n, const Malla<Patron::DIM>& m, double* u, const double* f,
+                const int (*vecinos)[2], MPI_Comm cart, double tol, int cada, double* residuo) {
+    const int DIM = Patron::DIM;
+    double h = 1.0 / n;
+    double h2 = h * h;
+    Caras<DIM> caras = crear_caras(m);
+    double* tmp = crear_campo(m);
+    memcpy(tmp, u, m.total * sizeof(double));
+    double* ent = u;
+    double* sal = tmp;
+    int iteracion, desde_chequeo = 0;
+
+    for (iteracion = 0; iteracion < num_iteraciones; ++iteracion) {
+        int medir = 0;
+        if (tol > 0 && ++desde_chequeo >= cada) {
+            medir = 1;
+            desde_chequeo = 0;
+        }
+
+        intercambiar_caras(m, caras, ent, vecinos, cart);
+        if (medir) {
+            double suma = barrido<Patron, true>(m, ent, sal, f, h2);
+            MPI_Allreduce(MPI_IN_PLACE, &suma, 1, MPI_DOUBLE, MPI_SUM, cart);
+            *residuo = norma_residuo<Patron>(suma, h);
+        } else {
+            barrido<Patron, false>(m, ent, sal, f, h2);
+        }
+        double* t = ent;
+        ent = sal;
+        sal = t;
+        if (medir && *residuo < tol) {
+            ++iteracion;
+            break;
+        }
+    }
+
+    if (ent != u)
+        memcpy(u, ent, m.total * sizeof(double));
+    free(tmp);
+    liberar_caras(caras);
+    return iteracion;
+}
+
+template <class Patron>
+int resolver(int n, int num_iteraciones, double tol, int cada) {
+    const int DIM = Patron::DIM;
+    int rango, num_procesos;
+    int dims[3] = {0, 0, 0}, periodos[3] = {0, 0, 0}, coords[3] = {0, 0, 0};
+    int local[3] = {1, 1, 1}, primero[3] = {0, 0, 0};
+    int vecinos[3][2];
+    MPI_Comm cart;
+
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procesos);
+    MPI_Dims_create(num_procesos, DIM, dims);
+    MPI_Cart_create(MPI_COMM_WORLD, DIM, dims, periodos, 1, &cart);
+    MPI_Comm_rank(cart, &rango);
+    MPI_Cart_coords(cart, rango, DIM, coords);
+
+    // Reparto de los puntos interiores de cada dimensión
+    for (int d = 0; d < DIM; ++d) {
+        int interiores = n - 1;
+        int base = interiores / dims[d], resto = interiores % dims[d];
+        local[d] = base + (coords[d] < resto);
+        primero[d] = 1 + coords[d] * base + (coords[d] < resto ? coords[d] : resto);
+        MPI_Cart_shift(cart, d, 1, &vecinos[d][0], &vecinos[d][1]);
+        if (local[d] < 1) {
+            if (rango == 0)
+                printf("Error: hay más procesos que puntos en la dimensión %d.\n", d);
+            MPI_Comm_free(&cart);
+            return 1;
+        }
+    }
+
+    // La Malla local tiene local[d] + 1 intervalos: el punto 0 y el último son fantasma
+    Malla<DIM> m = crear_malla<DIM>(local[0] + 1, local[1] + 1, local[2] + 1);
+    double* u = crear_campo(m);
+    double* f = crear_campo(m);
+    double h = 1.0 / n;
+    double residuo = -1.0;
+    int kmax = (DIM == 3) ? local[2] + 1 : 0;
+
+    // Misma fuente que stencilOpenMp.cpp: solución exacta producto de x (1 - x)
+    for (int k = 0; k <= kmax; ++k) {
+        for (int j = 0; j <= local[1] + 1; ++j) {
+            for (int i = 0; i <= local[0] + 1; ++i) {
+                int g[3] = {primero[0] + i - 1, primero[1] + j - 1, primero[2] + k - 1};
+                double q[3];
+                for (int d = 0; d < 3; ++d)
+                    q[d] = g[d] * h * (1 - g[d] * h);
+                double suma = 0.0;
+                for (int d = 0; d < DIM; ++d) {
+                    double producto = 2.0;
+                    for (int e = 0; e < DIM; ++e)
+                        if (e != d)
+                            producto *= q[e];
+                    suma += producto;
+                }
+                f[m.indice(i, j, k)] = suma;
+            }
+        }
+    }
+
+    MPI_Barrier(cart);
+    double tiempo_inicio = MPI_Wtime();
+    int realizadas = jacobi_cart<Patron>(num_iteraciones, n, m, u, f, vecinos, cart, tol, cada, &residuo);
+    double tiempo_fin = MPI_Wtime();
+
+    // Error máximo respecto a la solución del problema continuo
+    double error = 0.0;
+    for (int k = (DIM == 3) ? 1 : 0; k <= ((DIM == 3) ? local[2] : 0); ++k) {
+        for (int j = 1; j <= local[1]; ++j) {
+            for (int i = 1; i <= local[0]; ++i) {
+                int g[3] = {primero[0] + i - 1, primero[1] + j - 1, primero[2] + k - 1};
+                double exacta = 1.0;
+                for (int d = 0; d < DIM; ++d)
+                    exacta *= g[d] * h * (1 - g[d] * h);
+                double e = fabs(u[m.indice(i, j, k)] - exacta);
+                if (e > error)
+                    error = e;
+            }
+        }
+    }
+    MPI_Reduce(rango == 0 ? MPI_IN_PLACE : &error, &error, 1, MPI_DOUBLE, MPI_MAX, 0, cart);
+
+    if (rango == 0) {
+        printf("Procesos por dimensión:");
+        for (int d = 0; d < DIM; ++d)
+            printf(" %d", dims[d]);
+        printf("\nTiempo de ejecución: %f segundos\n", tiempo_fin - tiempo_inicio);
+        if (tol > 0)
+            printf("Iteraciones: %d, residuo final: %e\n", realizadas, residuo);
+        printf("Error máximo: %e\n", error);
+    }
+
+    free(f);
+    free(u);
+    MPI_Comm_free(&cart);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    int n = 256;               // Intervalos por dimensión
+    int num_iteraciones = 1000;
+    int puntos = 5;            // Patrón del stencil: 5 (2D), 7 o 27 (3D)
+    double tol = 0.0;          // Tolerancia del residuo (0 = sin criterio de parada)
+    int cada = 10;             // Iteraciones entre mediciones del residuo
+    char* args[2] = {NULL, NULL};
+    int nargs = 0;
+    int resultado = 1;
+
+    // Opciones (--stencil <5|7|27>, --tol <valor>, --cada <k>) y argumentos posicionales
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--stencil") == 0 && i + 1 < argc)
+            puntos = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--tol") == 0 && i + 1 < argc)
+            tol = atof(argv[++i]);
+        else if (strcmp(argv[i], "--cada") == 0 && i + 1 < argc)
+            cada = atoi(argv[++i]);
+        else if (nargs < 2)
+            args[nargs++] = argv[i];
+    }
+    if (nargs > 0)
+        n = atoi(args[0]);
+    if (nargs > 1)
+        num_iteraciones = atoi(args[1]);
+
+    MPI_Init(&argc, &argv);
+
+    if (puntos == 5)
+        resultado = resolver<Laplaciano5>(n, num_iteraciones, tol, cada);
+    else if (puntos == 7)
+        resultado = resolver<Laplaciano7>(n, num_iteraciones, tol, cada);
+    else if (puntos == 27)
+        resultado = resolver<Laplaciano27>(n, num_iteraciones, tol, cada);
+    else {
+        int rango;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rango);
+        if (rango == 0)
+            printf("Error: stencil de %d puntos no soportado (5, 7 o 27).\n", puntos);
+    }
+
+    MPI_Finalize();
+    return resultado;
+}